@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sys/param.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_barrier.h>
+#include <ck_pr.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define BARRIER_METATABLE "barrier"
+#define BARRIER_STATE_METATABLE "barrier.state"
+
+#ifndef BARRIER_COMBINING_GROUP_SIZE
+#define BARRIER_COMBINING_GROUP_SIZE 4
+#endif
+
+enum barrier_type {
+	BARRIER_CENTRALIZED,
+	BARRIER_COMBINING,
+	BARRIER_DISSEMINATION,
+	BARRIER_TOURNAMENT,
+	BARRIER_MCS,
+};
+
+struct rcbarrier {
+	enum barrier_type type;
+	unsigned int nthr;
+	unsigned int subscribed;
+	union {
+		ck_barrier_centralized_t centralized;
+		struct {
+			ck_barrier_combining_t barrier;
+			/* groups[0] is the root, threads are in the rest */
+			ck_barrier_combining_group_t *groups;
+			unsigned int groupsize;
+		} combining;
+		struct {
+			ck_barrier_dissemination_t *barrier;
+			ck_barrier_dissemination_flag_t **flags;
+		} dissemination;
+		struct {
+			ck_barrier_tournament_t barrier;
+			ck_barrier_tournament_round_t **rounds;
+		} tournament;
+		ck_barrier_mcs_t *mcs;
+	};
+	refcount refs CK_CC_CACHELINE;
+};
+
+/*
+ * Each thread waiting on a barrier subscribes once to get its own state, which
+ * is carried by the state object along with a reference to the barrier.
+ */
+union barrier_state {
+	ck_barrier_centralized_state_t centralized;
+	struct {
+		ck_barrier_combining_group_t *group;
+		ck_barrier_combining_state_t state;
+	} combining;
+	ck_barrier_dissemination_state_t dissemination;
+	ck_barrier_tournament_state_t tournament;
+	ck_barrier_mcs_state_t mcs;
+};
+
+static void
+freerows(void **rows, unsigned int nrows)
+{
+	unsigned int i;
+
+	for (i = 0; i < nrows; i++) {
+		free(rows[i]);
+	}
+	free(rows);
+}
+
+static void **
+newrows(unsigned int nrows, size_t rowsize)
+{
+	void **rows;
+	unsigned int i;
+
+	if ((rows = calloc(nrows, sizeof(*rows))) == NULL) {
+		return (NULL);
+	}
+	for (i = 0; i < nrows; i++) {
+		/* A single thread needs no flags, but malloc(0) may fail. */
+		if ((rows[i] = calloc(1, MAX(rowsize, 1))) == NULL) {
+			freerows(rows, i);
+			return (NULL);
+		}
+	}
+	return (rows);
+}
+
+static int
+initbarrier(struct rcbarrier *barrierp)
+{
+	unsigned int i, ngroups, nthr, size;
+
+	nthr = barrierp->nthr;
+	switch (barrierp->type) {
+	case BARRIER_CENTRALIZED:
+		barrierp->centralized = (ck_barrier_centralized_t)
+		    CK_BARRIER_CENTRALIZED_INITIALIZER;
+		return (0);
+	case BARRIER_COMBINING:
+		ngroups = howmany(nthr, barrierp->combining.groupsize);
+		if ((barrierp->combining.groups = calloc(ngroups + 1,
+		    sizeof(*barrierp->combining.groups))) == NULL) {
+			return (ENOMEM);
+		}
+		ck_barrier_combining_init(&barrierp->combining.barrier,
+		    &barrierp->combining.groups[0]);
+		for (i = 1; i <= ngroups; i++) {
+			ck_barrier_combining_group_init(
+			    &barrierp->combining.barrier,
+			    &barrierp->combining.groups[i],
+			    MIN(nthr, barrierp->combining.groupsize));
+			nthr -= barrierp->combining.groupsize;
+		}
+		return (0);
+	case BARRIER_DISSEMINATION:
+		size = ck_barrier_dissemination_size(nthr);
+		if ((barrierp->dissemination.barrier = calloc(nthr,
+		    sizeof(*barrierp->dissemination.barrier))) == NULL) {
+			return (ENOMEM);
+		}
+		if ((barrierp->dissemination.flags =
+		    (ck_barrier_dissemination_flag_t **)newrows(nthr,
+		    sizeof(ck_barrier_dissemination_flag_t) * size)) == NULL) {
+			free(barrierp->dissemination.barrier);
+			return (ENOMEM);
+		}
+		ck_barrier_dissemination_init(barrierp->dissemination.barrier,
+		    barrierp->dissemination.flags, nthr);
+		return (0);
+	case BARRIER_TOURNAMENT:
+		size = ck_barrier_tournament_size(nthr);
+		if ((barrierp->tournament.rounds =
+		    (ck_barrier_tournament_round_t **)newrows(nthr,
+		    sizeof(ck_barrier_tournament_round_t) * size)) == NULL) {
+			return (ENOMEM);
+		}
+		ck_barrier_tournament_init(&barrierp->tournament.barrier,
+		    barrierp->tournament.rounds, nthr);
+		return (0);
+	case BARRIER_MCS:
+		if ((barrierp->mcs = calloc(nthr, sizeof(*barrierp->mcs))) ==
+		    NULL) {
+			return (ENOMEM);
+		}
+		ck_barrier_mcs_init(barrierp->mcs, nthr);
+		return (0);
+	}
+	__unreachable();
+}
+
+static void
+finibarrier(struct rcbarrier *barrierp)
+{
+	switch (barrierp->type) {
+	case BARRIER_CENTRALIZED:
+		break;
+	case BARRIER_COMBINING:
+		free(barrierp->combining.groups);
+		break;
+	case BARRIER_DISSEMINATION:
+		freerows((void **)barrierp->dissemination.flags,
+		    barrierp->nthr);
+		free(barrierp->dissemination.barrier);
+		break;
+	case BARRIER_TOURNAMENT:
+		freerows((void **)barrierp->tournament.rounds, barrierp->nthr);
+		break;
+	case BARRIER_MCS:
+		free(barrierp->mcs);
+		break;
+	}
+}
+
+static int
+newbarrier(lua_State *L, enum barrier_type type)
+{
+	struct rcbarrier *barrierp;
+	lua_Integer nthr, groupsize;
+	int error;
+
+	nthr = luaL_checkinteger(L, 1);
+	luaL_argcheck(L, nthr > 0 && nthr <= UINT_MAX, 1,
+	    "bad number of threads");
+	groupsize = 0;
+	if (type == BARRIER_COMBINING) {
+		groupsize = luaL_optinteger(L, 2, BARRIER_COMBINING_GROUP_SIZE);
+		luaL_argcheck(L, groupsize > 0 && groupsize <= UINT_MAX, 2,
+		    "bad group size");
+	}
+
+	if ((barrierp = refcount_alloc(sizeof(*barrierp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	barrierp->type = type;
+	barrierp->nthr = nthr;
+	barrierp->subscribed = 0;
+	if (type == BARRIER_COMBINING) {
+		barrierp->combining.groupsize = groupsize;
+	}
+	if ((error = initbarrier(barrierp)) != 0) {
+		free(barrierp);
+		return (fatal(L, "initbarrier", error));
+	}
+	refcount_init(&barrierp->refs);
+	return (new(L, barrierp, BARRIER_METATABLE));
+}
+
+static inline void
+releasebarrier(struct rcbarrier *barrierp)
+{
+	if (refcount_release(&barrierp->refs)) {
+		finibarrier(barrierp);
+		free(barrierp);
+	}
+}
+
+static int
+l_ck_barrier_centralized_new(lua_State *L)
+{
+	return (newbarrier(L, BARRIER_CENTRALIZED));
+}
+
+static int
+l_ck_barrier_combining_new(lua_State *L)
+{
+	return (newbarrier(L, BARRIER_COMBINING));
+}
+
+static int
+l_ck_barrier_dissemination_new(lua_State *L)
+{
+	return (newbarrier(L, BARRIER_DISSEMINATION));
+}
+
+static int
+l_ck_barrier_tournament_new(lua_State *L)
+{
+	return (newbarrier(L, BARRIER_TOURNAMENT));
+}
+
+static int
+l_ck_barrier_mcs_new(lua_State *L)
+{
+	return (newbarrier(L, BARRIER_MCS));
+}
+
+static int
+l_ck_barrier_retain(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+
+	barrierp = checklightuserdata(L, 1);
+
+	refcount_retain(&barrierp->refs);
+	return (new(L, barrierp, BARRIER_METATABLE));
+}
+
+static int
+l_ck_barrier_gc(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+
+	barrierp = checkcookie(L, 1, BARRIER_METATABLE);
+
+	releasebarrier(barrierp);
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_barrier_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, BARRIER_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_barrier_threads(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+
+	barrierp = checkcookie(L, 1, BARRIER_METATABLE);
+
+	lua_pushinteger(L, barrierp->nthr);
+	return (1);
+}
+
+static int
+l_ck_barrier_subscribe(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+	union barrier_state *statep;
+	unsigned int vpid;
+
+	barrierp = checkcookie(L, 1, BARRIER_METATABLE);
+
+	statep = newext(L, barrierp, BARRIER_STATE_METATABLE, sizeof(*statep));
+	if ((vpid = ck_pr_faa_uint(&barrierp->subscribed, 1)) >=
+	    barrierp->nthr) {
+		invalidate(L, -1);
+		return (luaL_error(L, "all %d threads already subscribed",
+		    (int)barrierp->nthr));
+	}
+	refcount_retain(&barrierp->refs);
+	switch (barrierp->type) {
+	case BARRIER_CENTRALIZED:
+		statep->centralized = (ck_barrier_centralized_state_t)
+		    CK_BARRIER_CENTRALIZED_STATE_INITIALIZER;
+		break;
+	case BARRIER_COMBINING:
+		statep->combining.group = &barrierp->combining.groups[1 +
+		    vpid / barrierp->combining.groupsize];
+		statep->combining.state = (ck_barrier_combining_state_t)
+		    CK_BARRIER_COMBINING_STATE_INITIALIZER;
+		break;
+	case BARRIER_DISSEMINATION:
+		ck_barrier_dissemination_subscribe(
+		    barrierp->dissemination.barrier, &statep->dissemination);
+		break;
+	case BARRIER_TOURNAMENT:
+		ck_barrier_tournament_subscribe(&barrierp->tournament.barrier,
+		    &statep->tournament);
+		break;
+	case BARRIER_MCS:
+		ck_barrier_mcs_subscribe(barrierp->mcs, &statep->mcs);
+		break;
+	}
+	return (1);
+}
+
+static int
+l_ck_barrier_state_gc(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+
+	checkcookieuv(L, 1, BARRIER_STATE_METATABLE);
+	barrierp = lua_touserdata(L, -1);
+
+	/* The state may have been invalidated by a failed subscription. */
+	if (barrierp != NULL) {
+		releasebarrier(barrierp);
+		invalidate(L, 1);
+	}
+	return (0);
+}
+
+static int
+l_ck_barrier_state_wait(lua_State *L)
+{
+	struct rcbarrier *barrierp;
+	union barrier_state *statep;
+
+	barrierp = checkcookie(L, 1, BARRIER_STATE_METATABLE);
+	statep = lua_touserdata(L, 1);
+
+	switch (barrierp->type) {
+	case BARRIER_CENTRALIZED:
+		ck_barrier_centralized(&barrierp->centralized,
+		    &statep->centralized, barrierp->nthr);
+		break;
+	case BARRIER_COMBINING:
+		ck_barrier_combining(&barrierp->combining.barrier,
+		    statep->combining.group, &statep->combining.state);
+		break;
+	case BARRIER_DISSEMINATION:
+		ck_barrier_dissemination(barrierp->dissemination.barrier,
+		    &statep->dissemination);
+		break;
+	case BARRIER_TOURNAMENT:
+		ck_barrier_tournament(&barrierp->tournament.barrier,
+		    &statep->tournament);
+		break;
+	case BARRIER_MCS:
+		ck_barrier_mcs(barrierp->mcs, &statep->mcs);
+		break;
+	}
+	return (0);
+}
+
+static const struct luaL_Reg l_ck_barrier_centralized_funcs[] = {
+	{"new", l_ck_barrier_centralized_new},
+	{"retain", l_ck_barrier_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_combining_funcs[] = {
+	{"new", l_ck_barrier_combining_new},
+	{"retain", l_ck_barrier_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_dissemination_funcs[] = {
+	{"new", l_ck_barrier_dissemination_new},
+	{"retain", l_ck_barrier_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_tournament_funcs[] = {
+	{"new", l_ck_barrier_tournament_new},
+	{"retain", l_ck_barrier_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_mcs_funcs[] = {
+	{"new", l_ck_barrier_mcs_new},
+	{"retain", l_ck_barrier_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_meta[] = {
+	{"__gc", l_ck_barrier_gc},
+	{"cookie", l_ck_barrier_cookie},
+	{"threads", l_ck_barrier_threads},
+	{"subscribe", l_ck_barrier_subscribe},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_barrier_state_meta[] = {
+	{"__gc", l_ck_barrier_state_gc},
+	{"wait", l_ck_barrier_state_wait},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_barrier(lua_State *L)
+{
+	luaL_newmetatable(L, BARRIER_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_barrier_meta, 0);
+
+	luaL_newmetatable(L, BARRIER_STATE_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_barrier_state_meta, 0);
+
+	lua_newtable(L); /* ck.barrier */
+	luaL_newlib(L, l_ck_barrier_centralized_funcs);
+	lua_setfield(L, -2, "centralized");
+	luaL_newlib(L, l_ck_barrier_combining_funcs);
+	lua_setfield(L, -2, "combining");
+	luaL_newlib(L, l_ck_barrier_dissemination_funcs);
+	lua_setfield(L, -2, "dissemination");
+	luaL_newlib(L, l_ck_barrier_tournament_funcs);
+	lua_setfield(L, -2, "tournament");
+	luaL_newlib(L, l_ck_barrier_mcs_funcs);
+	lua_setfield(L, -2, "mcs");
+
+	return (1);
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_bitmap.h>
+#include <ck_pr.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define BITMAP_METATABLE "bitmap"
+
+struct rcbitmap {
+	ck_bitmap_t *bitmap; /* follows this header in the same allocation */
+	refcount refs CK_CC_CACHELINE;
+};
+
+static inline unsigned int
+checkbit(lua_State *L, int idx, struct rcbitmap *bitmapp)
+{
+	lua_Integer bit;
+
+	bit = luaL_checkinteger(L, idx);
+	luaL_argcheck(L, bit >= 0 && bit < ck_bitmap_bits(bitmapp->bitmap),
+	    idx, "bit index out of range");
+	return (bit);
+}
+
+static inline unsigned int
+optlimit(lua_State *L, int idx, struct rcbitmap *bitmapp)
+{
+	unsigned int bits = ck_bitmap_bits(bitmapp->bitmap);
+	lua_Integer limit;
+
+	limit = luaL_optinteger(L, idx, bits);
+	luaL_argcheck(L, limit >= 0, idx, "negative limit");
+	return (limit < bits ? limit : bits);
+}
+
+static int
+l_ck_bitmap_new(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	lua_Integer bits;
+	bool set;
+
+	bits = luaL_checkinteger(L, 1);
+	set = lua_toboolean(L, 2);
+	luaL_argcheck(L, bits > 0 && bits <= UINT_MAX - CK_BITMAP_BLOCK, 1,
+	    "bad number of bits");
+
+	if ((bitmapp = refcount_alloc(sizeof(*bitmapp) +
+	    ck_bitmap_size(bits))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	bitmapp->bitmap = (ck_bitmap_t *)(bitmapp + 1);
+	ck_bitmap_init(bitmapp->bitmap, bits, set);
+	refcount_init(&bitmapp->refs);
+	return (new(L, bitmapp, BITMAP_METATABLE));
+}
+
+static int
+l_ck_bitmap_retain(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+
+	bitmapp = checklightuserdata(L, 1);
+
+	refcount_retain(&bitmapp->refs);
+	return (new(L, bitmapp, BITMAP_METATABLE));
+}
+
+static int
+l_ck_bitmap_gc(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+
+	if (refcount_release(&bitmapp->refs)) {
+		free(bitmapp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_bitmap_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, BITMAP_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_bitmap_bits(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+
+	lua_pushinteger(L, ck_bitmap_bits(bitmapp->bitmap));
+	return (1);
+}
+
+static int
+l_ck_bitmap_set(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int bit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	bit = checkbit(L, 2, bitmapp);
+
+	ck_bitmap_set(bitmapp->bitmap, bit);
+	return (0);
+}
+
+static int
+l_ck_bitmap_reset(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int bit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	bit = checkbit(L, 2, bitmapp);
+
+	ck_bitmap_reset(bitmapp->bitmap, bit);
+	return (0);
+}
+
+static int
+l_ck_bitmap_test(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int bit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	bit = checkbit(L, 2, bitmapp);
+
+	lua_pushboolean(L, ck_bitmap_test(bitmapp->bitmap, bit));
+	return (1);
+}
+
+static int
+l_ck_bitmap_bts(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int bit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	bit = checkbit(L, 2, bitmapp);
+
+	lua_pushboolean(L, ck_bitmap_bts(bitmapp->bitmap, bit));
+	return (1);
+}
+
+static int
+l_ck_bitmap_clear(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+
+	ck_bitmap_clear(bitmapp->bitmap);
+	return (0);
+}
+
+static int
+l_ck_bitmap_union(lua_State *L)
+{
+	struct rcbitmap *dstp, *srcp;
+
+	dstp = checkcookie(L, 1, BITMAP_METATABLE);
+	srcp = checkcookie(L, 2, BITMAP_METATABLE);
+
+	ck_bitmap_union(dstp->bitmap, srcp->bitmap);
+	return (0);
+}
+
+static int
+l_ck_bitmap_intersection(lua_State *L)
+{
+	struct rcbitmap *dstp, *srcp;
+
+	dstp = checkcookie(L, 1, BITMAP_METATABLE);
+	srcp = checkcookie(L, 2, BITMAP_METATABLE);
+
+	ck_bitmap_intersection(dstp->bitmap, srcp->bitmap);
+	return (0);
+}
+
+static int
+l_ck_bitmap_intersection_negate(lua_State *L)
+{
+	struct rcbitmap *dstp, *srcp;
+
+	dstp = checkcookie(L, 1, BITMAP_METATABLE);
+	srcp = checkcookie(L, 2, BITMAP_METATABLE);
+
+	ck_bitmap_intersection_negate(dstp->bitmap, srcp->bitmap);
+	return (0);
+}
+
+static int
+l_ck_bitmap_count(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int limit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	limit = optlimit(L, 2, bitmapp);
+
+	lua_pushinteger(L, ck_bitmap_count(bitmapp->bitmap, limit));
+	return (1);
+}
+
+static int
+l_ck_bitmap_count_intersect(lua_State *L)
+{
+	struct rcbitmap *bitmapp, *otherp;
+	unsigned int limit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	otherp = checkcookie(L, 2, BITMAP_METATABLE);
+	limit = optlimit(L, 3, bitmapp);
+
+	lua_pushinteger(L, ck_bitmap_count_intersect(bitmapp->bitmap,
+	    otherp->bitmap, limit));
+	return (1);
+}
+
+static int
+l_ck_bitmap_empty(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int limit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	limit = optlimit(L, 2, bitmapp);
+
+	lua_pushboolean(L, ck_bitmap_empty(bitmapp->bitmap, limit));
+	return (1);
+}
+
+static int
+l_ck_bitmap_full(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int limit;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	limit = optlimit(L, 2, bitmapp);
+
+	lua_pushboolean(L, ck_bitmap_full(bitmapp->bitmap, limit));
+	return (1);
+}
+
+/*
+ * CK has no find-first-clear, so scan the blocks directly.  A whole block is
+ * tested at once, so a mostly full bitmap costs one load per 32 bits rather
+ * than one ck_bitmap_test() per bit.
+ */
+static int
+l_ck_bitmap_first_clear(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	unsigned int *map;
+	unsigned int bits, block, first, nblocks, word;
+	lua_Integer start;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+	bits = ck_bitmap_bits(bitmapp->bitmap);
+	start = luaL_optinteger(L, 2, 0);
+	luaL_argcheck(L, start >= 0, 2, "bit index out of range");
+	if (start >= bits) {
+		luaL_pushfail(L);
+		return (1);
+	}
+
+	map = ck_bitmap_buffer(bitmapp->bitmap);
+	nblocks = CK_BITMAP_BLOCKS(bits);
+	first = start / CK_BITMAP_BLOCK;
+	for (block = first; block < nblocks; block++) {
+		word = ~ck_pr_load_uint(&map[block]);
+		if (block == first) {
+			/* Ignore bits before start in the first block. */
+			word &= ~0U << (start % CK_BITMAP_BLOCK);
+		}
+		if (word != 0) {
+			unsigned int bit;
+
+			bit = block * CK_BITMAP_BLOCK + __builtin_ctz(word);
+			if (bit >= bits) {
+				break;
+			}
+			lua_pushinteger(L, bit);
+			return (1);
+		}
+	}
+	luaL_pushfail(L);
+	return (1);
+}
+
+static int
+bitmap_next(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	ck_bitmap_iterator_t *iter;
+	unsigned int bit;
+
+	iter = lua_touserdata(L, lua_upvalueindex(1));
+	bitmapp = checkcookie(L, lua_upvalueindex(2), BITMAP_METATABLE);
+
+	if (!ck_bitmap_next(bitmapp->bitmap, iter, &bit)) {
+		return (0);
+	}
+	lua_pushinteger(L, bit);
+	return (1);
+}
+
+static int
+l_ck_bitmap_iterator(lua_State *L)
+{
+	struct rcbitmap *bitmapp;
+	ck_bitmap_iterator_t *iter;
+
+	bitmapp = checkcookie(L, 1, BITMAP_METATABLE);
+
+	iter = lua_newuserdatauv(L, sizeof(*iter), 0);
+	ck_bitmap_iterator_init(iter, bitmapp->bitmap);
+	lua_pushvalue(L, 1);
+	lua_pushcclosure(L, bitmap_next, 2);
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_bitmap_funcs[] = {
+	{"new", l_ck_bitmap_new},
+	{"retain", l_ck_bitmap_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_bitmap_meta[] = {
+	{"__gc", l_ck_bitmap_gc},
+	{"cookie", l_ck_bitmap_cookie},
+	{"bits", l_ck_bitmap_bits},
+	{"set", l_ck_bitmap_set},
+	{"reset", l_ck_bitmap_reset},
+	{"test", l_ck_bitmap_test},
+	{"bts", l_ck_bitmap_bts},
+	{"clear", l_ck_bitmap_clear},
+	{"union", l_ck_bitmap_union},
+	{"intersection", l_ck_bitmap_intersection},
+	{"intersection_negate", l_ck_bitmap_intersection_negate},
+	{"count", l_ck_bitmap_count},
+	{"count_intersect", l_ck_bitmap_count_intersect},
+	{"empty", l_ck_bitmap_empty},
+	{"full", l_ck_bitmap_full},
+	{"first_clear", l_ck_bitmap_first_clear},
+	{"iterator", l_ck_bitmap_iterator},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_bitmap(lua_State *L)
+{
+	luaL_newmetatable(L, BITMAP_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_bitmap_meta, 0);
+
+	luaL_newlib(L, l_ck_bitmap_funcs); /* ck.bitmap */
+	return (1);
+}
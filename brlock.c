@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_brlock.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define BRLOCK_METATABLE "brlock"
+
+struct rcbrlock {
+	ck_brlock_t lock;
+	refcount refs CK_CC_CACHELINE;
+};
+
+/*
+ * Registering and unregistering a reader takes the write lock, so rather than
+ * every reference, each Lua state registers one reader slot per lock, kept in
+ * a registry table keyed by this address that maps the lock to its slot.  The
+ * slot is registered by the first reference to the lock in the state and
+ * unregistered when the last one is collected, at the latest when the state is
+ * closed.  No reference in the state can be holding the lock at either point,
+ * so neither deadlocks against the state itself.
+ */
+static int brlock_readers;
+
+struct brslot {
+	ck_brlock_reader_t reader;
+	unsigned int refs;
+};
+
+/*
+ * Each reference tracks the read locks and the write lock it holds, so that
+ * they can be released when it is collected.
+ */
+struct brref {
+	struct brslot *slot;
+	unsigned int readers;
+	bool writer;
+};
+
+static inline struct brref *
+checkbrref(lua_State *L, int idx, struct rcbrlock **lockpp)
+{
+	*lockpp = checkcookie(L, idx, BRLOCK_METATABLE);
+	return (lua_touserdata(L, idx));
+}
+
+static inline int
+newbrref(lua_State *L, struct rcbrlock *lockp)
+{
+	struct brslot *slot;
+	struct brref *ref;
+
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &brlock_readers);
+	if (lua_rawgetp(L, -1, lockp) == LUA_TNIL) {
+		slot = lua_newuserdatauv(L, sizeof(*slot), 0);
+		slot->refs = 0;
+		ck_brlock_read_register(&lockp->lock, &slot->reader);
+		lua_rawsetp(L, -3, lockp);
+	} else {
+		slot = lua_touserdata(L, -1);
+	}
+	lua_pop(L, 2);
+	ref = newext(L, lockp, BRLOCK_METATABLE, sizeof(*ref));
+	ref->slot = slot;
+	slot->refs++;
+	return (1);
+}
+
+static int
+l_ck_brlock_new(lua_State *L)
+{
+	struct rcbrlock *lockp;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_brlock_init(&lockp->lock);
+	refcount_init(&lockp->refs);
+	return (newbrref(L, lockp));
+}
+
+static int
+l_ck_brlock_retain(lua_State *L)
+{
+	struct rcbrlock *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	return (newbrref(L, lockp));
+}
+
+static int
+l_ck_brlock_gc(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+
+	ref = checkbrref(L, 1, &lockp);
+
+	if (ref->writer) {
+		ck_brlock_write_unlock(&lockp->lock);
+	}
+	for (; ref->readers > 0; ref->readers--) {
+		ck_brlock_read_unlock(&ref->slot->reader);
+	}
+	if (--ref->slot->refs == 0) {
+		ck_brlock_read_unregister(&lockp->lock, &ref->slot->reader);
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &brlock_readers);
+		lua_pushnil(L);
+		lua_rawsetp(L, -2, lockp);
+		lua_pop(L, 1);
+	}
+	if (refcount_release(&lockp->refs)) {
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_brlock_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, BRLOCK_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_brlock_write_lock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->writer, 1,
+	    "already write locked by this reference");
+
+	ck_brlock_write_lock(&lockp->lock);
+	ref->writer = true;
+	return (0);
+}
+
+static int
+l_ck_brlock_write_trylock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+	unsigned int factor;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->writer, 1,
+	    "already write locked by this reference");
+	factor = luaL_optinteger(L, 2, 1);
+
+	ref->writer = ck_brlock_write_trylock(&lockp->lock, factor);
+	lua_pushboolean(L, ref->writer);
+	return (1);
+}
+
+static int
+l_ck_brlock_write_unlock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_argcheck(L, ref->writer, 1, "not write locked by this reference");
+
+	ref->writer = false;
+	ck_brlock_write_unlock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_brlock_read_lock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+
+	ref = checkbrref(L, 1, &lockp);
+
+	ck_brlock_read_lock(&lockp->lock, &ref->slot->reader);
+	ref->readers++;
+	return (0);
+}
+
+static int
+l_ck_brlock_read_trylock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+	unsigned int factor;
+
+	ref = checkbrref(L, 1, &lockp);
+	factor = luaL_optinteger(L, 2, 1);
+
+	if (ck_brlock_read_trylock(&lockp->lock, &ref->slot->reader, factor)) {
+		ref->readers++;
+		lua_pushboolean(L, true);
+	} else {
+		lua_pushboolean(L, false);
+	}
+	return (1);
+}
+
+static int
+l_ck_brlock_read_unlock(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_argcheck(L, ref->readers > 0, 1,
+	    "not read locked by this reference");
+
+	ref->readers--;
+	ck_brlock_read_unlock(&ref->slot->reader);
+	return (0);
+}
+
+static int
+l_ck_brlock_with_read(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+	int status;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_brlock_read_lock(&lockp->lock, &ref->slot->reader);
+	ref->readers++;
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ref->readers--;
+	ck_brlock_read_unlock(&ref->slot->reader);
+	return (withresults(L, status, 1));
+}
+
+static int
+l_ck_brlock_with_write(lua_State *L)
+{
+	struct rcbrlock *lockp;
+	struct brref *ref;
+	int status;
+
+	ref = checkbrref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->writer, 1,
+	    "already write locked by this reference");
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_brlock_write_lock(&lockp->lock);
+	ref->writer = true;
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ref->writer = false;
+	ck_brlock_write_unlock(&lockp->lock);
+	return (withresults(L, status, 1));
+}
+
+static const struct luaL_Reg l_ck_brlock_funcs[] = {
+	{"new", l_ck_brlock_new},
+	{"retain", l_ck_brlock_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_brlock_meta[] = {
+	{"__gc", l_ck_brlock_gc},
+	{"cookie", l_ck_brlock_cookie},
+	{"write_lock", l_ck_brlock_write_lock},
+	{"write_trylock", l_ck_brlock_write_trylock},
+	{"write_unlock", l_ck_brlock_write_unlock},
+	{"read_lock", l_ck_brlock_read_lock},
+	{"read_trylock", l_ck_brlock_read_trylock},
+	{"read_unlock", l_ck_brlock_read_unlock},
+	{"with_read", l_ck_brlock_with_read},
+	{"with_write", l_ck_brlock_with_write},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_brlock(lua_State *L)
+{
+	luaL_newmetatable(L, BRLOCK_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_brlock_meta, 0);
+
+	if (lua_rawgetp(L, LUA_REGISTRYINDEX, &brlock_readers) == LUA_TNIL) {
+		lua_newtable(L);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &brlock_readers);
+	}
+	lua_pop(L, 1);
+
+	luaL_newlib(L, l_ck_brlock_funcs); /* ck.brlock */
+	return (1);
+}
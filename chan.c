@@ -0,0 +1,645 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sys/queue.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <ck_ec.h>
+#include <ck_pr.h>
+#include <ck_ring.h>
+#include <ck_spinlock.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "ec.h"
+#include "refcount.h"
+#include "serde.h"
+#include "serdebuf.h"
+#include "luaerror.h"
+
+#define CHAN_METATABLE "chan"
+
+/*
+ * Channels follow the design of Go's: each channel has a lock protecting its
+ * buffer and the queues of blocked senders and receivers.  A blocked operation
+ * is a case of a selector, which is queued on every channel it is waiting for.
+ * Whichever thread first claims the selector completes the case, handing the
+ * value over directly, and wakes the blocked thread through the event count
+ * embedded in the selector.  Cases of a selector that lost the race are
+ * dequeued by the blocked thread itself once it has been woken.
+ *
+ * The buffer of a buffered channel is a ck_ring.  All access to it is
+ * serialized by the channel lock, so the single producer/single consumer ring
+ * operations suffice.  An unbuffered channel has an empty ring, so every send
+ * waits for a receiver to take the value.
+ */
+struct rcchan {
+	ck_spinlock_t lock;
+	TAILQ_HEAD(, selcase) sendq;
+	TAILQ_HEAD(, selcase) recvq;
+	ck_ring_t ring;
+	ck_ring_buffer_t *buffer;
+	unsigned int capacity;
+	bool closed;
+	refcount refs CK_CC_CACHELINE;
+};
+
+struct selector {
+	ck_ec32_t ec; /* incremented once, by the thread that claims fired */
+	int fired; /* index of the completed case, -1 until claimed */
+};
+
+enum chanop {
+	CHAN_SEND,
+	CHAN_RECV,
+};
+
+struct selcase {
+	TAILQ_ENTRY(selcase) link;
+	struct rcchan *chanp;
+	struct selector *sel;
+	void *value; /* serialized value sent or received */
+	enum chanop op;
+	int idx;
+	bool queued;
+	bool ok; /* false if the case completed because the channel is closed */
+};
+
+static inline void
+chanlock(struct rcchan **locks, int nlocks)
+{
+	for (int i = 0; i < nlocks; i++) {
+		ck_spinlock_lock(&locks[i]->lock);
+	}
+}
+
+static inline void
+chanunlock(struct rcchan **locks, int nlocks)
+{
+	for (int i = nlocks - 1; i >= 0; i--) {
+		ck_spinlock_unlock(&locks[i]->lock);
+	}
+}
+
+/*
+ * A case queued by another thread can be completed only if no other case of
+ * its selector has completed first.  The channel of the case must stay locked
+ * until the thread is woken, which keeps the selector alive.
+ */
+static inline bool
+claim(struct selcase *c)
+{
+	return (ck_pr_cas_int(&c->sel->fired, -1, c->idx));
+}
+
+static inline void
+wake(struct selcase *c)
+{
+	ck_ec32_inc(&c->sel->ec, &ec_mp);
+}
+
+/*
+ * Dequeue the first blocked case of the given kind that can be claimed.
+ * Called with the channel locked.
+ */
+static inline struct selcase *
+claimfirst(struct rcchan *chanp, enum chanop op)
+{
+	struct selcase *c;
+
+	while ((c = op == CHAN_SEND ? TAILQ_FIRST(&chanp->sendq) :
+	    TAILQ_FIRST(&chanp->recvq)) != NULL) {
+		if (op == CHAN_SEND) {
+			TAILQ_REMOVE(&chanp->sendq, c, link);
+		} else {
+			TAILQ_REMOVE(&chanp->recvq, c, link);
+		}
+		c->queued = false;
+		if (claim(c)) {
+			return (c);
+		}
+	}
+	return (NULL);
+}
+
+/*
+ * Try to complete a send without blocking.  Called with the channel locked.
+ */
+static bool
+trysend(struct selcase *c)
+{
+	struct rcchan *chanp = c->chanp;
+	struct selcase *r;
+
+	if (chanp->closed) {
+		c->ok = false;
+		return (true);
+	}
+	if ((r = claimfirst(chanp, CHAN_RECV)) != NULL) {
+		r->value = c->value;
+		r->ok = true;
+		wake(r);
+		c->ok = true;
+		return (true);
+	}
+	if (ck_ring_size(&chanp->ring) < chanp->capacity) {
+		ck_ring_enqueue_spsc(&chanp->ring, chanp->buffer, c->value);
+		c->ok = true;
+		return (true);
+	}
+	return (false);
+}
+
+/*
+ * Try to complete a receive without blocking.  Called with the channel locked.
+ */
+static bool
+tryrecv(struct selcase *c)
+{
+	struct rcchan *chanp = c->chanp;
+	struct selcase *s;
+
+	if (ck_ring_dequeue_spsc(&chanp->ring, chanp->buffer, &c->value)) {
+		/* Make room for a blocked sender. */
+		if ((s = claimfirst(chanp, CHAN_SEND)) != NULL) {
+			ck_ring_enqueue_spsc(&chanp->ring, chanp->buffer,
+			    s->value);
+			s->ok = true;
+			wake(s);
+		}
+		c->ok = true;
+		return (true);
+	}
+	if ((s = claimfirst(chanp, CHAN_SEND)) != NULL) {
+		c->value = s->value;
+		s->ok = true;
+		wake(s);
+		c->ok = true;
+		return (true);
+	}
+	if (chanp->closed) {
+		c->value = NULL;
+		c->ok = false;
+		return (true);
+	}
+	return (false);
+}
+
+/*
+ * Wait for one of n cases to complete, or until the deadline if there is one.
+ * If poll is true, return immediately when no case can complete.  The cases
+ * are tried in order from a random starting point so that no case is starved.
+ * locks is the set of channels involved, sorted by address.  Returns the index
+ * of the completed case, or -1 if none completed.
+ */
+static int
+chanselect(struct selcase *cases, int n, struct rcchan **locks, int nlocks,
+    const struct timespec *deadline, bool poll)
+{
+	struct selector sel;
+	struct selcase *c;
+	int start;
+
+	sel.fired = -1;
+	ck_ec32_init(&sel.ec, 0);
+	start = n > 1 ? arc4random_uniform(n) : 0;
+
+	chanlock(locks, nlocks);
+	for (int i = 0; i < n; i++) {
+		c = &cases[(start + i) % n];
+		c->sel = &sel;
+		c->idx = (start + i) % n;
+		c->queued = false;
+		if (c->op == CHAN_SEND ? trysend(c) : tryrecv(c)) {
+			chanunlock(locks, nlocks);
+			return (c->idx);
+		}
+	}
+	if (poll) {
+		chanunlock(locks, nlocks);
+		return (-1);
+	}
+	for (int i = 0; i < n; i++) {
+		c = &cases[i];
+		if (c->op == CHAN_SEND) {
+			TAILQ_INSERT_TAIL(&c->chanp->sendq, c, link);
+		} else {
+			TAILQ_INSERT_TAIL(&c->chanp->recvq, c, link);
+		}
+		c->queued = true;
+	}
+	chanunlock(locks, nlocks);
+
+	while (ck_ec32_value(&sel.ec) == 0) {
+		if (ck_ec32_wait(&sel.ec, &ec_mp, 0, deadline) != 0) {
+			/* Timed out, unless a case completes in the meantime. */
+			ck_pr_cas_int(&sel.fired, -1, n);
+			break;
+		}
+	}
+
+	chanlock(locks, nlocks);
+	for (int i = 0; i < n; i++) {
+		c = &cases[i];
+		if (!c->queued) {
+			continue;
+		}
+		if (c->op == CHAN_SEND) {
+			TAILQ_REMOVE(&c->chanp->sendq, c, link);
+		} else {
+			TAILQ_REMOVE(&c->chanp->recvq, c, link);
+		}
+		c->queued = false;
+	}
+	chanunlock(locks, nlocks);
+	return (sel.fired == n ? -1 : sel.fired);
+}
+
+static int
+chancmp(const void *a, const void *b)
+{
+	uintptr_t x = (uintptr_t)*(struct rcchan *const *)a;
+	uintptr_t y = (uintptr_t)*(struct rcchan *const *)b;
+
+	return ((x > y) - (x < y));
+}
+
+/*
+ * Collect the distinct channels of the cases in the order they must be locked.
+ */
+static int
+sortlocks(struct selcase *cases, int n, struct rcchan **locks)
+{
+	int i, nlocks;
+
+	for (i = 0; i < n; i++) {
+		locks[i] = cases[i].chanp;
+	}
+	qsort(locks, n, sizeof(*locks), chancmp);
+	for (i = nlocks = 0; i < n; i++) {
+		if (nlocks == 0 || locks[nlocks - 1] != locks[i]) {
+			locks[nlocks++] = locks[i];
+		}
+	}
+	return (nlocks);
+}
+
+/*
+ * Parse an optional relative timeout of sec [, nsec] at idx into a deadline.
+ * A timeout of zero polls instead of waiting.
+ */
+static inline const struct timespec *
+optdeadline(lua_State *L, int idx, struct timespec *deadline, bool *pollp)
+{
+	struct timespec timeout;
+
+	*pollp = false;
+	if (lua_isnoneornil(L, idx)) {
+		return (NULL);
+	}
+	timeout.tv_sec = luaL_checkinteger(L, idx);
+	timeout.tv_nsec = luaL_optinteger(L, idx + 1, 0);
+	if (timeout.tv_sec == 0 && timeout.tv_nsec == 0) {
+		*pollp = true;
+		return (NULL);
+	}
+	if (ck_ec_deadline(deadline, &ec_mp, &timeout) == -1) {
+		fatal(L, "ck_ec_deadline", errno);
+	}
+	return (deadline);
+}
+
+/*
+ * Push the value received by a case, freeing the serialized copy.
+ */
+static inline int
+pushreceived(lua_State *L, struct selcase *c)
+{
+	bool ok;
+
+	if (!c->ok) {
+		lua_pushboolean(L, false);
+		return (1);
+	}
+	lua_pushboolean(L, true);
+	ok = loadshared(L, c->value) != NULL;
+	free(c->value);
+	return (ok ? 2 : lua_error(L));
+}
+
+static int
+l_ck_chan_new(lua_State *L)
+{
+	struct rcchan *chanp;
+	lua_Integer capacity;
+	unsigned int size;
+
+	capacity = luaL_optinteger(L, 1, 0);
+	luaL_argcheck(L, capacity >= 0 && capacity <= UINT_MAX / 2, 1,
+	    "bad capacity");
+
+	/* The ring needs a power of two slots, one of which is never used. */
+	for (size = 1; size < capacity + 1; size <<= 1)
+		;
+	if ((chanp = refcount_alloc(sizeof(*chanp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	if ((chanp->buffer = malloc(sizeof(ck_ring_buffer_t) * size)) == NULL) {
+		free(chanp);
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_spinlock_init(&chanp->lock);
+	TAILQ_INIT(&chanp->sendq);
+	TAILQ_INIT(&chanp->recvq);
+	ck_ring_init(&chanp->ring, size);
+	chanp->capacity = capacity;
+	chanp->closed = false;
+	refcount_init(&chanp->refs);
+	return (new(L, chanp, CHAN_METATABLE));
+}
+
+static int
+l_ck_chan_retain(lua_State *L)
+{
+	struct rcchan *chanp;
+
+	chanp = checklightuserdata(L, 1);
+
+	refcount_retain(&chanp->refs);
+	return (new(L, chanp, CHAN_METATABLE));
+}
+
+static int
+l_ck_chan_select(lua_State *L)
+{
+	struct timespec deadline;
+	const struct timespec *deadlinep;
+	struct selcase *cases, *c;
+	struct rcchan **locks;
+	lua_Integer n;
+	int fired, nlocks, error;
+	bool poll;
+
+	static const char *const ops[] = {
+		[CHAN_SEND] = "send",
+		[CHAN_RECV] = "recv",
+		NULL
+	};
+
+	luaL_checktype(L, 1, LUA_TTABLE);
+	n = luaL_len(L, 1);
+	luaL_argcheck(L, n > 0 && n < INT_MAX, 1, "bad number of cases");
+	deadlinep = optdeadline(L, 2, &deadline, &poll);
+
+	/* The cases are collected by the GC if an error is raised. */
+	cases = lua_newuserdatauv(L, (sizeof(*cases) + sizeof(*locks)) * n, 0);
+	locks = (struct rcchan **)(cases + n);
+	for (int i = 0; i < n; i++) {
+		c = &cases[i];
+		lua_geti(L, 1, i + 1);
+		luaL_argcheck(L, lua_istable(L, -1), 1, "case is not a table");
+		lua_geti(L, -1, 1);
+		c->op = luaL_checkoption(L, -1, NULL, ops);
+		lua_pop(L, 1);
+		lua_geti(L, -1, 2);
+		c->chanp = checkcookie(L, lua_gettop(L), CHAN_METATABLE);
+		lua_pop(L, 1);
+		c->value = NULL;
+		lua_pop(L, 1);
+	}
+	for (int i = 0; i < n; i++) {
+		c = &cases[i];
+		if (c->op != CHAN_SEND) {
+			continue;
+		}
+		lua_geti(L, 1, i + 1);
+		lua_geti(L, -1, 3);
+		error = serdebuf_serialize_value(L, lua_gettop(L), &c->value);
+		if (error != 0) {
+			while (--i >= 0) {
+				if (cases[i].op == CHAN_SEND) {
+					free(cases[i].value);
+				}
+			}
+			if (error < 0) {
+				return (lua_error(L));
+			}
+			return (fatal(L, "serdebuf_serialize_value", error));
+		}
+		lua_pop(L, 2);
+	}
+	nlocks = sortlocks(cases, n, locks);
+
+	fired = chanselect(cases, n, locks, nlocks, deadlinep, poll);
+
+	/* Free the values of sends that did not complete. */
+	for (int i = 0; i < n; i++) {
+		c = &cases[i];
+		if (c->op == CHAN_SEND && (i != fired || !c->ok)) {
+			free(c->value);
+		}
+	}
+	if (fired == -1) {
+		return (fail(L, ETIMEDOUT));
+	}
+	c = &cases[fired];
+	lua_pushinteger(L, fired + 1);
+	if (c->op == CHAN_SEND) {
+		if (!c->ok) {
+			return (luaL_error(L, "send on closed channel"));
+		}
+		return (1);
+	}
+	return (1 + pushreceived(L, c));
+}
+
+static int
+l_ck_chan_gc(lua_State *L)
+{
+	struct rcchan *chanp;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+
+	if (refcount_release(&chanp->refs)) {
+		void *v;
+
+		while (ck_ring_dequeue_spsc(&chanp->ring, chanp->buffer, &v)) {
+			free(v);
+		}
+		free(chanp->buffer);
+		free(chanp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_chan_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, CHAN_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_chan_send(lua_State *L)
+{
+	struct timespec deadline;
+	const struct timespec *deadlinep;
+	struct selcase c;
+	struct rcchan *chanp;
+	int error;
+	bool poll;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+	luaL_checkany(L, 2);
+	deadlinep = optdeadline(L, 3, &deadline, &poll);
+
+	c.chanp = chanp;
+	c.op = CHAN_SEND;
+	if ((error = serdebuf_serialize_value(L, 2, &c.value)) != 0) {
+		if (error < 0) {
+			return (lua_error(L));
+		}
+		return (fatal(L, "serdebuf_serialize_value", error));
+	}
+	if (chanselect(&c, 1, &chanp, 1, deadlinep, poll) == -1) {
+		free(c.value);
+		return (fail(L, ETIMEDOUT));
+	}
+	if (!c.ok) {
+		free(c.value);
+		return (luaL_error(L, "send on closed channel"));
+	}
+	lua_pushboolean(L, true);
+	return (1);
+}
+
+static int
+l_ck_chan_recv(lua_State *L)
+{
+	struct timespec deadline;
+	const struct timespec *deadlinep;
+	struct selcase c;
+	struct rcchan *chanp;
+	bool poll;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+	deadlinep = optdeadline(L, 2, &deadline, &poll);
+
+	c.chanp = chanp;
+	c.op = CHAN_RECV;
+	if (chanselect(&c, 1, &chanp, 1, deadlinep, poll) == -1) {
+		return (fail(L, ETIMEDOUT));
+	}
+	return (pushreceived(L, &c));
+}
+
+static int
+l_ck_chan_close(lua_State *L)
+{
+	struct rcchan *chanp;
+	struct selcase *c;
+	bool closed;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+
+	ck_spinlock_lock(&chanp->lock);
+	if (!(closed = chanp->closed)) {
+		chanp->closed = true;
+		while ((c = claimfirst(chanp, CHAN_RECV)) != NULL) {
+			c->value = NULL;
+			c->ok = false;
+			wake(c);
+		}
+		while ((c = claimfirst(chanp, CHAN_SEND)) != NULL) {
+			c->ok = false;
+			wake(c);
+		}
+	}
+	ck_spinlock_unlock(&chanp->lock);
+	if (closed) {
+		return (luaL_error(L, "close of closed channel"));
+	}
+	return (0);
+}
+
+static int
+l_ck_chan_isclosed(lua_State *L)
+{
+	struct rcchan *chanp;
+	bool closed;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+
+	ck_spinlock_lock(&chanp->lock);
+	closed = chanp->closed;
+	ck_spinlock_unlock(&chanp->lock);
+	lua_pushboolean(L, closed);
+	return (1);
+}
+
+static int
+l_ck_chan_size(lua_State *L)
+{
+	struct rcchan *chanp;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+
+	lua_pushinteger(L, ck_ring_size(&chanp->ring));
+	return (1);
+}
+
+static int
+l_ck_chan_capacity(lua_State *L)
+{
+	struct rcchan *chanp;
+
+	chanp = checkcookie(L, 1, CHAN_METATABLE);
+
+	lua_pushinteger(L, chanp->capacity);
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_chan_funcs[] = {
+	{"new", l_ck_chan_new},
+	{"retain", l_ck_chan_retain},
+	{"select", l_ck_chan_select},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_chan_meta[] = {
+	{"__gc", l_ck_chan_gc},
+	{"cookie", l_ck_chan_cookie},
+	{"send", l_ck_chan_send},
+	{"recv", l_ck_chan_recv},
+	{"close", l_ck_chan_close},
+	{"isclosed", l_ck_chan_isclosed},
+	{"size", l_ck_chan_size},
+	{"capacity", l_ck_chan_capacity},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_chan(lua_State *L)
+{
+	luaL_newmetatable(L, CHAN_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_chan_meta, 0);
+
+	luaL_newlib(L, l_ck_chan_funcs); /* ck.chan */
+	return (1);
+}
@@ -13,6 +13,8 @@
 #include <lauxlib.h>
 #include <lualib.h>
 
+#include "compat.h"
+
 /* Debugging tools */
 #define STR(x) #x
 #define XSTR(x) STR(x)
@@ -20,7 +22,7 @@
 
 /* constructor/destructor priorities */
 enum {
-	PRIO_HP,
+	PRIO_HP = 101, /* 0-100 are reserved for the implementation */
 	PRIO_HT,
 };
 
@@ -40,6 +42,25 @@ new(lua_State *L, void *cookie, const char *metatable)
 	return (1);
 }
 
+/*
+ * Like new(), but the reference also carries size bytes of per-reference state
+ * (e.g. a queue node for a lock) that lives as long as the reference does.
+ */
+static inline void *
+newext(lua_State *L, void *cookie, const char *metatable, size_t size)
+{
+	void *p;
+
+	p = lua_newuserdatauv(L, size, 1);
+	memset(p, 0, size);
+	luaL_setmetatable(L, metatable);
+
+	lua_pushlightuserdata(L, cookie);
+	lua_setiuservalue(L, -2, COOKIE);
+
+	return (p);
+}
+
 static inline void *
 checklightuserdata(lua_State *L, int idx)
 {
@@ -99,6 +120,20 @@ newstream(lua_State *L, FILE *f)
 	stream->closef = closestream;
 }
 
+/*
+ * Finish a call made with lua_pcall() by a method of the form
+ * obj:with(fn, ...) once any resources held for the call have been released.
+ * Errors are propagated, otherwise the results of the call are returned.
+ */
+static inline int
+withresults(lua_State *L, int status, int base)
+{
+	if (status != LUA_OK) {
+		return (lua_error(L));
+	}
+	return (lua_gettop(L) - base);
+}
+
 static inline int
 fail(lua_State *L, int error)
 {
@@ -120,10 +155,22 @@ fatal(lua_State *L, const char *source, int error)
 	return (luaL_error(L, "%s: %s", source, msg));
 }
 
+int luaopen_ck(lua_State *L);
+int luaopen_ck_barrier(lua_State *L);
+int luaopen_ck_bitmap(lua_State *L);
+int luaopen_ck_brlock(lua_State *L);
+int luaopen_ck_chan(lua_State *L);
+int luaopen_ck_counter(lua_State *L);
 int luaopen_ck_ec(lua_State *L);
 int luaopen_ck_fifo(lua_State *L);
+int luaopen_ck_future(lua_State *L);
+int luaopen_ck_parallel(lua_State *L);
+int luaopen_ck_pool(lua_State *L);
 int luaopen_ck_pr(lua_State *L);
 int luaopen_ck_ring(lua_State *L);
+int luaopen_ck_rwlock(lua_State *L);
 int luaopen_ck_sequence(lua_State *L);
 int luaopen_ck_serde(lua_State *L);
 int luaopen_ck_shared(lua_State *L);
+int luaopen_ck_spinlock(lua_State *L);
+int luaopen_ck_stack(lua_State *L);
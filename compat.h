@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+/*
+ * The module is written for FreeBSD.  Elsewhere (only Linux with glibc is
+ * tested) the few FreeBSD extensions it uses are provided here in terms of
+ * portable or native interfaces with the same semantics.
+ */
+
+#ifdef __FreeBSD__
+
+#include <sys/param.h>
+#include <malloc_np.h>
+
+#else
+
+#include <sys/param.h>
+#include <limits.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef __unused
+#define __unused __attribute__((__unused__))
+#endif
+#ifndef __dead2
+#define __dead2 __attribute__((__noreturn__))
+#endif
+#ifndef __unreachable
+#define __unreachable() __builtin_unreachable()
+#endif
+#ifndef __DECONST
+#define __DECONST(type, var) ((type)(uintptr_t)(const void *)(var))
+#endif
+#ifndef roundup2
+#define roundup2(x, y) (((x) + ((y) - 1)) & (~((y) - 1)))
+#endif
+#ifndef __clang__
+#define _Nonnull
+#endif
+
+/* glibc defines this as INT_MAX, which is no good for a buffer size. */
+#undef NL_TEXTMAX
+#define NL_TEXTMAX 2048
+
+/*
+ * With _GNU_SOURCE, glibc's strerror_r() may return a static string without
+ * filling the buffer.  Always fill the buffer, as the XSI version does.
+ */
+static inline int
+compat_strerror_r(int error, char *buf, size_t len)
+{
+	const char *msg;
+
+	if ((msg = strerror_r(error, buf, len)) != buf) {
+		snprintf(buf, len, "%s", msg);
+	}
+	return (0);
+}
+#define strerror_r compat_strerror_r
+
+/*
+ * The jemalloc extensions are only used for alignment, so the flags are simply
+ * the alignment here.
+ */
+#define MALLOCX_ALIGN(a) ((int)(a))
+
+static inline void *
+mallocx(size_t size, int flags)
+{
+	if (flags == 0) {
+		return (malloc(size));
+	}
+	return (aligned_alloc(flags, roundup2(size, flags)));
+}
+
+/*
+ * realloc() may move a block to a less aligned address, and by then the old
+ * block is gone, so an aligned block is allocated first instead.  On failure p
+ * is left intact and NULL is returned, as by rallocx().
+ */
+static inline void *
+rallocx(void *p, size_t size, int flags)
+{
+	void *q;
+
+	if (flags == 0) {
+		return (realloc(p, size));
+	}
+	if ((q = mallocx(size, flags)) == NULL) {
+		return (NULL);
+	}
+	memcpy(q, p, MIN(malloc_usable_size(p), size));
+	free(p);
+	return (q);
+}
+
+/*
+ * fwopen() in terms of fopencookie().
+ */
+struct compat_fwopen {
+	void *cookie;
+	int (*writefn)(void *, const char *, int);
+};
+
+static inline ssize_t
+compat_fwopen_write(void *cookie, const char *buf, size_t size)
+{
+	struct compat_fwopen *c = cookie;
+
+	return (c->writefn(c->cookie, buf, MIN(size, INT_MAX)));
+}
+
+static inline int
+compat_fwopen_close(void *cookie)
+{
+	free(cookie);
+	return (0);
+}
+
+static inline FILE *
+fwopen(void *cookie, int (*writefn)(void *, const char *, int))
+{
+	struct compat_fwopen *c;
+	FILE *f;
+
+	if ((c = malloc(sizeof(*c))) == NULL) {
+		return (NULL);
+	}
+	c->cookie = cookie;
+	c->writefn = writefn;
+	if ((f = fopencookie(c, "w", (cookie_io_functions_t){
+	    .write = compat_fwopen_write,
+	    .close = compat_fwopen_close,
+	})) == NULL) {
+		free(c);
+	}
+	return (f);
+}
+
+/*
+ * arc4random_uniform() first appeared in glibc 2.36.  It is only used to pick
+ * where select starts polling its cases, so before that a per-thread xorshift
+ * generator seeded from the clock is good enough.
+ */
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 36)
+static inline uint32_t
+compat_arc4random_uniform(uint32_t upper)
+{
+	static __thread uint32_t state;
+	struct timespec ts;
+	uint32_t min, r;
+
+	if (upper < 2) {
+		return (0);
+	}
+	if (state == 0) {
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		state = (ts.tv_nsec ^ (uintptr_t)&state) | 1;
+	}
+	/* Reject the values that would bias the result toward 0. */
+	min = -upper % upper;
+	do {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		r = state;
+	} while (r < min);
+	return (r % upper);
+}
+#define arc4random_uniform compat_arc4random_uniform
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sys/param.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ck_cc.h>
+#include <ck_md.h>
+#include <ck_pr.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define COUNTER_METATABLE "counter"
+
+#ifndef COUNTER_MAX_SHARDS
+#define COUNTER_MAX_SHARDS 1024
+#endif
+
+/*
+ * A counter is split into shards, each on its own cache line.  Every thread is
+ * assigned a number the first time it touches any counter, and only adds to the
+ * shard selected by that number, so threads do not contend for cache lines
+ * until there are more threads than shards.  Reading the counter folds the
+ * shards together.
+ */
+struct shard {
+	int64_t value;
+} CK_CC_ALIGN(CK_MD_CACHELINE);
+
+struct rccounter {
+	unsigned int mask; /* number of shards - 1 */
+	refcount refs CK_CC_CACHELINE;
+	struct shard shards[];
+};
+
+static unsigned int counter_threads;
+static __thread unsigned int counter_thread; /* 0 until assigned */
+
+static inline struct shard *
+localshard(struct rccounter *counterp)
+{
+	unsigned int thread;
+
+	if ((thread = counter_thread) == 0) {
+		thread = counter_thread =
+		    ck_pr_faa_uint(&counter_threads, 1) + 1;
+	}
+	return (&counterp->shards[(thread - 1) & counterp->mask]);
+}
+
+static int
+l_ck_counter_new(lua_State *L)
+{
+	struct rccounter *counterp;
+	lua_Integer n;
+	long ncpus;
+	unsigned int nshards;
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	n = luaL_optinteger(L, 1, MAX(1, MIN(ncpus, COUNTER_MAX_SHARDS)));
+	luaL_argcheck(L, n > 0 && n <= COUNTER_MAX_SHARDS, 1,
+	    "bad number of shards");
+	for (nshards = 1; nshards < n; nshards <<= 1)
+		;
+
+	if ((counterp = refcount_alloc(sizeof(*counterp) +
+	    sizeof(*counterp->shards) * nshards)) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	memset(counterp->shards, 0, sizeof(*counterp->shards) * nshards);
+	counterp->mask = nshards - 1;
+	refcount_init(&counterp->refs);
+	return (new(L, counterp, COUNTER_METATABLE));
+}
+
+static int
+l_ck_counter_retain(lua_State *L)
+{
+	struct rccounter *counterp;
+
+	counterp = checklightuserdata(L, 1);
+
+	refcount_retain(&counterp->refs);
+	return (new(L, counterp, COUNTER_METATABLE));
+}
+
+static int
+l_ck_counter_gc(lua_State *L)
+{
+	struct rccounter *counterp;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	if (refcount_release(&counterp->refs)) {
+		free(counterp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_counter_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, COUNTER_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_counter_add(lua_State *L)
+{
+	struct rccounter *counterp;
+	lua_Integer delta;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+	delta = luaL_checkinteger(L, 2);
+
+	ck_pr_add_64((uint64_t *)&localshard(counterp)->value, delta);
+	return (0);
+}
+
+static int
+l_ck_counter_inc(lua_State *L)
+{
+	struct rccounter *counterp;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	ck_pr_inc_64((uint64_t *)&localshard(counterp)->value);
+	return (0);
+}
+
+static int
+l_ck_counter_dec(lua_State *L)
+{
+	struct rccounter *counterp;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	ck_pr_dec_64((uint64_t *)&localshard(counterp)->value);
+	return (0);
+}
+
+/*
+ * The sum is not a snapshot: additions racing with it may or may not be
+ * counted, but none are counted twice.
+ */
+static int
+l_ck_counter_sum(lua_State *L)
+{
+	struct rccounter *counterp;
+	uint64_t sum;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	sum = 0;
+	for (unsigned int i = 0; i <= counterp->mask; i++) {
+		sum += ck_pr_load_64((uint64_t *)&counterp->shards[i].value);
+	}
+	lua_pushinteger(L, (lua_Integer)sum);
+	return (1);
+}
+
+/*
+ * Each shard is swapped with zero, so additions racing with a reset are either
+ * included in the returned sum or left in the counter, never lost.
+ */
+static int
+l_ck_counter_reset(lua_State *L)
+{
+	struct rccounter *counterp;
+	uint64_t sum;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	sum = 0;
+	for (unsigned int i = 0; i <= counterp->mask; i++) {
+		sum += ck_pr_fas_64((uint64_t *)&counterp->shards[i].value, 0);
+	}
+	lua_pushinteger(L, (lua_Integer)sum);
+	return (1);
+}
+
+static int
+l_ck_counter_shards(lua_State *L)
+{
+	struct rccounter *counterp;
+
+	counterp = checkcookie(L, 1, COUNTER_METATABLE);
+
+	lua_pushinteger(L, counterp->mask + 1);
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_counter_funcs[] = {
+	{"new", l_ck_counter_new},
+	{"retain", l_ck_counter_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_counter_meta[] = {
+	{"__gc", l_ck_counter_gc},
+	{"cookie", l_ck_counter_cookie},
+	{"add", l_ck_counter_add},
+	{"inc", l_ck_counter_inc},
+	{"dec", l_ck_counter_dec},
+	{"sum", l_ck_counter_sum},
+	{"reset", l_ck_counter_reset},
+	{"shards", l_ck_counter_shards},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_counter(lua_State *L)
+{
+	luaL_newmetatable(L, COUNTER_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_counter_meta, 0);
+
+	luaL_newlib(L, l_ck_counter_funcs); /* ck.counter */
+	return (1);
+}
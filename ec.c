@@ -5,7 +5,14 @@
  */
 
 #include <sys/types.h>
+#ifdef __FreeBSD__
 #include <sys/umtx.h>
+#else
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <endian.h>
+#include <unistd.h>
+#endif
 #include <assert.h>
 #include <errno.h>
 #include <stdbool.h>
@@ -19,7 +26,10 @@
 #include <lualib.h>
 
 #include "common.h"
+#include "ec.h"
+#include "probes.h"
 #include "refcount.h"
+#include "stats.h"
 
 #define CK_EC32_METATABLE "ck_ec32_t"
 #ifdef CK_F_EC64
@@ -50,11 +60,14 @@ gettime(const struct ck_ec_ops *ops __unused, struct timespec *out)
 	return (clock_gettime(CLOCK_MONOTONIC, out));
 }
 
+#ifdef __FreeBSD__
 static void
 wait32(const struct ck_ec_wait_state *state __unused, const uint32_t *address,
     uint32_t expected, const struct timespec *deadline)
 {
 	assert(state->ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, sleeps);
+	CK_EC_WAIT(__DECONST(void *, address), expected);
 	_umtx_op(__DECONST(uint32_t *, address), UMTX_OP_WAIT_UINT, expected,
 	    (void *)(uintptr_t)sizeof(*deadline),
 	    __DECONST(struct timespec *, deadline));
@@ -65,6 +78,8 @@ wait64(const struct ck_ec_wait_state *state __unused, const uint64_t *address,
     uint64_t expected, const struct timespec *deadline)
 {
 	assert(state->ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, sleeps);
+	CK_EC_WAIT(__DECONST(void *, address), expected);
 	_umtx_op(__DECONST(uint64_t *, address), UMTX_OP_WAIT, expected,
 	    (void *)(uintptr_t)sizeof(*deadline),
 	    __DECONST(struct timespec *, deadline));
@@ -74,6 +89,8 @@ static void
 wake32(const struct ck_ec_ops *ops __unused, const uint32_t *address)
 {
 	assert(ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, wakes);
+	CK_EC_WAKE(__DECONST(void *, address));
 	_umtx_op(__DECONST(uint32_t *, address), UMTX_OP_WAKE, INT_MAX, NULL,
 	    NULL);
 }
@@ -82,11 +99,82 @@ static void
 wake64(const struct ck_ec_ops *ops __unused, const uint64_t *address)
 {
 	assert(ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, wakes);
+	CK_EC_WAKE(__DECONST(void *, address));
 	_umtx_op(__DECONST(uint64_t *, address), UMTX_OP_WAKE, INT_MAX, NULL,
 	    NULL);
 }
+#else
+/*
+ * Linux futexes are only 32 bits, so 64-bit event counts wait on the half that
+ * holds the low bits, which change with every increment.  FUTEX_WAIT_BITSET
+ * takes an absolute CLOCK_MONOTONIC deadline, like ck_ec.
+ */
+static inline void
+futex_wait(const uint32_t *address, uint32_t expected,
+    const struct timespec *deadline)
+{
+	syscall(SYS_futex, address, FUTEX_WAIT_BITSET_PRIVATE, expected,
+	    deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+}
+
+static inline void
+futex_wake(const uint32_t *address)
+{
+	syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL,
+	    0);
+}
+
+static inline const uint32_t *
+low32(const uint64_t *address)
+{
+#if BYTE_ORDER == LITTLE_ENDIAN
+	return ((const uint32_t *)address);
+#else
+	return ((const uint32_t *)address + 1);
+#endif
+}
+
+static void
+wait32(const struct ck_ec_wait_state *state __unused, const uint32_t *address,
+    uint32_t expected, const struct timespec *deadline)
+{
+	assert(state->ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, sleeps);
+	CK_EC_WAIT(__DECONST(void *, address), expected);
+	futex_wait(address, expected, deadline);
+}
+
+static void
+wait64(const struct ck_ec_wait_state *state __unused, const uint64_t *address,
+    uint64_t expected, const struct timespec *deadline)
+{
+	assert(state->ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, sleeps);
+	CK_EC_WAIT(__DECONST(void *, address), expected);
+	futex_wait(low32(address), (uint32_t)expected, deadline);
+}
+
+static void
+wake32(const struct ck_ec_ops *ops __unused, const uint32_t *address)
+{
+	assert(ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, wakes);
+	CK_EC_WAKE(__DECONST(void *, address));
+	futex_wake(address);
+}
+
+static void
+wake64(const struct ck_ec_ops *ops __unused, const uint64_t *address)
+{
+	assert(ops == &system_ec_ops);
+	STATS_TOTAL_INC(ec_system, wakes);
+	CK_EC_WAKE(__DECONST(void *, address));
+	futex_wake(low32(address));
+}
+#endif
 
-static const struct ck_ec_mode ec_mp = {
+const struct ck_ec_mode ec_mp = {
 	.ops = &system_ec_ops,
 	.single_producer = false,
 };
@@ -121,9 +209,22 @@ l_ck_ec_deadline(lua_State *L)
 	return (2);
 }
 
+/* ck_ec waits return -1 when the deadline passes. */
+#define EC_STATS_WAIT(ecp, error) do { \
+	STATS_INC(&(ecp)->stats, waits); \
+	STATS_TOTAL_INC(ec, waits); \
+	if ((error) == -1) { \
+		STATS_INC(&(ecp)->stats, timeouts); \
+		STATS_TOTAL_INC(ec, timeouts); \
+	} \
+} while (0)
+
 struct rcec32 {
 	ck_ec32_t ec;
-	refcount refs;
+#ifdef STATS
+	struct ec_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
 static int
@@ -134,10 +235,11 @@ l_ck_ec32_new(lua_State *L)
 
 	value = luaL_checkinteger(L, 1);
 
-	if ((ecp = malloc(sizeof(*ecp))) == NULL) {
+	if ((ecp = refcount_alloc(sizeof(*ecp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	ck_ec32_init(&ecp->ec, value);
+	STATS_INIT(&ecp->stats);
 	refcount_init(&ecp->refs);
 	return (new(L, ecp, CK_EC32_METATABLE));
 }
@@ -174,6 +276,16 @@ l_ck_ec32_cookie(lua_State *L)
 	return (1);
 }
 
+static int
+l_ck_ec32_stats(lua_State *L)
+{
+	struct rcec32 *ecp __unused;
+
+	ecp = checkcookie(L, 1, CK_EC32_METATABLE);
+
+	return (STATS_PUSH(EC_STATS_LIST, &ecp->stats));
+}
+
 static int
 l_ck_ec32_value(lua_State *L)
 {
@@ -245,6 +357,7 @@ l_ck_ec32_wait(lua_State *L)
 	}
 
 	error = ck_ec32_wait(&ecp->ec, mode, value, deadlinep);
+	EC_STATS_WAIT(ecp, error);
 	lua_pushboolean(L, error == 0);
 	return (1);
 }
@@ -308,6 +421,7 @@ l_ck_ec32_wait_pred(lua_State *L)
 	}
 
 	error = ck_ec32_wait_pred(&ecp->ec, mode, value, ec_pred, L, deadlinep);
+	EC_STATS_WAIT(ecp, error);
 	lua_pushinteger(L, error);
 	return (1);
 }
@@ -315,7 +429,10 @@ l_ck_ec32_wait_pred(lua_State *L)
 #ifdef CK_F_EC64
 struct rcec64 {
 	ck_ec64_t ec;
-	refcount refs;
+#ifdef STATS
+	struct ec_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
 static int
@@ -326,10 +443,11 @@ l_ck_ec64_new(lua_State *L)
 
 	value = luaL_checkinteger(L, 1);
 
-	if ((ecp = malloc(sizeof(*ecp))) == NULL) {
+	if ((ecp = refcount_alloc(sizeof(*ecp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	ck_ec64_init(&ecp->ec, value);
+	STATS_INIT(&ecp->stats);
 	refcount_init(&ecp->refs);
 	return (new(L, ecp, CK_EC64_METATABLE));
 }
@@ -366,6 +484,16 @@ l_ck_ec64_cookie(lua_State *L)
 	return (1);
 }
 
+static int
+l_ck_ec64_stats(lua_State *L)
+{
+	struct rcec64 *ecp __unused;
+
+	ecp = checkcookie(L, 1, CK_EC64_METATABLE);
+
+	return (STATS_PUSH(EC_STATS_LIST, &ecp->stats));
+}
+
 static int
 l_ck_ec64_value(lua_State *L)
 {
@@ -437,6 +565,7 @@ l_ck_ec64_wait(lua_State *L)
 	}
 
 	error = ck_ec64_wait(&ecp->ec, mode, value, deadlinep);
+	EC_STATS_WAIT(ecp, error);
 	lua_pushboolean(L, error == 0);
 	return (1);
 }
@@ -464,6 +593,7 @@ l_ck_ec64_wait_pred(lua_State *L)
 	}
 
 	error = ck_ec64_wait_pred(&ecp->ec, mode, value, ec_pred, L, deadlinep);
+	EC_STATS_WAIT(ecp, error);
 	lua_pushinteger(L, error);
 	return (1);
 }
@@ -489,6 +619,7 @@ static const struct luaL_Reg l_ck_ec32_meta[] = {
 	{"add", l_ck_ec32_add},
 	{"wait", l_ck_ec32_wait},
 	{"wait_pred", l_ck_ec32_wait_pred},
+	{"stats", l_ck_ec32_stats},
 	{NULL, NULL}
 };
 
@@ -508,6 +639,7 @@ static const struct luaL_Reg l_ck_ec64_meta[] = {
 	{"add", l_ck_ec64_add},
 	{"wait", l_ck_ec64_wait},
 	{"wait_pred", l_ck_ec64_wait_pred},
+	{"stats", l_ck_ec64_stats},
 	{NULL, NULL}
 };
 #endif
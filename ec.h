@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <ck_ec.h>
+
+/* Event count mode for use by other modules waiting on embedded event counts. */
+extern const struct ck_ec_mode ec_mp;
@@ -14,17 +14,29 @@
 #include <lualib.h>
 
 #include "common.h"
+#include "latency.h"
+#include "probes.h"
 #include "refcount.h"
 #include "serde.h"
 #include "serdebuf.h"
+#include "stats.h"
 #include "luaerror.h"
 
 #define FIFO_SPSC_METATABLE "fifo.spsc"
 #define FIFO_MPMC_METATABLE "fifo.mpmc"
 
+#define FIFO_STATS_INC(fifop, NAME) do { \
+	STATS_INC(&(fifop)->stats, NAME); \
+	STATS_TOTAL_INC(fifo, NAME); \
+} while (0)
+
 struct rcfifo_spsc {
 	ck_fifo_spsc_t fifo;
-	refcount refs;
+	struct latency *latency;
+#ifdef STATS
+	struct fifo_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
 static int
@@ -32,15 +44,25 @@ l_ck_fifo_spsc_new(lua_State *L)
 {
 	struct rcfifo_spsc *fifop;
 	ck_fifo_spsc_entry_t *stubp;
+	bool latency;
+
+	latency = lua_toboolean(L, 1);
 
-	if ((fifop = malloc(sizeof(*fifop))) == NULL) {
+	if ((fifop = refcount_alloc(sizeof(*fifop))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	if ((stubp = malloc(sizeof(*stubp))) == NULL) {
 		free(fifop);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	fifop->latency = NULL;
+	if (latency && (fifop->latency = latency_alloc()) == NULL) {
+		free(stubp);
+		free(fifop);
+		return (fatal(L, "malloc", ENOMEM));
+	}
 	ck_fifo_spsc_init(&fifop->fifo, stubp);
+	STATS_INIT(&fifop->stats);
 	refcount_init(&fifop->refs);
 	return (new(L, fifop, FIFO_SPSC_METATABLE));
 }
@@ -72,6 +94,7 @@ l_ck_fifo_spsc_gc(lua_State *L)
 			free(garbage);
 			garbage = next;
 		}
+		free(fifop->latency);
 		free(fifop);
 	}
 	return (0);
@@ -85,6 +108,26 @@ l_ck_fifo_spsc_cookie(lua_State *L)
 	return (1);
 }
 
+static int
+l_ck_fifo_spsc_stats(lua_State *L)
+{
+	struct rcfifo_spsc *fifop __unused;
+
+	fifop = checkcookie(L, 1, FIFO_SPSC_METATABLE);
+
+	return (STATS_PUSH(FIFO_STATS_LIST, &fifop->stats));
+}
+
+static int
+l_ck_fifo_spsc_latency(lua_State *L)
+{
+	struct rcfifo_spsc *fifop;
+
+	fifop = checkcookie(L, 1, FIFO_SPSC_METATABLE);
+
+	return (latency_push(L, fifop->latency));
+}
+
 static int
 l_ck_fifo_spsc_enqueue(lua_State *L)
 {
@@ -92,6 +135,7 @@ l_ck_fifo_spsc_enqueue(lua_State *L)
 	struct rcfifo_spsc *fifop;
 	ck_fifo_spsc_entry_t *entry;
 	void *v;
+	size_t len;
 	serde_type_code type;
 	int error;
 
@@ -102,14 +146,15 @@ l_ck_fifo_spsc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(fifop->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
@@ -118,7 +163,10 @@ l_ck_fifo_spsc_enqueue(lua_State *L)
 		free(v);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	latency_stamp(fifop->latency, v);
 	ck_fifo_spsc_enqueue(&fifop->fifo, entry, v);
+	FIFO_STATS_INC(fifop, enqueues);
+	CK_FIFO_ENQUEUE(fifop, len, type, true);
 	return (0);
 }
 
@@ -127,16 +175,23 @@ l_ck_fifo_spsc_dequeue(lua_State *L)
 {
 	struct rcfifo_spsc *fifop;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	fifop = checkcookie(L, 1, FIFO_SPSC_METATABLE);
 
 	if (!ck_fifo_spsc_dequeue(&fifop->fifo, &v)) {
+		FIFO_STATS_INC(fifop, dequeue_failures);
+		CK_FIFO_DEQUEUE(fifop, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	FIFO_STATS_INC(fifop, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(fifop->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_FIFO_DEQUEUE(fifop, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -220,7 +275,11 @@ l_ck_fifo_spsc_dequeue_unlock(lua_State *L)
 
 struct rcfifo_mpmc {
 	ck_fifo_mpmc_t fifo;
-	refcount refs;
+	struct latency *latency;
+#ifdef STATS
+	struct fifo_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
 static int
@@ -228,15 +287,25 @@ l_ck_fifo_mpmc_new(lua_State *L)
 {
 	struct rcfifo_mpmc *fifop;
 	ck_fifo_mpmc_entry_t *stubp;
+	bool latency;
 
-	if ((fifop = malloc(sizeof(*fifop))) == NULL) {
+	latency = lua_toboolean(L, 1);
+
+	if ((fifop = refcount_alloc(sizeof(*fifop))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	if ((stubp = malloc(sizeof(*stubp))) == NULL) {
 		free(fifop);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	fifop->latency = NULL;
+	if (latency && (fifop->latency = latency_alloc()) == NULL) {
+		free(stubp);
+		free(fifop);
+		return (fatal(L, "malloc", ENOMEM));
+	}
 	ck_fifo_mpmc_init(&fifop->fifo, stubp);
+	STATS_INIT(&fifop->stats);
 	refcount_init(&fifop->refs);
 	return (new(L, fifop, FIFO_MPMC_METATABLE));
 }
@@ -268,6 +337,7 @@ l_ck_fifo_mpmc_gc(lua_State *L)
 			free(garbage);
 			garbage = next;
 		}
+		free(fifop->latency);
 		free(fifop);
 	}
 	return (0);
@@ -281,6 +351,26 @@ l_ck_fifo_mpmc_cookie(lua_State *L)
 	return (1);
 }
 
+static int
+l_ck_fifo_mpmc_stats(lua_State *L)
+{
+	struct rcfifo_mpmc *fifop __unused;
+
+	fifop = checkcookie(L, 1, FIFO_MPMC_METATABLE);
+
+	return (STATS_PUSH(FIFO_STATS_LIST, &fifop->stats));
+}
+
+static int
+l_ck_fifo_mpmc_latency(lua_State *L)
+{
+	struct rcfifo_mpmc *fifop;
+
+	fifop = checkcookie(L, 1, FIFO_MPMC_METATABLE);
+
+	return (latency_push(L, fifop->latency));
+}
+
 static int
 l_ck_fifo_mpmc_enqueue(lua_State *L)
 {
@@ -288,6 +378,7 @@ l_ck_fifo_mpmc_enqueue(lua_State *L)
 	struct rcfifo_mpmc *fifop;
 	ck_fifo_mpmc_entry_t *entry;
 	void *v;
+	size_t len;
 	serde_type_code type;
 	int error;
 
@@ -298,14 +389,15 @@ l_ck_fifo_mpmc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(fifop->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
@@ -313,7 +405,10 @@ l_ck_fifo_mpmc_enqueue(lua_State *L)
 		free(v);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	latency_stamp(fifop->latency, v);
 	ck_fifo_mpmc_enqueue(&fifop->fifo, entry, v);
+	FIFO_STATS_INC(fifop, enqueues);
+	CK_FIFO_ENQUEUE(fifop, len, type, true);
 	return (0);
 }
 
@@ -324,6 +419,7 @@ l_ck_fifo_mpmc_tryenqueue(lua_State *L)
 	struct rcfifo_mpmc *fifop;
 	ck_fifo_mpmc_entry_t *entry;
 	void *v;
+	size_t len;
 	serde_type_code type;
 	bool enqueued;
 	int error;
@@ -335,14 +431,15 @@ l_ck_fifo_mpmc_tryenqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(fifop->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
@@ -350,9 +447,14 @@ l_ck_fifo_mpmc_tryenqueue(lua_State *L)
 		free(v);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	latency_stamp(fifop->latency, v);
 	if (!(enqueued = ck_fifo_mpmc_tryenqueue(&fifop->fifo, entry, v))) {
+		FIFO_STATS_INC(fifop, enqueue_failures);
 		free(v); /* oof */
+	} else {
+		FIFO_STATS_INC(fifop, enqueues);
 	}
+	CK_FIFO_ENQUEUE(fifop, len, type, enqueued);
 	lua_pushboolean(L, enqueued);
 	return (1);
 }
@@ -363,11 +465,14 @@ l_ck_fifo_mpmc_dequeue(lua_State *L)
 	struct rcfifo_mpmc *fifop;
 	ck_fifo_mpmc_entry_t *garbage, *next;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	fifop = checkcookie(L, 1, FIFO_MPMC_METATABLE);
 
 	if (!ck_fifo_mpmc_dequeue(&fifop->fifo, &v, &garbage)) {
+		FIFO_STATS_INC(fifop, dequeue_failures);
+		CK_FIFO_DEQUEUE(fifop, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
@@ -376,8 +481,12 @@ l_ck_fifo_mpmc_dequeue(lua_State *L)
 		free(garbage);
 		garbage = next;
 	}
+	FIFO_STATS_INC(fifop, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(fifop->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_FIFO_DEQUEUE(fifop, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -388,11 +497,14 @@ l_ck_fifo_mpmc_trydequeue(lua_State *L)
 	struct rcfifo_mpmc *fifop;
 	ck_fifo_mpmc_entry_t *garbage, *next;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	fifop = checkcookie(L, 1, FIFO_MPMC_METATABLE);
 
 	if (!ck_fifo_mpmc_trydequeue(&fifop->fifo, &v, &garbage)) {
+		FIFO_STATS_INC(fifop, dequeue_failures);
+		CK_FIFO_DEQUEUE(fifop, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
@@ -401,8 +513,12 @@ l_ck_fifo_mpmc_trydequeue(lua_State *L)
 		free(garbage);
 		garbage = next;
 	}
+	FIFO_STATS_INC(fifop, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(fifop->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_FIFO_DEQUEUE(fifop, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -416,6 +532,8 @@ static const struct luaL_Reg l_ck_fifo_spsc_funcs[] = {
 static const struct luaL_Reg l_ck_fifo_spsc_meta[] = {
 	{"__gc", l_ck_fifo_spsc_gc},
 	{"cookie", l_ck_fifo_spsc_cookie},
+	{"latency", l_ck_fifo_spsc_latency},
+	{"stats", l_ck_fifo_spsc_stats},
 	{"enqueue", l_ck_fifo_spsc_enqueue},
 	{"dequeue", l_ck_fifo_spsc_dequeue},
 	{"isempty", l_ck_fifo_spsc_isempty},
@@ -438,6 +556,8 @@ static const struct luaL_Reg l_ck_fifo_mpmc_funcs[] = {
 static const struct luaL_Reg l_ck_fifo_mpmc_meta[] = {
 	{"__gc", l_ck_fifo_mpmc_gc},
 	{"cookie", l_ck_fifo_mpmc_cookie},
+	{"latency", l_ck_fifo_mpmc_latency},
+	{"stats", l_ck_fifo_mpmc_stats},
 	{"enqueue", l_ck_fifo_mpmc_enqueue},
 	{"tryenqueue", l_ck_fifo_mpmc_tryenqueue},
 	{"dequeue", l_ck_fifo_mpmc_dequeue},
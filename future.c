@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ck_ec.h>
+#include <ck_pr.h>
+#include <ck_stack.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "ec.h"
+#include "future.h"
+#include "refcount.h"
+#include "serde.h"
+#include "serdebuf.h"
+#include "luaerror.h"
+
+#define FUTURE_METATABLE "future"
+
+/*
+ * The outcome of a future is serialized as a boolean indicating success
+ * followed by a list of either the results or the error.  If even an error
+ * message cannot be serialized, this stands in for the outcome.
+ */
+static char future_enomem;
+
+/*
+ * A continuation registered by :andthen() is a function to be called with the
+ * results of the future it is registered on, and the future for the outcome of
+ * that call.  Continuations are run by whichever thread sets the outcome, or
+ * by the thread registering the continuation if the outcome was already set.
+ */
+struct continuation {
+	ck_stack_entry_t entry;
+	void *fn; /* serialized */
+	struct rcfuture *next;
+};
+
+CK_STACK_CONTAINER(struct continuation, entry, continuation_container)
+
+struct rcfuture *
+future_new(void)
+{
+	struct rcfuture *futurep;
+
+	if ((futurep = refcount_alloc(sizeof(*futurep))) == NULL) {
+		return (NULL);
+	}
+	futurep->outcome = NULL;
+	ck_ec32_init(&futurep->ec, 0);
+	ck_stack_init(&futurep->continuations);
+	refcount_init(&futurep->refs);
+	return (futurep);
+}
+
+void
+future_release(struct rcfuture *futurep)
+{
+	if (refcount_release(&futurep->refs)) {
+		ck_stack_entry_t *garbage, *next;
+		struct continuation *c;
+
+		/* Continuations of a future never resolved are never run. */
+		garbage = ck_stack_batch_pop_upmc(&futurep->continuations);
+		while (garbage != NULL) {
+			next = CK_STACK_NEXT(garbage);
+			c = continuation_container(garbage);
+			free(c->fn);
+			future_release(c->next);
+			free(c);
+			garbage = next;
+		}
+		if (futurep->outcome != &future_enomem) {
+			free(futurep->outcome);
+		}
+		free(futurep);
+	}
+}
+
+/*
+ * Push a new reference to the future, taking ownership of a reference the
+ * caller already holds.
+ */
+int
+future_push(lua_State *L, struct rcfuture *futurep)
+{
+	return (new(L, futurep, FUTURE_METATABLE));
+}
+
+static inline int
+serializeoutcome(lua_State *L, int idx, int n, void **outcomep)
+{
+	struct serdebuf sb;
+	serde_type_code type;
+	int error;
+
+	/* The boolean at idx is followed by the n values of the outcome. */
+	if ((error = serdebuf_init(L, idx, &sb)) != 0) {
+		return (error);
+	}
+	type = SERDE_BOOLEAN;
+	if ((error = serdebuf_serialize(L, idx, &sb, &type)) != 0 ||
+	    (error = serdebuf_serialize_list(L, idx + 1, n, &sb)) != 0) {
+		serdebuf_destroy(&sb);
+		return (error);
+	}
+	if ((*outcomep = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		return (ENOMEM);
+	}
+	return (0);
+}
+
+/*
+ * Push the values of an outcome and return how many there are, setting *okp to
+ * indicate whether they are results or an error.  Returns -1 with an error on
+ * top of the stack if the outcome could not be loaded.
+ */
+static inline int
+pushoutcome(lua_State *L, const void *outcome, bool *okp)
+{
+	const void *p;
+	int n;
+
+	if (outcome == &future_enomem) {
+		*okp = false;
+		lua_pushstring(L, strerror(ENOMEM));
+		return (1);
+	}
+	if ((p = loadshared(L, outcome)) == NULL) {
+		return (-1);
+	}
+	*okp = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	if (loadsharedlist(L, p, &n) == NULL) {
+		return (-1);
+	}
+	return (n);
+}
+
+static void
+runcontinuation(lua_State *L, struct continuation *c, const void *outcome)
+{
+	int top, n, status;
+	bool ok;
+
+	top = lua_gettop(L);
+	if (loadshared(L, c->fn) == NULL ||
+	    (n = pushoutcome(L, outcome, &ok)) < 0) {
+		status = LUA_ERRRUN;
+	} else if (!ok) {
+		/* Pass the error along without calling the function. */
+		status = LUA_ERRRUN;
+	} else {
+		status = lua_pcall(L, n, LUA_MULTRET, 0);
+	}
+	if (status == LUA_OK) {
+		future_resolve(L, c->next, true, lua_gettop(L) - top);
+	} else {
+		/* Keep only the error. */
+		lua_insert(L, top + 1);
+		lua_settop(L, top + 1);
+		future_resolve(L, c->next, false, 1);
+	}
+	lua_settop(L, top);
+	free(c->fn);
+	future_release(c->next);
+	free(c);
+}
+
+/*
+ * Run any continuations registered on a resolved future, in the order they
+ * were registered.  Both the thread resolving the future and a thread
+ * registering a continuation after the future was resolved can get here, but
+ * each continuation is taken off the stack by exactly one of them.
+ */
+static void
+runcontinuations(lua_State *L, struct rcfuture *futurep)
+{
+	ck_stack_entry_t *entry, *next, *list;
+	const void *outcome;
+
+	outcome = ck_pr_load_ptr(&futurep->outcome);
+	ck_pr_fence_load();
+	entry = ck_stack_batch_pop_upmc(&futurep->continuations);
+	for (list = NULL; entry != NULL; entry = next) {
+		next = CK_STACK_NEXT(entry);
+		entry->next = list;
+		list = entry;
+	}
+	for (entry = list; entry != NULL; entry = next) {
+		next = CK_STACK_NEXT(entry);
+		runcontinuation(L, continuation_container(entry), outcome);
+	}
+}
+
+static bool
+publish(lua_State *L, struct rcfuture *futurep, void *outcome)
+{
+	ck_pr_fence_store();
+	if (!ck_pr_cas_ptr(&futurep->outcome, NULL, outcome)) {
+		if (outcome != &future_enomem) {
+			free(outcome);
+		}
+		return (false);
+	}
+	ck_ec32_inc(&futurep->ec, &ec_mp);
+	ck_pr_fence_memory();
+	runcontinuations(L, futurep);
+	return (true);
+}
+
+/*
+ * Resolve a future with the n values on top of the stack, which are popped.
+ * The values are the results of a computation if ok is true, otherwise they
+ * are a single error value.  Values that cannot be serialized resolve the
+ * future with an error instead, so waiters are always woken.  Returns false if
+ * the future had already been resolved.
+ */
+bool
+future_resolve(lua_State *L, struct rcfuture *futurep, bool ok, int n)
+{
+	void *outcome;
+	int base, error;
+
+	base = lua_gettop(L) - n;
+	lua_pushboolean(L, ok);
+	lua_insert(L, base + 1);
+	if ((error = serializeoutcome(L, base + 1, n, &outcome)) != 0) {
+		const char *msg;
+
+		if (error < 0) {
+			msg = luaL_tolstring(L, -1, NULL);
+		} else {
+			msg = strerror(error);
+		}
+		lua_pushfstring(L, "unable to serialize outcome: %s", msg);
+		lua_insert(L, base + 2);
+		lua_settop(L, base + 2);
+		lua_pushboolean(L, false);
+		lua_replace(L, base + 1);
+		if (serializeoutcome(L, base + 1, 1, &outcome) != 0) {
+			outcome = &future_enomem;
+		}
+	}
+	lua_settop(L, base);
+	return (publish(L, futurep, outcome));
+}
+
+/*
+ * Wait for the outcome of a future until the deadline, if any.  Returns NULL if
+ * the deadline passed first.
+ */
+static inline void *
+waitfuture(struct rcfuture *futurep, const struct timespec *deadline)
+{
+	void *outcome;
+
+	while ((outcome = ck_pr_load_ptr(&futurep->outcome)) == NULL) {
+		if (ck_ec32_wait(&futurep->ec, &ec_mp, 0, deadline) != 0) {
+			outcome = ck_pr_load_ptr(&futurep->outcome);
+			break;
+		}
+	}
+	ck_pr_fence_load();
+	return (outcome);
+}
+
+static int
+l_ck_future_new(lua_State *L)
+{
+	struct rcfuture *futurep;
+
+	if ((futurep = future_new()) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	return (future_push(L, futurep));
+}
+
+static int
+l_ck_future_retain(lua_State *L)
+{
+	struct rcfuture *futurep;
+
+	futurep = checklightuserdata(L, 1);
+
+	refcount_retain(&futurep->refs);
+	return (new(L, futurep, FUTURE_METATABLE));
+}
+
+static int
+l_ck_future_gc(lua_State *L)
+{
+	struct rcfuture *futurep;
+
+	futurep = checkcookie(L, 1, FUTURE_METATABLE);
+
+	future_release(futurep);
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_future_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, FUTURE_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_future_ready(lua_State *L)
+{
+	struct rcfuture *futurep;
+
+	futurep = checkcookie(L, 1, FUTURE_METATABLE);
+
+	lua_pushboolean(L, ck_pr_load_ptr(&futurep->outcome) != NULL);
+	return (1);
+}
+
+static int
+l_ck_future_set(lua_State *L)
+{
+	struct rcfuture *futurep;
+	void *outcome;
+	int error;
+
+	futurep = checkcookie(L, 1, FUTURE_METATABLE);
+
+	lua_pushboolean(L, true);
+	lua_insert(L, 2);
+	if ((error = serializeoutcome(L, 2, lua_gettop(L) - 2, &outcome)) !=
+	    0) {
+		if (error < 0) {
+			return (lua_error(L));
+		}
+		return (fatal(L, "serializeoutcome", error));
+	}
+	lua_settop(L, 1);
+	lua_pushboolean(L, publish(L, futurep, outcome));
+	return (1);
+}
+
+static int
+l_ck_future_get(lua_State *L)
+{
+	struct timespec deadline, timeout, *deadlinep;
+	struct rcfuture *futurep;
+	const void *outcome;
+	int n;
+	bool ok;
+
+	futurep = checkcookie(L, 1, FUTURE_METATABLE);
+	if (!lua_isnoneornil(L, 2)) {
+		timeout.tv_sec = luaL_checkinteger(L, 2);
+		timeout.tv_nsec = luaL_optinteger(L, 3, 0);
+		if (ck_ec_deadline(&deadline, &ec_mp, &timeout) == -1) {
+			return (fail(L, errno));
+		}
+		deadlinep = &deadline;
+	} else {
+		deadlinep = NULL;
+	}
+
+	lua_settop(L, 1);
+	if ((outcome = waitfuture(futurep, deadlinep)) == NULL) {
+		return (fail(L, ETIMEDOUT));
+	}
+	if ((n = pushoutcome(L, outcome, &ok)) < 0 || !ok) {
+		return (lua_error(L));
+	}
+	return (n);
+}
+
+static int
+l_ck_future_andthen(lua_State *L)
+{
+	struct rcfuture *futurep, *nextp;
+	struct continuation *c;
+	int error;
+
+	futurep = checkcookie(L, 1, FUTURE_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	if ((c = malloc(sizeof(*c))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	if ((error = serdebuf_serialize_value(L, 2, &c->fn)) != 0) {
+		free(c);
+		if (error < 0) {
+			return (lua_error(L));
+		}
+		return (fatal(L, "serdebuf_serialize_value", error));
+	}
+	if ((nextp = future_new()) == NULL) {
+		free(c->fn);
+		free(c);
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	lua_settop(L, 1);
+	future_push(L, nextp);
+	refcount_retain(&nextp->refs);
+	c->next = nextp;
+	ck_stack_push_upmc(&futurep->continuations, &c->entry);
+	ck_pr_fence_memory();
+	if (ck_pr_load_ptr(&futurep->outcome) != NULL) {
+		runcontinuations(L, futurep);
+	}
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_future_funcs[] = {
+	{"new", l_ck_future_new},
+	{"retain", l_ck_future_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_future_meta[] = {
+	{"__gc", l_ck_future_gc},
+	{"cookie", l_ck_future_cookie},
+	{"ready", l_ck_future_ready},
+	{"set", l_ck_future_set},
+	{"get", l_ck_future_get},
+	{"andthen", l_ck_future_andthen},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_future(lua_State *L)
+{
+	luaL_newmetatable(L, FUTURE_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_future_meta, 0);
+
+	luaL_newlib(L, l_ck_future_funcs); /* ck.future */
+	return (1);
+}
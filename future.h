@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include <ck_ec.h>
+#include <ck_stack.h>
+
+#include <lua.h>
+
+#include "refcount.h"
+
+struct rcfuture {
+	void *outcome; /* serialized once by future_resolve() */
+	ck_ec32_t ec; /* incremented when the outcome is set */
+	ck_stack_t continuations; /* run once the outcome is set */
+	refcount refs CK_CC_CACHELINE;
+};
+
+struct rcfuture *future_new(void);
+void future_release(struct rcfuture *futurep);
+int future_push(lua_State *L, struct rcfuture *futurep);
+bool future_resolve(lua_State *L, struct rcfuture *futurep, bool ok, int n);
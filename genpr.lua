@@ -0,0 +1,364 @@
+-- Copyright (c) 2026 Ryan Moeller
+-- SPDX-License-Identifier: BSD-2-Clause
+
+-- Generate pr.h, the tables of Concurrency Kit atomic operations and types the
+-- bindings are built from:
+--
+--	flua genpr.lua > pr.h
+--
+-- Every operation is paired with every type, and each pair is enabled by the
+-- feature test macro ck_pr.h defines when the machine supports it, so the
+-- bindings get whatever Concurrency Kit provides.  To find features these
+-- tables do not cover, give the paths of CK's feature headers as arguments:
+--
+--	flua genpr.lua /usr/local/include/gcc/x86_64/ck_f_pr.h > pr.h
+--
+-- and any CK_F_PR_* macro not generated is listed on stderr.
+
+-- Operations, keyed by F..FV.
+local ops <const> = {
+	{F='ADD',   FV='',       OP='add',   VARIANT='',         CLASS='BINARY_ARITHMETIC'},
+	{F='AND',   FV='',       OP='and',   VARIANT='',         CLASS='BINARY_BITWISE'},
+	{F='BTC',   FV='',       OP='btc',   VARIANT='',         CLASS='BIT_RMW'},
+	{F='BTR',   FV='',       OP='btr',   VARIANT='',         CLASS='BIT_RMW'},
+	{F='BTS',   FV='',       OP='bts',   VARIANT='',         CLASS='BIT_RMW'},
+	{F='CAS',   FV='',       OP='cas',   VARIANT='',         CLASS='TERNARY_CAS'},
+	{F='CAS',   FV='_VALUE', OP='cas',   VARIANT='_value',   CLASS='TERNARY_CAS_VALUE'},
+	{F='DEC',   FV='',       OP='dec',   VARIANT='',         CLASS='UNARY_ARITHMETIC'},
+	{F='DEC',   FV='_ZERO',  OP='dec',   VARIANT='_is_zero', CLASS='UNARY_ARITHMETIC_Z'},
+	{F='FAA',   FV='',       OP='faa',   VARIANT='',         CLASS='BINARY_FAA'},
+	{F='FAS',   FV='',       OP='fas',   VARIANT='',         CLASS='BINARY_FAS'},
+	{F='INC',   FV='',       OP='inc',   VARIANT='',         CLASS='UNARY_ARITHMETIC'},
+	{F='INC',   FV='_ZERO',  OP='inc',   VARIANT='_is_zero', CLASS='UNARY_ARITHMETIC_Z'},
+	{F='LOAD',  FV='',       OP='load',  VARIANT='',         CLASS='UNARY_LOAD'},
+	{F='NEG',   FV='',       OP='neg',   VARIANT='',         CLASS='UNARY_ARITHMETIC'},
+	{F='NEG',   FV='_ZERO',  OP='neg',   VARIANT='_is_zero', CLASS='UNARY_ARITHMETIC_Z'},
+	{F='NOT',   FV='',       OP='not',   VARIANT='',         CLASS='UNARY_BITWISE'},
+	{F='OR',    FV='',       OP='or',    VARIANT='',         CLASS='BINARY_BITWISE'},
+	{F='STORE', FV='',       OP='store', VARIANT='',         CLASS='UNARY_STORE'},
+	{F='SUB',   FV='',       OP='sub',   VARIANT='',         CLASS='BINARY_ARITHMETIC'},
+	{F='XOR',   FV='',       OP='xor',   VARIANT='',         CLASS='BINARY_BITWISE'},
+}
+
+-- Multi-word operations on 128 bits.
+local ops128 <const> = {
+	{F='CAS',  FV='',       OP='cas',  VARIANT='',       CLASS='TERNARY_CAS'},
+	{F='CAS',  FV='_VALUE', OP='cas',  VARIANT='_value', CLASS='TERNARY_CAS_VALUE'},
+	{F='LOAD', FV='',       OP='load', VARIANT='',       CLASS='UNARY_LOAD'},
+}
+
+-- Types, with the number N of components in 128 bits for types that have a
+-- ck.shared.pr.md128 view.
+local types <const> = {
+	{FT='8',      CKT='8',      CT='uint8_t',      DT='uint8_t',      N=16},
+	{FT='16',     CKT='16',     CT='uint16_t',     DT='uint16_t',     N=8},
+	{FT='32',     CKT='32',     CT='uint32_t',     DT='uint32_t',     N=4},
+	{FT='64',     CKT='64',     CT='uint64_t',     DT='uint64_t',     N=2},
+	{FT='CHAR',   CKT='char',   CT='char',         DT='char',         N=16},
+	{FT='DOUBLE', CKT='double', CT='double',       DT='double',       N=2},
+	{FT='INT',    CKT='int',    CT='int',          DT='int',          N=4},
+	{FT='PTR',    CKT='ptr',    CT='void *',       DT='uintptr_t',    N=2},
+	{FT='SHORT',  CKT='short',  CT='short',        DT='short'},
+	{FT='UINT',   CKT='uint',   CT='unsigned int', DT='unsigned int', N=4},
+}
+
+local lines <const> = {}
+local generated <const> = {}
+
+local function emit(s)
+	table.insert(lines, s or '')
+end
+
+local function key(o)
+	return o.F .. o.FV
+end
+
+-- Join the cells of each row, padding each column to its widest cell.
+local function columns(rows)
+	local widths = {}
+	for _, row in ipairs(rows) do
+		for i = 1, #row - 1 do
+			widths[i] = math.max(widths[i] or 0, #row[i])
+		end
+	end
+	local result = {}
+	for _, row in ipairs(rows) do
+		local cells = {}
+		for i, cell in ipairs(row) do
+			cells[i] = i < #row and cell .. (' '):rep(widths[i] - #cell) or
+			    cell
+		end
+		table.insert(result, table.concat(cells, ' '))
+	end
+	return result
+end
+
+-- The X(...) invocation of each operation, keyed by F..FV.
+local function invocations(list, n)
+	local rows = {}
+	for _, o in ipairs(list) do
+		local row = {'X(' .. o.F .. ',', o.FV .. ','}
+		if n then
+			table.insert(row, n .. ',')
+		end
+		table.insert(row, o.OP .. ',')
+		table.insert(row, o.VARIANT .. ',')
+		table.insert(row, o.CLASS .. ',')
+		table.insert(row, '__VA_ARGS__)')
+		table.insert(rows, row)
+	end
+	local result = {}
+	for i, line in ipairs(columns(rows)) do
+		result[key(list[i])] = line
+	end
+	return result
+end
+
+local function xlist(name, items)
+	emit('#define ' .. name .. '(X, ...) \\')
+	for i, item in ipairs(items) do
+		emit('\tX(' .. item .. ', __VA_ARGS__)' ..
+		    (i < #items and ' \\' or ''))
+	end
+end
+
+local function feature(name, macro, implemented, unimplemented)
+	generated['CK_F_PR_' .. name] = true
+	emit('#ifdef CK_F_PR_' .. name)
+	emit('#define ' .. macro .. implemented)
+	emit('#else')
+	emit('#define ' .. macro .. unimplemented)
+	emit('#endif')
+	emit()
+end
+
+emit([[
+/*
+ * Copyright (c) 2025 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+/* Generated by genpr.lua, do not edit. */
+
+#pragma once
+
+#include <ck_pr.h>
+
+/*
+ * Legend of Field Identifiers
+ *
+ * Feature Names - uppercase identifiers as seen in feature test macros
+ *   F: Feature (ADD, CAS, ...)
+ *   FV: Feature Variant (_VALUE, _ZERO)
+ *
+ * Function Names - lowercase identifiers as seen in function names
+ *   OP: Operation (add, cas, ...)
+ *   VARIANT: Operation Variant (_value, _is_zero)
+ *
+ * Type Names - identifiers as seen in feature test macros and function names
+ *   FT: Feature Type (uppercase name)
+ *   CKT: Concurrency Kit Type (lowercase name)
+ *   CT: C Type (of value)
+ *   DT: Delta Type (C type of delta operand)
+ *
+ * Metadata - additional information about an operation or type
+ *   CLASS: Classification (based on operation inputs and outputs)
+ *   N: Number (of components of this type in multi-word operations)
+ *
+ * Every operation is listed for every type.  PR_OP_<F><FV>_<FT> expands to
+ * nothing where Concurrency Kit does not implement the operation for the type
+ * on this machine.  It does not refer to PR_OP_<F><FV>, so it may be used in
+ * an expansion of PR_OPS_LIST.
+ */
+]])
+
+local x <const> = invocations(ops)
+emit('/*        F      FV      OP     VARIANT   CLASS               ... */')
+for _, o in ipairs(ops) do
+	emit('#define PR_OP_' .. key(o) .. '(X, ...) \\')
+	emit('\t' .. x[key(o)])
+end
+emit('#define PR_OP_UNIMPLEMENTED(X, ...)')
+emit()
+
+for _, o in ipairs(ops) do
+	for _, t in ipairs(types) do
+		feature(o.F .. '_' .. t.FT .. o.FV,
+		    'PR_OP_' .. key(o) .. '_' .. t.FT .. '(X, ...)',
+		    ' \\\n\t' .. x[key(o)],
+		    ' PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)')
+	end
+end
+
+do
+	local keys = {}
+	for _, o in ipairs(ops) do
+		table.insert(keys, key(o))
+	end
+	xlist('PR_OPS_KEYS', keys)
+end
+emit([[
+
+#define PR_OP_EXPANDER(OP, X, ...) \
+	PR_OP_##OP(X, __VA_ARGS__)
+
+#define PR_OPS_LIST(X, ...) \
+	PR_OPS_KEYS(PR_OP_EXPANDER, X, __VA_ARGS__)
+]])
+
+do
+	local rows = {}
+	for _, t in ipairs(types) do
+		table.insert(rows,
+		    {'#define', 'PR_' .. t.FT .. '_OPS_LIST', 'PR_OPS_KEYS'})
+	end
+	for _, line in ipairs(columns(rows)) do
+		emit(line)
+	end
+	emit()
+
+	rows = {}
+	for _, t in ipairs(types) do
+		table.insert(rows, {'#define PR_' .. t.FT .. '_T(X, ...)',
+		    'X(' .. t.CKT .. ',', t.CT .. ',', t.DT .. ',', '__VA_ARGS__)'})
+	end
+	emit('/*         FT                 CKT     CT            DT            ... */')
+	for _, line in ipairs(columns(rows)) do
+		emit(line)
+	end
+	emit()
+
+	rows = {}
+	for i, t in ipairs(types) do
+		table.insert(rows, {'\tX(' .. t.FT .. ',',
+		    '__VA_ARGS__)' .. (i < #types and ' \\' or '')})
+	end
+	emit('/*        FT      ... */')
+	emit('#define PR_F_TYPES_LIST(X, ...) \\')
+	for _, line in ipairs(columns(rows)) do
+		emit(line)
+	end
+end
+
+emit([[
+
+#define PR_T_EXPANDER(FT, X, ...) \
+	PR_##FT##_T(X, FT, __VA_ARGS__)
+
+#define PR_TYPES_LIST(X, ...) \
+	PR_F_TYPES_LIST(PR_T_EXPANDER, X, __VA_ARGS__)
+]])
+
+local types128 <const> = {}
+local ns <const> = {}
+local seen <const> = {}
+for _, t in ipairs(types) do
+	if t.N then
+		table.insert(types128, t)
+		if not seen[t.N] then
+			seen[t.N] = true
+			table.insert(ns, t.N)
+		end
+	end
+end
+table.sort(ns)
+
+local x128 <const> = invocations(ops128, 'N')
+emit([[
+/*
+ * 128-bit ops
+ *
+ *        F     FV      N  OP    VARIANT CLASS             ...
+ */]])
+for _, o in ipairs(ops128) do
+	emit('#define PR128_OP_' .. key(o) .. '_N(X, N, ...) \\')
+	emit('\t' .. x128[key(o)])
+end
+for _, n in ipairs(ns) do
+	for _, o in ipairs(ops128) do
+		emit(('#define PR128_OP_%s_%d(X, ...) \\'):format(key(o), n))
+		emit(('\tPR128_OP_%s_N(X, %d, __VA_ARGS__)'):format(key(o), n))
+	end
+end
+emit('#define PR128_OP_UNIMPLEMENTED(X, ...)')
+emit()
+
+for _, o in ipairs(ops128) do
+	for _, t in ipairs(types128) do
+		feature(('%s_%s_%d%s'):format(o.F, t.FT, t.N, o.FV),
+		    ('PR128_OP_%s_%d_%s'):format(key(o), t.N, t.FT),
+		    (' PR128_OP_%s_%d'):format(key(o), t.N),
+		    ' PR128_OP_UNIMPLEMENTED')
+	end
+end
+
+for _, n in ipairs(ns) do
+	local keys = {}
+	for _, o in ipairs(ops128) do
+		table.insert(keys, key(o) .. '_' .. n)
+	end
+	xlist('PR128_OPS_' .. n, keys)
+	emit()
+end
+
+emit([[
+#define PR128_OP_EXPANDER(OP, X, ...) \
+	PR128_OP_##OP(X, __VA_ARGS__)
+]])
+emit('#define PR128_OPS_LIST(X, ...) \\')
+for i, n in ipairs(ns) do
+	emit(('\tPR128_OPS_%d(PR128_OP_EXPANDER, X, __VA_ARGS__)'):format(n) ..
+	    (i < #ns and ' \\' or ''))
+end
+emit()
+
+do
+	local rows = {}
+	for i, t in ipairs(types128) do
+		table.insert(rows, {'\tX(' .. t.FT .. ',', t.N .. ',',
+		    '__VA_ARGS__)' .. (i < #types128 and ' \\' or '')})
+	end
+	emit('/*        FT      N   ... */')
+	emit('#define PR128_F_TYPES_LIST(X, ...) \\')
+	for _, line in ipairs(columns(rows)) do
+		emit(line)
+	end
+end
+
+emit([[
+
+#define PR128_T_EXPANDER(FT, N, X, ...) \
+	PR_##FT##_T(X, FT, N, __VA_ARGS__)
+
+#define PR128_TYPES_LIST(X, ...) \
+	PR128_F_TYPES_LIST(PR128_T_EXPANDER, X, __VA_ARGS__)
+]])
+
+do
+	local rows = {}
+	for _, t in ipairs(types128) do
+		table.insert(rows, {'#define', 'PR128_' .. t.FT .. '_OPS_LIST',
+		    'PR128_OPS_' .. t.N})
+	end
+	for _, line in ipairs(columns(rows)) do
+		emit(line)
+	end
+end
+
+io.write(table.concat(lines, '\n'), '\n')
+
+local missing <const> = {}
+for _, path in ipairs(arg) do
+	for line in io.lines(path) do
+		local name = line:match('^%s*#%s*define%s+(CK_F_PR_[%w_]+)')
+		if name and not generated[name] and not missing[name] then
+			missing[name] = true
+			table.insert(missing, name)
+		end
+	end
+end
+table.sort(missing)
+for _, name in ipairs(missing) do
+	io.stderr:write(name, ' not generated\n')
+end
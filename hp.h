@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025-2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_hp.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "probes.h"
+#include "stats.h"
+
+#define CK_HP_RECORD_METATABLE "ck_hp_record_t"
+
+static inline void
+register_hp_record(lua_State *L, ck_hp_t *domain)
+{
+	ck_hp_record_t *record;
+
+	/*
+	 * Once registered, a record must survive for the lifetime of hp_domain.
+	 * So, we have to allocate it on the heap but keep a lightuserdata
+	 * uservalue for GC to purge and unregister the record when this thread
+	 * is closed.
+	 */
+	if ((record = ck_hp_recycle(domain)) == NULL) {
+		/* Allocate the pointers immediately following the record. */
+		if ((record = malloc(sizeof(*record) +
+		    sizeof(void *) * domain->degree)) == NULL) {
+			fatal(L, "malloc", ENOMEM);
+		}
+		/*
+		 * The pointers are initialized by ck_hp_register(), so we do
+		 * not need to clear them beforehand.
+		 */
+		ck_hp_register(domain, record, (void **)(record + 1));
+	}
+	new(L, record, CK_HP_RECORD_METATABLE);
+	lua_rawsetp(L, LUA_REGISTRYINDEX, domain);
+}
+
+static inline int
+l_ck_hp_record_gc(lua_State *L)
+{
+	ck_hp_record_t *record;
+
+	record = checkcookie(L, 1, CK_HP_RECORD_METATABLE);
+
+	ck_hp_purge(record);
+	ck_hp_unregister(record);
+	return (0);
+}
+
+/*
+ * Each module with its own domain registers a record for the domain in every
+ * Lua state that opens the module.  The records share a metatable.
+ */
+static inline void
+open_hp_domain(lua_State *L, ck_hp_t *domain)
+{
+	if (luaL_newmetatable(L, CK_HP_RECORD_METATABLE)) {
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -2, "__index");
+		lua_pushcfunction(L, l_ck_hp_record_gc);
+		lua_setfield(L, -2, "__gc");
+	}
+	lua_pop(L, 1);
+	register_hp_record(L, domain);
+}
+
+static inline ck_hp_record_t *
+gethprecord(lua_State *L, ck_hp_t *domain)
+{
+	lua_rawgetp(L, LUA_REGISTRYINDEX, domain);
+	return (checkcookie(L, -1, CK_HP_RECORD_METATABLE));
+}
+
+/*
+ * Retire a pointer with ck_hp_free(), counting the scans for unprotected
+ * pointers it triggers and how many of the pending pointers each scan frees,
+ * and firing the hp-reclaim probe for each scan.
+ */
+static inline void
+hp_free(ck_hp_record_t *record, ck_hp_hazard_t *hazard, void *data,
+    void *pointer)
+{
+#if defined(STATS) || defined(PROBES)
+	uint64_t reclaimed;
+	bool scan;
+
+	reclaimed = record->n_reclamations;
+	scan = record->n_pending + 1 >= record->global->threshold;
+#endif
+	ck_hp_free(record, hazard, data, pointer);
+#if defined(STATS) || defined(PROBES)
+	STATS_TOTAL_INC(hp, frees);
+	if (scan) {
+		reclaimed = record->n_reclamations - reclaimed;
+		STATS_TOTAL_INC(hp, scans);
+		STATS_TOTAL_ADD(hp, reclaimed, reclaimed);
+		CK_HP_RECLAIM(record, record->n_pending, reclaimed);
+	}
+#endif
+}
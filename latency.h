@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ck_pr.h>
+
+#include <lua.h>
+
+#include "serdebuf.h"
+
+/*
+ * Queues created with latency enabled prefix each serialized message with the
+ * CLOCK_MONOTONIC time it was enqueued, and record how long it was queued when
+ * it is dequeued.  Times in nanoseconds are counted in log-linear buckets: a
+ * bucket for each of the first LATENCY_SUB_BUCKETS values, then for each power
+ * of two LATENCY_SUB_BUCKETS buckets dividing it evenly, so a bucket is within
+ * 1/LATENCY_SUB_BUCKETS of the times it counts.
+ */
+
+#ifndef LATENCY_SUB_BITS
+#define LATENCY_SUB_BITS 3
+#endif
+
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+struct latency {
+	uint64_t max;
+	uint64_t buckets[LATENCY_BUCKETS];
+};
+
+static inline struct latency *
+latency_alloc(void)
+{
+	return (calloc(1, sizeof(struct latency)));
+}
+
+static inline unsigned int
+latency_bucket(uint64_t ns)
+{
+	unsigned int shift;
+
+	if (ns < LATENCY_SUB_BUCKETS) {
+		return (ns);
+	}
+	shift = 63 - __builtin_clzll(ns) - LATENCY_SUB_BITS;
+	return ((shift + 1) * LATENCY_SUB_BUCKETS +
+	    ((ns >> shift) & (LATENCY_SUB_BUCKETS - 1)));
+}
+
+static inline uint64_t
+latency_lower(unsigned int bucket)
+{
+	unsigned int shift;
+
+	if (bucket < LATENCY_SUB_BUCKETS) {
+		return (bucket);
+	}
+	shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	return ((uint64_t)(LATENCY_SUB_BUCKETS +
+	    bucket % LATENCY_SUB_BUCKETS) << shift);
+}
+
+static inline uint64_t
+latency_upper(unsigned int bucket)
+{
+	if (bucket == LATENCY_BUCKETS - 1) {
+		return (UINT64_MAX);
+	}
+	return (latency_lower(bucket + 1) - 1);
+}
+
+static inline uint64_t
+latency_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+/*
+ * Reserve room for the timestamp before a message is serialized.
+ */
+static inline int
+latency_reserve(struct latency *latency, struct serdebuf *sb)
+{
+	uint64_t stamp = 0;
+
+	if (latency == NULL) {
+		return (0);
+	}
+	return (serdebuf_append(sb, &stamp, sizeof(stamp)));
+}
+
+/*
+ * Stamp a finalized message just before it is enqueued.
+ */
+static inline void
+latency_stamp(struct latency *latency, void *v)
+{
+	uint64_t stamp;
+
+	if (latency == NULL) {
+		return;
+	}
+	stamp = latency_now();
+	memcpy(v, &stamp, sizeof(stamp));
+}
+
+/*
+ * Record the time a dequeued message was queued, returning the serialized value
+ * following the timestamp.
+ */
+static inline const void *
+latency_record(struct latency *latency, const void *v)
+{
+	uint64_t stamp, ns, max;
+
+	if (latency == NULL) {
+		return (v);
+	}
+	memcpy(&stamp, v, sizeof(stamp));
+	ns = latency_now() - stamp;
+	ck_pr_inc_64(&latency->buckets[latency_bucket(ns)]);
+	max = ck_pr_load_64(&latency->max);
+	while (ns > max && !ck_pr_cas_64_value(&latency->max, max, ns, &max)) {
+		ck_pr_stall();
+	}
+	return ((const char *)v + sizeof(stamp));
+}
+
+/*
+ * Push a table summarizing the histogram, or nothing if latency is not enabled.
+ * The buckets are loaded one at a time while other threads may be recording,
+ * so the summary is not a consistent snapshot.
+ */
+static inline int
+latency_push(lua_State *L, struct latency *latency)
+{
+	static const struct {
+		const char *name;
+		uint64_t permille;
+	} percentiles[] = {
+		{ "p50", 500 },
+		{ "p90", 900 },
+		{ "p99", 990 },
+		{ "p999", 999 },
+		{ NULL, 0 },
+	};
+	uint64_t counts[LATENCY_BUCKETS];
+	uint64_t count, max, rank, seen;
+	unsigned int i, j, n;
+
+	if (latency == NULL) {
+		return (0);
+	}
+	count = 0;
+	for (i = 0; i < LATENCY_BUCKETS; i++) {
+		counts[i] = ck_pr_load_64(&latency->buckets[i]);
+		count += counts[i];
+	}
+	max = ck_pr_load_64(&latency->max);
+	lua_createtable(L, 0, 7);
+	lua_pushinteger(L, count);
+	lua_setfield(L, -2, "count");
+	lua_pushinteger(L, max);
+	lua_setfield(L, -2, "max");
+	/* Each percentile is the upper bound of the bucket reaching its rank. */
+	for (i = 0, j = 0, seen = 0; count != 0 && percentiles[j].name != NULL;
+	    j++) {
+		rank = (count * percentiles[j].permille + 999) / 1000;
+		while (seen + counts[i] < rank) {
+			seen += counts[i++];
+		}
+		lua_pushinteger(L, MIN(latency_upper(i), max));
+		lua_setfield(L, -2, percentiles[j].name);
+	}
+	lua_newtable(L);
+	for (i = 0, n = 0; i < LATENCY_BUCKETS; i++) {
+		if (counts[i] == 0) {
+			continue;
+		}
+		lua_createtable(L, 0, 3);
+		lua_pushinteger(L, latency_lower(i));
+		lua_setfield(L, -2, "lower");
+		lua_pushinteger(L, MIN(latency_upper(i), max));
+		lua_setfield(L, -2, "upper");
+		lua_pushinteger(L, counts[i]);
+		lua_setfield(L, -2, "count");
+		lua_rawseti(L, -2, ++n);
+	}
+	lua_setfield(L, -2, "buckets");
+	return (1);
+}
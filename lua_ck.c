@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Ryan Moeller
+ * Copyright (c) 2025-2026 Ryan Moeller
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
@@ -9,25 +9,53 @@
 #include <lualib.h>
 
 #include "common.h"
-
-/* TODO: bitmaps, stacks, locks, etc */
+#include "stats.h"
 
 int
 luaopen_ck(lua_State *L)
 {
+	/* The serde module must be opened before anything else. */
 	luaL_requiref(L, "ck.serde", luaopen_ck_serde, 0);
 	lua_newtable(L); /* ck */
+	lua_insert(L, -2);
+	lua_setfield(L, -2, "serde");
+	luaL_requiref(L, "ck.barrier", luaopen_ck_barrier, 0);
+	lua_setfield(L, -2, "barrier");
+	luaL_requiref(L, "ck.bitmap", luaopen_ck_bitmap, 0);
+	lua_setfield(L, -2, "bitmap");
+	luaL_requiref(L, "ck.brlock", luaopen_ck_brlock, 0);
+	lua_setfield(L, -2, "brlock");
+	luaL_requiref(L, "ck.chan", luaopen_ck_chan, 0);
+	lua_getfield(L, -1, "select");
+	lua_setfield(L, -3, "select"); /* ck.select is ck.chan.select */
+	lua_setfield(L, -2, "chan");
+	luaL_requiref(L, "ck.counter", luaopen_ck_counter, 0);
+	lua_setfield(L, -2, "counter");
 	luaL_requiref(L, "ck.ec", luaopen_ck_ec, 0);
 	lua_setfield(L, -2, "ec");
 	luaL_requiref(L, "ck.fifo", luaopen_ck_fifo, 0);
 	lua_setfield(L, -2, "fifo");
+	luaL_requiref(L, "ck.future", luaopen_ck_future, 0);
+	lua_setfield(L, -2, "future");
+	luaL_requiref(L, "ck.parallel", luaopen_ck_parallel, 0);
+	lua_setfield(L, -2, "parallel");
+	luaL_requiref(L, "ck.pool", luaopen_ck_pool, 0);
+	lua_setfield(L, -2, "pool");
 	luaL_requiref(L, "ck.pr", luaopen_ck_pr, 0);
 	lua_setfield(L, -2, "pr");
 	luaL_requiref(L, "ck.ring", luaopen_ck_ring, 0);
 	lua_setfield(L, -2, "ring");
+	luaL_requiref(L, "ck.rwlock", luaopen_ck_rwlock, 0);
+	lua_setfield(L, -2, "rwlock");
 	luaL_requiref(L, "ck.sequence", luaopen_ck_sequence, 0);
 	lua_setfield(L, -2, "sequence");
 	luaL_requiref(L, "ck.shared", luaopen_ck_shared, 0);
 	lua_setfield(L, -2, "shared");
+	luaL_requiref(L, "ck.spinlock", luaopen_ck_spinlock, 0);
+	lua_setfield(L, -2, "spinlock");
+	luaL_requiref(L, "ck.stack", luaopen_ck_stack, 0);
+	lua_setfield(L, -2, "stack");
+	lua_pushcfunction(L, l_ck_stats);
+	lua_setfield(L, -2, "stats");
 	return (1);
 }
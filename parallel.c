@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ck_ec.h>
+#include <ck_pr.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "ec.h"
+#include "pool.h"
+#include "refcount.h"
+#include "serde.h"
+#include "serdebuf.h"
+#include "luaerror.h"
+
+#ifndef PARALLEL_CHUNKS_PER_THREAD
+#define PARALLEL_CHUNKS_PER_THREAD 4 /* default chunking, for load balance */
+#endif
+
+/* Registry key for the pool used when none is given. */
+#define PARALLEL_POOL "ck.parallel.pool"
+
+/*
+ * A job splits the input array into chunks, each serialized as a count
+ * followed by the values.  The function is serialized once, and tasks run by
+ * the workers of a pool each load it and claim chunks one at a time until none
+ * are left, serializing the results of each chunk the same way.  The calling
+ * thread claims chunks too, so the job completes even if no worker is free to
+ * run its tasks, then waits for the chunks claimed by workers to be done and
+ * assembles the results in order.  Tasks still queued when the job completes
+ * find no chunks left, and the last reference to the job frees it.
+ */
+struct chunk {
+	void *input;
+	void *output;
+	lua_Integer first; /* index of the first value in the input */
+};
+
+struct job {
+	void *fn;
+	char *err; /* first error raised by a worker */
+	bool failed;
+	bool reduce;
+	unsigned int next; /* next chunk to be claimed */
+	unsigned int nchunks;
+	ck_ec32_t done; /* incremented as each chunk is done or abandoned */
+	refcount refs CK_CC_CACHELINE;
+	struct chunk chunks[];
+};
+
+static void
+freejob(struct job *job)
+{
+	for (unsigned int i = 0; i < job->nchunks; i++) {
+		free(job->chunks[i].input);
+		free(job->chunks[i].output);
+	}
+	free(job->fn);
+	free(job->err);
+	free(job);
+}
+
+static inline void
+releasejob(struct job *job)
+{
+	if (refcount_release(&job->refs)) {
+		freejob(job);
+	}
+}
+
+static void
+jobfailed(struct job *job, const char *msg)
+{
+	char *err;
+
+	ck_pr_store_bool(&job->failed, true);
+	if (ck_pr_load_ptr(&job->err) == NULL &&
+	    (err = strdup(msg)) != NULL &&
+	    !ck_pr_cas_ptr(&job->err, NULL, err)) {
+		free(err);
+	}
+}
+
+/*
+ * Push the error for a failed serialization, unless one is already on top.
+ */
+static inline void
+pusherror(lua_State *L, int error)
+{
+	if (error > 0) {
+		lua_pushstring(L, strerror(error));
+	}
+}
+
+static int
+serializechunk(lua_State *L, int idx, lua_Integer first, int n, void **pp)
+{
+	struct serdebuf sb;
+	int error;
+
+	/* The function at index 1 is as good a size hint as any. */
+	if ((error = serdebuf_init(L, 1, &sb)) != 0) {
+		return (error);
+	}
+	if ((error = serdebuf_append(&sb, &n, sizeof(n))) != 0) {
+		serdebuf_destroy(&sb);
+		return (error);
+	}
+	for (int i = 0; i < n; i++) {
+		serde_type_code type = SERDE_ANY;
+
+		lua_geti(L, idx, first + i);
+		if ((error = serdebuf_serialize(L, lua_gettop(L), &sb, &type)) !=
+		    0) {
+			serdebuf_destroy(&sb);
+			return (error);
+		}
+		lua_pop(L, 1);
+	}
+	if ((*pp = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		return (ENOMEM);
+	}
+	return (0);
+}
+
+/*
+ * Apply the function at index fn to each value of the chunk.  Only the first
+ * result of each call is kept.
+ */
+static bool
+mapchunk(lua_State *L, int fn, struct chunk *chunk)
+{
+	struct serdebuf sb;
+	const char *p;
+	int n, error;
+
+	p = chunk->input;
+	memcpy(&n, p, sizeof(n));
+	p += sizeof(n);
+	if ((error = serdebuf_init(L, fn, &sb)) != 0) {
+		pusherror(L, error);
+		return (false);
+	}
+	if ((error = serdebuf_append(&sb, &n, sizeof(n))) != 0) {
+		serdebuf_destroy(&sb);
+		pusherror(L, error);
+		return (false);
+	}
+	for (int i = 0; i < n; i++) {
+		serde_type_code type = SERDE_ANY;
+
+		lua_pushvalue(L, fn);
+		if ((p = loadshared(L, p)) == NULL ||
+		    lua_pcall(L, 1, 1, 0) != LUA_OK) {
+			serdebuf_destroy(&sb);
+			return (false);
+		}
+		if ((error = serdebuf_serialize(L, lua_gettop(L), &sb, &type)) !=
+		    0) {
+			serdebuf_destroy(&sb);
+			pusherror(L, error);
+			return (false);
+		}
+		lua_pop(L, 1);
+	}
+	if ((chunk->output = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		pusherror(L, ENOMEM);
+		return (false);
+	}
+	return (true);
+}
+
+/*
+ * Fold the values of the chunk with the function at index fn, from left to
+ * right, starting with the first value.
+ */
+static bool
+reducechunk(lua_State *L, int fn, struct chunk *chunk)
+{
+	const char *p;
+	int top, n, error;
+
+	top = lua_gettop(L);
+	p = chunk->input;
+	memcpy(&n, p, sizeof(n));
+	p += sizeof(n);
+	if ((p = loadshared(L, p)) == NULL) {
+		return (false);
+	}
+	for (int i = 1; i < n; i++) {
+		lua_pushvalue(L, fn);
+		lua_pushvalue(L, top + 1);
+		if ((p = loadshared(L, p)) == NULL ||
+		    lua_pcall(L, 2, 1, 0) != LUA_OK) {
+			return (false);
+		}
+		lua_replace(L, top + 1);
+	}
+	if ((error = serdebuf_serialize_value(L, top + 1, &chunk->output)) !=
+	    0) {
+		pusherror(L, error);
+		return (false);
+	}
+	lua_settop(L, top);
+	return (true);
+}
+
+/*
+ * Claim and run chunks until none are left, loading the function the first
+ * time a chunk is claimed.  Once the job has failed, claimed chunks are only
+ * counted as done.
+ */
+static void
+runchunks(lua_State *L, struct job *job)
+{
+	struct chunk *chunk;
+	unsigned int i;
+	int top;
+	bool loaded, ok;
+
+	top = lua_gettop(L);
+	loaded = false;
+	while ((i = ck_pr_faa_uint(&job->next, 1)) < job->nchunks) {
+		if (!ck_pr_load_bool(&job->failed)) {
+			chunk = &job->chunks[i];
+			if (!loaded) {
+				loaded = loadshared(L, job->fn) != NULL;
+			}
+			ok = loaded && (job->reduce ?
+			    reducechunk(L, top + 1, chunk) :
+			    mapchunk(L, top + 1, chunk));
+			if (!ok) {
+				jobfailed(job, luaL_tolstring(L, -1, NULL));
+			}
+			lua_settop(L, loaded ? top + 1 : top);
+		}
+		ck_pr_fence_store();
+		ck_ec32_inc(&job->done, &ec_mp);
+	}
+	lua_settop(L, top);
+}
+
+static void
+worktask(lua_State *L, void *arg)
+{
+	struct job *job = arg;
+
+	runchunks(L, job);
+	releasejob(job);
+}
+
+/*
+ * Push the pool given by the options table at index 3.  Otherwise, a job
+ * started by a pool worker runs in the worker's own pool, leaving nil pushed,
+ * and any other job in the pool shared by every job in this Lua state, started
+ * on first use with a worker for each online CPU.
+ */
+static struct rcpool *
+pushpool(lua_State *L)
+{
+	struct rcpool *poolp;
+
+	if (lua_getfield(L, 3, "pool") != LUA_TNIL) {
+		return (pool_check(L, -1));
+	}
+	if ((poolp = pool_current()) != NULL) {
+		return (poolp);
+	}
+	lua_pop(L, 1);
+	if (lua_getfield(L, LUA_REGISTRYINDEX, PARALLEL_POOL) == LUA_TNIL) {
+		lua_pop(L, 1);
+		luaL_requiref(L, "ck.pool", luaopen_ck_pool, false);
+		lua_getfield(L, -1, "new");
+		lua_pushinteger(L, sysconf(_SC_NPROCESSORS_ONLN));
+		lua_call(L, 1, 1);
+		lua_remove(L, -2);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, PARALLEL_POOL);
+	}
+	return (pool_check(L, -1));
+}
+
+/*
+ * Split the input table at index 2 into a job according to the options table
+ * at index 3, run it, and return it with every chunk complete.  Returns NULL if
+ * the input is empty.  Any error is raised after the job is released.
+ */
+static struct job *
+runjob(lua_State *L, bool reduce)
+{
+	struct rcpool *poolp;
+	struct job *job;
+	lua_Integer n, chunk, nthreads, nchunks;
+	uint32_t done;
+	int error;
+
+	luaL_checktype(L, 1, LUA_TFUNCTION);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	if (lua_isnoneornil(L, 3)) {
+		lua_settop(L, 2);
+		lua_newtable(L);
+	}
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	n = luaL_len(L, 2);
+	if (n <= 0) {
+		return (NULL);
+	}
+	poolp = pushpool(L);
+	lua_getfield(L, 3, "threads");
+	nthreads = luaL_optinteger(L, -1, pool_threads(poolp));
+	luaL_argcheck(L, nthreads > 0 && nthreads <= INT_MAX, 3,
+	    "bad number of threads");
+	lua_getfield(L, 3, "chunk");
+	chunk = luaL_optinteger(L, -1,
+	    (n + nthreads * PARALLEL_CHUNKS_PER_THREAD - 1) /
+	    (nthreads * PARALLEL_CHUNKS_PER_THREAD));
+	luaL_argcheck(L, chunk >= 0 && chunk <= INT_MAX, 3, "bad chunk size");
+	lua_pop(L, 2);
+	if (chunk == 0) {
+		chunk = 1;
+	}
+	nchunks = (n + chunk - 1) / chunk;
+	luaL_argcheck(L, nchunks <= INT_MAX, 3, "too many chunks");
+	if (nthreads > nchunks) {
+		nthreads = nchunks;
+	}
+
+	if ((job = refcount_alloc(sizeof(*job) +
+	    sizeof(*job->chunks) * nchunks)) == NULL) {
+		fatal(L, "malloc", ENOMEM);
+	}
+	memset(job, 0, sizeof(*job) + sizeof(*job->chunks) * nchunks);
+	job->reduce = reduce;
+	job->nchunks = nchunks;
+	ck_ec32_init(&job->done, 0);
+	refcount_init(&job->refs);
+	if ((error = serdebuf_serialize_value(L, 1, &job->fn)) != 0) {
+		goto fail;
+	}
+	for (lua_Integer i = 0; i < nchunks; i++) {
+		struct chunk *c = &job->chunks[i];
+
+		c->first = 1 + i * chunk;
+		if ((error = serializechunk(L, 2, c->first,
+		    i == nchunks - 1 ? n - c->first + 1 : chunk,
+		    &c->input)) != 0) {
+			goto fail;
+		}
+	}
+
+	/* Whatever chunks the tasks that could be queued leave are run here. */
+	for (lua_Integer i = 0; i < nthreads; i++) {
+		refcount_retain(&job->refs);
+		if (pool_run(poolp, worktask, job) != 0) {
+			releasejob(job);
+			break;
+		}
+	}
+	lua_pop(L, 1); /* pool */
+	runchunks(L, job);
+	while ((done = ck_ec32_value(&job->done)) < job->nchunks) {
+		ck_ec32_wait(&job->done, &ec_mp, done, NULL);
+	}
+	ck_pr_fence_load();
+	if (job->failed) {
+		lua_pushstring(L, job->err != NULL ? job->err :
+		    strerror(ENOMEM));
+		releasejob(job);
+		lua_error(L);
+	}
+	return (job);
+fail:
+	releasejob(job);
+	if (error < 0) {
+		lua_error(L);
+	}
+	fatal(L, "serialize", error);
+	return (NULL);
+}
+
+static int
+l_ck_parallel_map(lua_State *L)
+{
+	struct job *job;
+	const char *p;
+	int n;
+
+	job = runjob(L, false);
+
+	lua_newtable(L);
+	if (job == NULL) {
+		return (1);
+	}
+	for (unsigned int i = 0; i < job->nchunks; i++) {
+		struct chunk *c = &job->chunks[i];
+
+		p = c->output;
+		memcpy(&n, p, sizeof(n));
+		p += sizeof(n);
+		for (int j = 0; j < n; j++) {
+			if ((p = loadshared(L, p)) == NULL) {
+				releasejob(job);
+				return (lua_error(L));
+			}
+			lua_seti(L, -2, c->first + j);
+		}
+	}
+	releasejob(job);
+	return (1);
+}
+
+static int
+l_ck_parallel_reduce(lua_State *L)
+{
+	struct job *job;
+	lua_Integer i, nchunks;
+
+	job = runjob(L, true);
+
+	lua_settop(L, 3);
+	lua_getfield(L, 3, "initial"); /* accumulator */
+	if (job == NULL) {
+		return (1);
+	}
+	/* Load every partial result before calling into Lua again. */
+	nchunks = job->nchunks;
+	lua_createtable(L, nchunks, 0);
+	for (i = 0; i < nchunks; i++) {
+		if (loadshared(L, job->chunks[i].output) == NULL) {
+			releasejob(job);
+			return (lua_error(L));
+		}
+		lua_seti(L, 5, i + 1);
+	}
+	releasejob(job);
+
+	i = 1;
+	if (lua_isnil(L, 4)) {
+		lua_geti(L, 5, i++);
+		lua_replace(L, 4);
+	}
+	for (; i <= nchunks; i++) {
+		lua_pushvalue(L, 1);
+		lua_pushvalue(L, 4);
+		lua_geti(L, 5, i);
+		lua_call(L, 2, 1);
+		lua_replace(L, 4);
+	}
+	lua_settop(L, 4);
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_parallel_funcs[] = {
+	{"map", l_ck_parallel_map},
+	{"reduce", l_ck_parallel_reduce},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_parallel(lua_State *L)
+{
+	luaL_newlib(L, l_ck_parallel_funcs); /* ck.parallel */
+	return (1);
+}
@@ -0,0 +1,511 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ck_cc.h>
+#include <ck_ec.h>
+#include <ck_pr.h>
+#include <ck_ring.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "ec.h"
+#include "future.h"
+#include "pool.h"
+#include "refcount.h"
+#include "serde.h"
+#include "serdebuf.h"
+#include "luaerror.h"
+
+#define POOL_METATABLE "pool"
+
+#ifndef POOL_QUEUE_SIZE
+#define POOL_QUEUE_SIZE 256 /* must be a power of 2 */
+#endif
+
+/*
+ * A pool owns a fixed set of worker threads, each running its own Lua state.
+ * Every worker has a queue of tasks.  Tasks submitted from outside the pool
+ * are spread across the queues round-robin, while tasks submitted by a worker
+ * go to its own queue first.  An idle worker steals from the other queues
+ * before sleeping on the pool's event count.  Other modules can also queue C
+ * functions to be run in a worker's Lua state, without a future.
+ */
+struct task {
+	void *call; /* serialized function and arguments */
+	struct rcfuture *future;
+	pool_fn *fn; /* or a C function to call with arg */
+	void *arg;
+};
+
+struct worker {
+	ck_ring_t ring CK_CC_CACHELINE;
+	ck_ring_buffer_t *buffer;
+	struct rcpool *pool;
+	pthread_t thread;
+	unsigned int id;
+};
+
+struct rcpool {
+	void *init; /* serialized init function, or NULL */
+	char *initerr; /* first error raised by init in a worker */
+	bool initfailed;
+	ck_ec32_t work; /* incremented for each task submitted */
+	ck_ec32_t started; /* incremented as each worker starts */
+	unsigned int nworkers;
+	unsigned int running;
+	unsigned int next;
+	bool shutdown;
+	bool detached;
+	refcount refs CK_CC_CACHELINE;
+	struct worker workers[];
+};
+
+static __thread struct worker *current_worker;
+
+static void
+freepool(struct rcpool *poolp)
+{
+	struct task *task;
+
+	for (unsigned int i = 0; i < poolp->nworkers; i++) {
+		struct worker *worker = &poolp->workers[i];
+
+		if (worker->buffer == NULL) {
+			continue;
+		}
+		/* Tasks are only left over if the workers failed to start. */
+		while (ck_ring_dequeue_mpmc(&worker->ring, worker->buffer,
+		    &task)) {
+			free(task->call);
+			if (task->future != NULL) {
+				future_release(task->future);
+			}
+			free(task);
+		}
+		free(worker->buffer);
+	}
+	free(poolp->init);
+	free(poolp->initerr);
+	free(poolp);
+}
+
+static inline bool
+poptask(struct worker *worker, struct task **taskp)
+{
+	struct rcpool *poolp = worker->pool;
+
+	for (unsigned int i = 0; i < poolp->nworkers; i++) {
+		struct worker *victim;
+
+		victim = &poolp->workers[(worker->id + i) % poolp->nworkers];
+		if (ck_ring_dequeue_mpmc(&victim->ring, victim->buffer,
+		    taskp)) {
+			return (true);
+		}
+	}
+	return (false);
+}
+
+static void
+runtask(lua_State *L, struct task *task)
+{
+	int top, nargs, status;
+
+	top = lua_gettop(L);
+	if (task->fn != NULL) {
+		task->fn(L, task->arg);
+		lua_settop(L, top);
+		free(task);
+		return;
+	}
+	status = loadsharedlist(L, task->call, &nargs) == NULL ?
+	    LUA_ERRRUN : lua_pcall(L, nargs - 1, LUA_MULTRET, 0);
+	free(task->call);
+	if (status == LUA_OK) {
+		future_resolve(L, task->future, true, lua_gettop(L) - top);
+	} else {
+		/* Keep only the error. */
+		lua_insert(L, top + 1);
+		lua_settop(L, top + 1);
+		future_resolve(L, task->future, false, 1);
+	}
+	lua_settop(L, top);
+	future_release(task->future);
+	free(task);
+}
+
+static void
+initfailed(struct rcpool *poolp, const char *msg)
+{
+	char *err;
+
+	ck_pr_store_bool(&poolp->initfailed, true);
+	if (ck_pr_load_ptr(&poolp->initerr) == NULL &&
+	    (err = strdup(msg)) != NULL &&
+	    !ck_pr_cas_ptr(&poolp->initerr, NULL, err)) {
+		free(err);
+	}
+}
+
+static bool
+initworker(lua_State *L, struct rcpool *poolp)
+{
+	luaL_openlibs(L);
+	luaL_requiref(L, "ck", luaopen_ck, true);
+	lua_pop(L, 1);
+	if (poolp->init == NULL) {
+		return (true);
+	}
+	if (loadshared(L, poolp->init) != NULL &&
+	    lua_pcall(L, 0, 0, 0) == LUA_OK) {
+		return (true);
+	}
+	initfailed(poolp, luaL_tolstring(L, -1, NULL));
+	return (false);
+}
+
+static void *
+workermain(void *arg)
+{
+	struct worker *worker = arg;
+	struct rcpool *poolp = worker->pool;
+	struct task *task;
+	lua_State *L;
+	uint32_t snapshot;
+	bool ok;
+
+	current_worker = worker;
+	if ((L = luaL_newstate()) == NULL) {
+		initfailed(poolp, strerror(ENOMEM));
+		ok = false;
+	} else {
+		ok = initworker(L, poolp);
+	}
+	ck_ec32_inc(&poolp->started, &ec_mp);
+	while (ok) {
+		snapshot = ck_ec32_value(&poolp->work);
+		if (poptask(worker, &task)) {
+			runtask(L, task);
+			continue;
+		}
+		/* Queued tasks are finished before shutting down. */
+		if (ck_pr_load_bool(&poolp->shutdown)) {
+			break;
+		}
+		ck_ec32_wait(&poolp->work, &ec_mp, snapshot, NULL);
+	}
+	if (L != NULL) {
+		lua_close(L);
+	}
+	current_worker = NULL;
+	if (ck_pr_faa_uint(&poolp->running, -1) == 1 &&
+	    ck_pr_load_bool(&poolp->detached)) {
+		freepool(poolp);
+	}
+	return (NULL);
+}
+
+/*
+ * Stop the workers once they have finished any queued tasks.  Normally the
+ * workers are joined, but when the last reference to the pool is released by
+ * one of its own workers the workers are detached and the last one to exit
+ * frees the pool.
+ */
+static void
+stoppool(struct rcpool *poolp, unsigned int nthreads)
+{
+	bool detach;
+
+	detach = current_worker != NULL && current_worker->pool == poolp;
+	if (detach) {
+		for (unsigned int i = 0; i < nthreads; i++) {
+			pthread_detach(poolp->workers[i].thread);
+		}
+		ck_pr_store_bool(&poolp->detached, true);
+		ck_pr_fence_store();
+	}
+	ck_pr_store_bool(&poolp->shutdown, true);
+	ck_ec32_inc(&poolp->work, &ec_mp);
+	if (detach) {
+		return;
+	}
+	for (unsigned int i = 0; i < nthreads; i++) {
+		pthread_join(poolp->workers[i].thread, NULL);
+	}
+	freepool(poolp);
+}
+
+/*
+ * Queue a task, to the current worker first if it is one of the pool's own,
+ * and wake a worker.  Fails with EAGAIN if every queue is full.
+ */
+static int
+queuetask(struct rcpool *poolp, struct task *task)
+{
+	unsigned int first;
+
+	if (current_worker != NULL && current_worker->pool == poolp) {
+		first = current_worker->id;
+	} else {
+		first = ck_pr_faa_uint(&poolp->next, 1);
+	}
+	for (unsigned int i = 0; i < poolp->nworkers; i++) {
+		struct worker *worker;
+
+		worker = &poolp->workers[(first + i) % poolp->nworkers];
+		if (ck_ring_enqueue_mpmc(&worker->ring, worker->buffer,
+		    task)) {
+			ck_ec32_inc(&poolp->work, &ec_mp);
+			return (0);
+		}
+	}
+	return (EAGAIN);
+}
+
+struct rcpool *
+pool_check(lua_State *L, int idx)
+{
+	return (checkcookie(L, idx, POOL_METATABLE));
+}
+
+unsigned int
+pool_threads(struct rcpool *poolp)
+{
+	return (poolp->nworkers);
+}
+
+/*
+ * The pool of the worker running the calling thread, or NULL if the thread is
+ * not a worker.  The pool outlives its running workers, so no reference is
+ * needed to use it from one.
+ */
+struct rcpool *
+pool_current(void)
+{
+	return (current_worker != NULL ? current_worker->pool : NULL);
+}
+
+/*
+ * Queue a call of fn with arg in the Lua state of one of the pool's workers.
+ * The worker restores its stack afterward.  The caller must hold a reference
+ * to the pool, but the pool finishes queued tasks before it is freed, so the
+ * reference may be released before fn is called.
+ */
+int
+pool_run(struct rcpool *poolp, pool_fn *fn, void *arg)
+{
+	struct task *task;
+	int error;
+
+	if ((task = calloc(1, sizeof(*task))) == NULL) {
+		return (ENOMEM);
+	}
+	task->fn = fn;
+	task->arg = arg;
+	if ((error = queuetask(poolp, task)) != 0) {
+		free(task);
+	}
+	return (error);
+}
+
+static int
+l_ck_pool_new(lua_State *L)
+{
+	struct rcpool *poolp;
+	lua_Integer nthreads;
+	size_t size;
+	unsigned int i;
+	int error;
+
+	nthreads = luaL_checkinteger(L, 1);
+	luaL_argcheck(L, nthreads > 0 && nthreads <= INT_MAX, 1,
+	    "bad number of threads");
+	if (!lua_isnoneornil(L, 2)) {
+		luaL_checktype(L, 2, LUA_TFUNCTION);
+	}
+
+	size = sizeof(*poolp) + sizeof(poolp->workers[0]) * nthreads;
+	if ((poolp = refcount_alloc(size)) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	memset(poolp, 0, size);
+	poolp->nworkers = nthreads;
+	ck_ec32_init(&poolp->work, 0);
+	ck_ec32_init(&poolp->started, 0);
+	refcount_init(&poolp->refs);
+	if (!lua_isnoneornil(L, 2) &&
+	    (error = serdebuf_serialize_value(L, 2, &poolp->init)) != 0) {
+		freepool(poolp);
+		if (error < 0) {
+			return (lua_error(L));
+		}
+		return (fatal(L, "serdebuf_serialize_value", error));
+	}
+	for (i = 0; i < poolp->nworkers; i++) {
+		struct worker *worker = &poolp->workers[i];
+
+		if ((worker->buffer = malloc(sizeof(ck_ring_buffer_t) *
+		    POOL_QUEUE_SIZE)) == NULL) {
+			freepool(poolp);
+			return (fatal(L, "malloc", ENOMEM));
+		}
+		ck_ring_init(&worker->ring, POOL_QUEUE_SIZE);
+		worker->pool = poolp;
+		worker->id = i;
+	}
+	poolp->running = poolp->nworkers;
+	for (i = 0; i < poolp->nworkers; i++) {
+		if ((error = pthread_create(&poolp->workers[i].thread, NULL,
+		    workermain, &poolp->workers[i])) != 0) {
+			stoppool(poolp, i);
+			return (fatal(L, "pthread_create", error));
+		}
+	}
+	/* Wait for the init function to have run in every worker. */
+	while ((i = ck_ec32_value(&poolp->started)) < poolp->nworkers) {
+		ck_ec32_wait(&poolp->started, &ec_mp, i, NULL);
+	}
+	if (poolp->initfailed) {
+		lua_pushstring(L, poolp->initerr != NULL ? poolp->initerr :
+		    strerror(ENOMEM));
+		stoppool(poolp, poolp->nworkers);
+		return (lua_error(L));
+	}
+	return (new(L, poolp, POOL_METATABLE));
+}
+
+static int
+l_ck_pool_retain(lua_State *L)
+{
+	struct rcpool *poolp;
+
+	poolp = checklightuserdata(L, 1);
+
+	refcount_retain(&poolp->refs);
+	return (new(L, poolp, POOL_METATABLE));
+}
+
+static int
+l_ck_pool_gc(lua_State *L)
+{
+	struct rcpool *poolp;
+
+	poolp = checkcookie(L, 1, POOL_METATABLE);
+
+	if (refcount_release(&poolp->refs)) {
+		stoppool(poolp, poolp->nworkers);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_pool_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, POOL_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_pool_threads(lua_State *L)
+{
+	struct rcpool *poolp;
+
+	poolp = checkcookie(L, 1, POOL_METATABLE);
+
+	lua_pushinteger(L, poolp->nworkers);
+	return (1);
+}
+
+static int
+l_ck_pool_submit(lua_State *L)
+{
+	struct serdebuf sb;
+	struct rcpool *poolp;
+	struct rcfuture *futurep;
+	struct task *task;
+	int error;
+
+	poolp = checkcookie(L, 1, POOL_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	if ((task = calloc(1, sizeof(*task))) == NULL) {
+		return (fatal(L, "calloc", ENOMEM));
+	}
+	if ((error = serdebuf_init(L, 2, &sb)) != 0) {
+		free(task);
+		return (fatal(L, "serdebuf_init", error));
+	}
+	if ((error = serdebuf_serialize_list(L, 2, lua_gettop(L) - 1,
+	    &sb)) != 0) {
+		serdebuf_destroy(&sb);
+		free(task);
+		if (error < 0) {
+			return (lua_error(L));
+		}
+		return (fatal(L, "serdebuf_serialize_list", error));
+	}
+	if ((task->call = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		free(task);
+		return (fatal(L, "serdebuf_finalize", ENOMEM));
+	}
+	if ((futurep = future_new()) == NULL) {
+		free(task->call);
+		free(task);
+		return (fatal(L, "future_new", ENOMEM));
+	}
+	future_push(L, futurep);
+	refcount_retain(&futurep->refs);
+	task->future = futurep;
+
+	if (queuetask(poolp, task) == 0) {
+		return (1);
+	}
+	/* Every queue is full. */
+	free(task->call);
+	future_release(futurep);
+	free(task);
+	lua_pop(L, 1);
+	return (fail(L, EAGAIN));
+}
+
+static const struct luaL_Reg l_ck_pool_funcs[] = {
+	{"new", l_ck_pool_new},
+	{"retain", l_ck_pool_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_pool_meta[] = {
+	{"__gc", l_ck_pool_gc},
+	{"cookie", l_ck_pool_cookie},
+	{"threads", l_ck_pool_threads},
+	{"submit", l_ck_pool_submit},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_pool(lua_State *L)
+{
+	luaL_newmetatable(L, POOL_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_pool_meta, 0);
+
+	luaL_newlib(L, l_ck_pool_funcs); /* ck.pool */
+	return (1);
+}
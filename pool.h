@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <lua.h>
+
+struct rcpool;
+
+/* A function run by a worker in its own Lua state, for other modules. */
+typedef void pool_fn(lua_State *L, void *arg);
+
+struct rcpool *pool_check(lua_State *L, int idx);
+struct rcpool *pool_current(void);
+unsigned int pool_threads(struct rcpool *poolp);
+int pool_run(struct rcpool *poolp, pool_fn *fn, void *arg);
@@ -4,12 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+/* Generated by genpr.lua, do not edit. */
+
 #pragma once
 
 #include <ck_pr.h>
 
-/* FIXME: This whole file should be generated by a script. */
-
 /*
  * Legend of Field Identifiers
  *
@@ -30,6 +30,11 @@
  * Metadata - additional information about an operation or type
  *   CLASS: Classification (based on operation inputs and outputs)
  *   N: Number (of components of this type in multi-word operations)
+ *
+ * Every operation is listed for every type.  PR_OP_<F><FV>_<FT> expands to
+ * nothing where Concurrency Kit does not implement the operation for the type
+ * on this machine.  It does not refer to PR_OP_<F><FV>, so it may be used in
+ * an expansion of PR_OPS_LIST.
  */
 
 /*        F      FV      OP     VARIANT   CLASS               ... */
@@ -49,7 +54,7 @@
 	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #define PR_OP_DEC(X, ...) \
 	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
-#define PR_OP_DEC_Z(X, ...) \
+#define PR_OP_DEC_ZERO(X, ...) \
 	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #define PR_OP_FAA(X, ...) \
 	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
@@ -57,13 +62,13 @@
 	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #define PR_OP_INC(X, ...) \
 	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
-#define PR_OP_INC_Z(X, ...) \
+#define PR_OP_INC_ZERO(X, ...) \
 	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #define PR_OP_LOAD(X, ...) \
 	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #define PR_OP_NEG(X, ...) \
 	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
-#define PR_OP_NEG_Z(X, ...) \
+#define PR_OP_NEG_ZERO(X, ...) \
 	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #define PR_OP_NOT(X, ...) \
 	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
@@ -78,1185 +83,1476 @@
 #define PR_OP_UNIMPLEMENTED(X, ...)
 
 #ifdef CK_F_PR_ADD_8
-#define PR_OP_ADD_8 PR_OP_ADD
+#define PR_OP_ADD_8(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_16
-#define PR_OP_ADD_16 PR_OP_ADD
+#define PR_OP_ADD_16(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_32
-#define PR_OP_ADD_32 PR_OP_ADD
+#define PR_OP_ADD_32(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_64
-#define PR_OP_ADD_64 PR_OP_ADD
+#define PR_OP_ADD_64(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_CHAR
-#define PR_OP_ADD_CHAR PR_OP_ADD
+#define PR_OP_ADD_CHAR(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_DOUBLE
-#define PR_OP_ADD_DOUBLE PR_OP_ADD
+#define PR_OP_ADD_DOUBLE(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_INT
-#define PR_OP_ADD_INT PR_OP_ADD
+#define PR_OP_ADD_INT(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_PTR
-#define PR_OP_ADD_PTR PR_OP_ADD
+#define PR_OP_ADD_PTR(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_SHORT
-#define PR_OP_ADD_SHORT PR_OP_ADD
+#define PR_OP_ADD_SHORT(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_ADD_UINT
-#define PR_OP_ADD_UINT PR_OP_ADD
+#define PR_OP_ADD_UINT(X, ...) \
+	X(ADD,   ,       add,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_ADD_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_ADD_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_8
-#define PR_OP_AND_8 PR_OP_AND
+#define PR_OP_AND_8(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_16
-#define PR_OP_AND_16 PR_OP_AND
+#define PR_OP_AND_16(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_32
-#define PR_OP_AND_32 PR_OP_AND
+#define PR_OP_AND_32(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_64
-#define PR_OP_AND_64 PR_OP_AND
+#define PR_OP_AND_64(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_CHAR
-#define PR_OP_AND_CHAR PR_OP_AND
+#define PR_OP_AND_CHAR(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_AND_DOUBLE
+#define PR_OP_AND_DOUBLE(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
+#else
+#define PR_OP_AND_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_INT
-#define PR_OP_AND_INT PR_OP_AND
+#define PR_OP_AND_INT(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_PTR
-#define PR_OP_AND_PTR PR_OP_AND
+#define PR_OP_AND_PTR(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_SHORT
-#define PR_OP_AND_SHORT PR_OP_AND
+#define PR_OP_AND_SHORT(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_AND_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_AND_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_AND_UINT
-#define PR_OP_AND_UINT PR_OP_AND
+#define PR_OP_AND_UINT(X, ...) \
+	X(AND,   ,       and,   ,         BINARY_BITWISE,     __VA_ARGS__)
+#else
+#define PR_OP_AND_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTC_8
+#define PR_OP_BTC_8(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_AND_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_16
-#define PR_OP_BTC_16 PR_OP_BTC
+#define PR_OP_BTC_16(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_32
-#define PR_OP_BTC_32 PR_OP_BTC
+#define PR_OP_BTC_32(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_64
-#define PR_OP_BTC_64 PR_OP_BTC
+#define PR_OP_BTC_64(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTC_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTC_CHAR
+#define PR_OP_BTC_CHAR(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTC_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTC_DOUBLE
+#define PR_OP_BTC_DOUBLE(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_INT
-#define PR_OP_BTC_INT PR_OP_BTC
+#define PR_OP_BTC_INT(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_PTR
-#define PR_OP_BTC_PTR PR_OP_BTC
+#define PR_OP_BTC_PTR(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTC_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTC_SHORT
+#define PR_OP_BTC_SHORT(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTC_UINT
-#define PR_OP_BTC_UINT PR_OP_BTC
+#define PR_OP_BTC_UINT(X, ...) \
+	X(BTC,   ,       btc,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTC_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTC_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTR_8
+#define PR_OP_BTR_8(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTR_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_16
-#define PR_OP_BTR_16 PR_OP_BTR
+#define PR_OP_BTR_16(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_32
-#define PR_OP_BTR_32 PR_OP_BTR
+#define PR_OP_BTR_32(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_64
-#define PR_OP_BTR_64 PR_OP_BTR
+#define PR_OP_BTR_64(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTR_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTR_CHAR
+#define PR_OP_BTR_CHAR(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTR_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTR_DOUBLE
+#define PR_OP_BTR_DOUBLE(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_INT
-#define PR_OP_BTR_INT PR_OP_BTR
+#define PR_OP_BTR_INT(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_PTR
-#define PR_OP_BTR_PTR PR_OP_BTR
+#define PR_OP_BTR_PTR(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTR_SHORT
+#define PR_OP_BTR_SHORT(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTR_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTR_UINT
-#define PR_OP_BTR_UINT PR_OP_BTR
+#define PR_OP_BTR_UINT(X, ...) \
+	X(BTR,   ,       btr,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTR_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTR_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTS_8
+#define PR_OP_BTS_8(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTS_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_16
-#define PR_OP_BTS_16 PR_OP_BTS
+#define PR_OP_BTS_16(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_32
-#define PR_OP_BTS_32 PR_OP_BTS
+#define PR_OP_BTS_32(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_64
-#define PR_OP_BTS_64 PR_OP_BTS
+#define PR_OP_BTS_64(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTS_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTS_CHAR
+#define PR_OP_BTS_CHAR(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTS_DOUBLE
+#define PR_OP_BTS_DOUBLE(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTS_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_INT
-#define PR_OP_BTS_INT PR_OP_BTS
+#define PR_OP_BTS_INT(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_PTR
-#define PR_OP_BTS_PTR PR_OP_BTS
+#define PR_OP_BTS_PTR(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
+#else
+#define PR_OP_BTS_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_BTS_SHORT
+#define PR_OP_BTS_SHORT(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_BTS_UINT
-#define PR_OP_BTS_UINT PR_OP_BTS
+#define PR_OP_BTS_UINT(X, ...) \
+	X(BTS,   ,       bts,   ,         BIT_RMW,            __VA_ARGS__)
 #else
-#define PR_OP_BTS_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_BTS_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_CAS_8
-#define PR_OP_CAS_8 PR_OP_CAS
+#define PR_OP_CAS_8(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_8_VALUE
-#define PR_OP_CAS_VALUE_8 PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_16
+#define PR_OP_CAS_16(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_16
-#define PR_OP_CAS_16 PR_OP_CAS
+#ifdef CK_F_PR_CAS_32
+#define PR_OP_CAS_32(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_16_VALUE
-#define PR_OP_CAS_VALUE_16 PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_64
+#define PR_OP_CAS_64(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_32
-#define PR_OP_CAS_32 PR_OP_CAS
+#ifdef CK_F_PR_CAS_CHAR
+#define PR_OP_CAS_CHAR(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_32_VALUE
-#define PR_OP_CAS_VALUE_32 PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_DOUBLE
+#define PR_OP_CAS_DOUBLE(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_64
-#define PR_OP_CAS_64 PR_OP_CAS
+#ifdef CK_F_PR_CAS_INT
+#define PR_OP_CAS_INT(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_64_VALUE
-#define PR_OP_CAS_VALUE_64 PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_PTR
+#define PR_OP_CAS_PTR(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_CHAR
-#define PR_OP_CAS_CHAR PR_OP_CAS
+#ifdef CK_F_PR_CAS_SHORT
+#define PR_OP_CAS_SHORT(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_CHAR_VALUE
-#define PR_OP_CAS_VALUE_CHAR PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_UINT
+#define PR_OP_CAS_UINT(X, ...) \
+	X(CAS,   ,       cas,   ,         TERNARY_CAS,        __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_DOUBLE
-#define PR_OP_CAS_DOUBLE PR_OP_CAS
+#ifdef CK_F_PR_CAS_8_VALUE
+#define PR_OP_CAS_VALUE_8(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_DOUBLE_VALUE
-#define PR_OP_CAS_VALUE_DOUBLE PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_16_VALUE
+#define PR_OP_CAS_VALUE_16(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_INT
-#define PR_OP_CAS_INT PR_OP_CAS
+#ifdef CK_F_PR_CAS_32_VALUE
+#define PR_OP_CAS_VALUE_32(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_INT_VALUE
-#define PR_OP_CAS_VALUE_INT PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_64_VALUE
+#define PR_OP_CAS_VALUE_64(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_PTR
-#define PR_OP_CAS_PTR PR_OP_CAS
+#ifdef CK_F_PR_CAS_CHAR_VALUE
+#define PR_OP_CAS_VALUE_CHAR(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_PTR_VALUE
-#define PR_OP_CAS_VALUE_PTR PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_DOUBLE_VALUE
+#define PR_OP_CAS_VALUE_DOUBLE(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_SHORT
-#define PR_OP_CAS_SHORT PR_OP_CAS
+#ifdef CK_F_PR_CAS_INT_VALUE
+#define PR_OP_CAS_VALUE_INT(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_SHORT_VALUE
-#define PR_OP_CAS_VALUE_SHORT PR_OP_CAS_VALUE
+#ifdef CK_F_PR_CAS_PTR_VALUE
+#define PR_OP_CAS_VALUE_PTR(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_CAS_UINT
-#define PR_OP_CAS_UINT PR_OP_CAS
+#ifdef CK_F_PR_CAS_SHORT_VALUE
+#define PR_OP_CAS_VALUE_SHORT(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_CAS_UINT_VALUE
-#define PR_OP_CAS_VALUE_UINT PR_OP_CAS_VALUE
+#define PR_OP_CAS_VALUE_UINT(X, ...) \
+	X(CAS,   _VALUE, cas,   _value,   TERNARY_CAS_VALUE,  __VA_ARGS__)
 #else
-#define PR_OP_CAS_VALUE_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_CAS_VALUE_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_DEC_8
-#define PR_OP_DEC_8 PR_OP_DEC
+#define PR_OP_DEC_8(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_8_ZERO
-#define PR_OP_DEC_Z_8 PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_16
+#define PR_OP_DEC_16(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_16
-#define PR_OP_DEC_16 PR_OP_DEC
+#ifdef CK_F_PR_DEC_32
+#define PR_OP_DEC_32(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_16_ZERO
-#define PR_OP_DEC_Z_16 PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_64
+#define PR_OP_DEC_64(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_32
-#define PR_OP_DEC_32 PR_OP_DEC
+#ifdef CK_F_PR_DEC_CHAR
+#define PR_OP_DEC_CHAR(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_32_ZERO
-#define PR_OP_DEC_Z_32 PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_DOUBLE
+#define PR_OP_DEC_DOUBLE(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_64
-#define PR_OP_DEC_64 PR_OP_DEC
+#ifdef CK_F_PR_DEC_INT
+#define PR_OP_DEC_INT(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_64_ZERO
-#define PR_OP_DEC_Z_64 PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_PTR
+#define PR_OP_DEC_PTR(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_CHAR
-#define PR_OP_DEC_CHAR PR_OP_DEC
+#ifdef CK_F_PR_DEC_SHORT
+#define PR_OP_DEC_SHORT(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_CHAR_ZERO
-#define PR_OP_DEC_Z_CHAR PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_UINT
+#define PR_OP_DEC_UINT(X, ...) \
+	X(DEC,   ,       dec,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_DOUBLE
-#define PR_OP_DEC_DOUBLE PR_OP_DEC
+#ifdef CK_F_PR_DEC_8_ZERO
+#define PR_OP_DEC_ZERO_8(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_INT
-#define PR_OP_DEC_INT PR_OP_DEC
+#ifdef CK_F_PR_DEC_16_ZERO
+#define PR_OP_DEC_ZERO_16(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_INT_ZERO
-#define PR_OP_DEC_Z_INT PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_32_ZERO
+#define PR_OP_DEC_ZERO_32(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_PTR
-#define PR_OP_DEC_PTR PR_OP_DEC
+#ifdef CK_F_PR_DEC_64_ZERO
+#define PR_OP_DEC_ZERO_64(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_PTR_ZERO
-#define PR_OP_DEC_Z_PTR PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_CHAR_ZERO
+#define PR_OP_DEC_ZERO_CHAR(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_SHORT
-#define PR_OP_DEC_SHORT PR_OP_DEC
+#ifdef CK_F_PR_DEC_DOUBLE_ZERO
+#define PR_OP_DEC_ZERO_DOUBLE(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_SHORT_ZERO
-#define PR_OP_DEC_Z_SHORT PR_OP_DEC_Z
+#ifdef CK_F_PR_DEC_INT_ZERO
+#define PR_OP_DEC_ZERO_INT(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_DEC_UINT
-#define PR_OP_DEC_UINT PR_OP_DEC
+#ifdef CK_F_PR_DEC_PTR_ZERO
+#define PR_OP_DEC_ZERO_PTR(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_DEC_SHORT_ZERO
+#define PR_OP_DEC_ZERO_SHORT(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
+#else
+#define PR_OP_DEC_ZERO_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_DEC_UINT_ZERO
-#define PR_OP_DEC_Z_UINT PR_OP_DEC_Z
+#define PR_OP_DEC_ZERO_UINT(X, ...) \
+	X(DEC,   _ZERO,  dec,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_DEC_Z_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_DEC_ZERO_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_8
-#define PR_OP_FAA_8 PR_OP_FAA
+#define PR_OP_FAA_8(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_16
-#define PR_OP_FAA_16 PR_OP_FAA
+#define PR_OP_FAA_16(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_32
-#define PR_OP_FAA_32 PR_OP_FAA
+#define PR_OP_FAA_32(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_64
-#define PR_OP_FAA_64 PR_OP_FAA
+#define PR_OP_FAA_64(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_CHAR
-#define PR_OP_FAA_CHAR PR_OP_FAA
+#define PR_OP_FAA_CHAR(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_DOUBLE
-#define PR_OP_FAA_DOUBLE PR_OP_FAA
+#define PR_OP_FAA_DOUBLE(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_INT
-#define PR_OP_FAA_INT PR_OP_FAA
+#define PR_OP_FAA_INT(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_PTR
-#define PR_OP_FAA_PTR PR_OP_FAA
+#define PR_OP_FAA_PTR(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_SHORT
-#define PR_OP_FAA_SHORT PR_OP_FAA
+#define PR_OP_FAA_SHORT(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAA_UINT
-#define PR_OP_FAA_UINT PR_OP_FAA
+#define PR_OP_FAA_UINT(X, ...) \
+	X(FAA,   ,       faa,   ,         BINARY_FAA,         __VA_ARGS__)
 #else
-#define PR_OP_FAA_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAA_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_8
-#define PR_OP_FAS_8 PR_OP_FAS
+#define PR_OP_FAS_8(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_16
-#define PR_OP_FAS_16 PR_OP_FAS
+#define PR_OP_FAS_16(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_32
-#define PR_OP_FAS_32 PR_OP_FAS
+#define PR_OP_FAS_32(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_64
-#define PR_OP_FAS_64 PR_OP_FAS
+#define PR_OP_FAS_64(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_CHAR
-#define PR_OP_FAS_CHAR PR_OP_FAS
+#define PR_OP_FAS_CHAR(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_DOUBLE
-#define PR_OP_FAS_DOUBLE PR_OP_FAS
+#define PR_OP_FAS_DOUBLE(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_INT
-#define PR_OP_FAS_INT PR_OP_FAS
+#define PR_OP_FAS_INT(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_PTR
-#define PR_OP_FAS_PTR PR_OP_FAS
+#define PR_OP_FAS_PTR(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_SHORT
-#define PR_OP_FAS_SHORT PR_OP_FAS
+#define PR_OP_FAS_SHORT(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_FAS_UINT
-#define PR_OP_FAS_UINT PR_OP_FAS
+#define PR_OP_FAS_UINT(X, ...) \
+	X(FAS,   ,       fas,   ,         BINARY_FAS,         __VA_ARGS__)
 #else
-#define PR_OP_FAS_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_FAS_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_INC_8
-#define PR_OP_INC_8 PR_OP_INC
+#define PR_OP_INC_8(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_8_ZERO
-#define PR_OP_INC_Z_8 PR_OP_INC_Z
+#ifdef CK_F_PR_INC_16
+#define PR_OP_INC_16(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_16
-#define PR_OP_INC_16 PR_OP_INC
+#ifdef CK_F_PR_INC_32
+#define PR_OP_INC_32(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_16_ZERO
-#define PR_OP_INC_Z_16 PR_OP_INC_Z
+#ifdef CK_F_PR_INC_64
+#define PR_OP_INC_64(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_32
-#define PR_OP_INC_32 PR_OP_INC
+#ifdef CK_F_PR_INC_CHAR
+#define PR_OP_INC_CHAR(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_32_ZERO
-#define PR_OP_INC_Z_32 PR_OP_INC_Z
+#ifdef CK_F_PR_INC_DOUBLE
+#define PR_OP_INC_DOUBLE(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_64
-#define PR_OP_INC_64 PR_OP_INC
+#ifdef CK_F_PR_INC_INT
+#define PR_OP_INC_INT(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_64_ZERO
-#define PR_OP_INC_Z_64 PR_OP_INC_Z
+#ifdef CK_F_PR_INC_PTR
+#define PR_OP_INC_PTR(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_CHAR
-#define PR_OP_INC_CHAR PR_OP_INC
+#ifdef CK_F_PR_INC_SHORT
+#define PR_OP_INC_SHORT(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_CHAR_ZERO
-#define PR_OP_INC_Z_CHAR PR_OP_INC_Z
+#ifdef CK_F_PR_INC_UINT
+#define PR_OP_INC_UINT(X, ...) \
+	X(INC,   ,       inc,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_DOUBLE
-#define PR_OP_INC_DOUBLE PR_OP_INC
+#ifdef CK_F_PR_INC_8_ZERO
+#define PR_OP_INC_ZERO_8(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_INT
-#define PR_OP_INC_INT PR_OP_INC
+#ifdef CK_F_PR_INC_16_ZERO
+#define PR_OP_INC_ZERO_16(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_INT_ZERO
-#define PR_OP_INC_Z_INT PR_OP_INC_Z
+#ifdef CK_F_PR_INC_32_ZERO
+#define PR_OP_INC_ZERO_32(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_PTR
-#define PR_OP_INC_PTR PR_OP_INC
+#ifdef CK_F_PR_INC_64_ZERO
+#define PR_OP_INC_ZERO_64(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_PTR_ZERO
-#define PR_OP_INC_Z_PTR PR_OP_INC_Z
+#ifdef CK_F_PR_INC_CHAR_ZERO
+#define PR_OP_INC_ZERO_CHAR(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_SHORT
-#define PR_OP_INC_SHORT PR_OP_INC
+#ifdef CK_F_PR_INC_DOUBLE_ZERO
+#define PR_OP_INC_ZERO_DOUBLE(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_SHORT_ZERO
-#define PR_OP_INC_Z_SHORT PR_OP_INC_Z
+#ifdef CK_F_PR_INC_INT_ZERO
+#define PR_OP_INC_ZERO_INT(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_INC_UINT
-#define PR_OP_INC_UINT PR_OP_INC
+#ifdef CK_F_PR_INC_PTR_ZERO
+#define PR_OP_INC_ZERO_PTR(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_INC_SHORT_ZERO
+#define PR_OP_INC_ZERO_SHORT(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
+#else
+#define PR_OP_INC_ZERO_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_INC_UINT_ZERO
-#define PR_OP_INC_Z_UINT PR_OP_INC_Z
+#define PR_OP_INC_ZERO_UINT(X, ...) \
+	X(INC,   _ZERO,  inc,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_INC_Z_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_INC_ZERO_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_8
-#define PR_OP_LOAD_8 PR_OP_LOAD
+#define PR_OP_LOAD_8(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_16
-#define PR_OP_LOAD_16 PR_OP_LOAD
+#define PR_OP_LOAD_16(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_32
-#define PR_OP_LOAD_32 PR_OP_LOAD
+#define PR_OP_LOAD_32(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_64
-#define PR_OP_LOAD_64 PR_OP_LOAD
+#define PR_OP_LOAD_64(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_CHAR
-#define PR_OP_LOAD_CHAR PR_OP_LOAD
+#define PR_OP_LOAD_CHAR(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_DOUBLE
-#define PR_OP_LOAD_DOUBLE PR_OP_LOAD
+#define PR_OP_LOAD_DOUBLE(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_INT
-#define PR_OP_LOAD_INT PR_OP_LOAD
+#define PR_OP_LOAD_INT(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_PTR
-#define PR_OP_LOAD_PTR PR_OP_LOAD
+#define PR_OP_LOAD_PTR(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_SHORT
-#define PR_OP_LOAD_SHORT PR_OP_LOAD
+#define PR_OP_LOAD_SHORT(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_LOAD_UINT
-#define PR_OP_LOAD_UINT PR_OP_LOAD
+#define PR_OP_LOAD_UINT(X, ...) \
+	X(LOAD,  ,       load,  ,         UNARY_LOAD,         __VA_ARGS__)
 #else
-#define PR_OP_LOAD_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_LOAD_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NEG_8
-#define PR_OP_NEG_8 PR_OP_NEG
+#define PR_OP_NEG_8(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_8_ZERO
-#define PR_OP_NEG_Z_8 PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_16
+#define PR_OP_NEG_16(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_16
-#define PR_OP_NEG_16 PR_OP_NEG
+#ifdef CK_F_PR_NEG_32
+#define PR_OP_NEG_32(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_16_ZERO
-#define PR_OP_NEG_Z_16 PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_64
+#define PR_OP_NEG_64(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_32
-#define PR_OP_NEG_32 PR_OP_NEG
+#ifdef CK_F_PR_NEG_CHAR
+#define PR_OP_NEG_CHAR(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_32_ZERO
-#define PR_OP_NEG_Z_32 PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_DOUBLE
+#define PR_OP_NEG_DOUBLE(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_64
-#define PR_OP_NEG_64 PR_OP_NEG
+#ifdef CK_F_PR_NEG_INT
+#define PR_OP_NEG_INT(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_64_ZERO
-#define PR_OP_NEG_Z_64 PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_PTR
+#define PR_OP_NEG_PTR(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_CHAR
-#define PR_OP_NEG_CHAR PR_OP_NEG
+#ifdef CK_F_PR_NEG_SHORT
+#define PR_OP_NEG_SHORT(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_CHAR_ZERO
-#define PR_OP_NEG_Z_CHAR PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_UINT
+#define PR_OP_NEG_UINT(X, ...) \
+	X(NEG,   ,       neg,   ,         UNARY_ARITHMETIC,   __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_DOUBLE
-#define PR_OP_NEG_DOUBLE PR_OP_NEG
+#ifdef CK_F_PR_NEG_8_ZERO
+#define PR_OP_NEG_ZERO_8(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_INT
-#define PR_OP_NEG_INT PR_OP_NEG
+#ifdef CK_F_PR_NEG_16_ZERO
+#define PR_OP_NEG_ZERO_16(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_INT_ZERO
-#define PR_OP_NEG_Z_INT PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_32_ZERO
+#define PR_OP_NEG_ZERO_32(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_PTR
-#define PR_OP_NEG_PTR PR_OP_NEG
+#ifdef CK_F_PR_NEG_64_ZERO
+#define PR_OP_NEG_ZERO_64(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_PTR_ZERO
-#define PR_OP_NEG_Z_PTR PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_CHAR_ZERO
+#define PR_OP_NEG_ZERO_CHAR(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_SHORT
-#define PR_OP_NEG_SHORT PR_OP_NEG
+#ifdef CK_F_PR_NEG_DOUBLE_ZERO
+#define PR_OP_NEG_ZERO_DOUBLE(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_SHORT_ZERO
-#define PR_OP_NEG_Z_SHORT PR_OP_NEG_Z
+#ifdef CK_F_PR_NEG_INT_ZERO
+#define PR_OP_NEG_ZERO_INT(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#ifdef CK_F_PR_NEG_UINT
-#define PR_OP_NEG_UINT PR_OP_NEG
+#ifdef CK_F_PR_NEG_PTR_ZERO
+#define PR_OP_NEG_ZERO_PTR(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
+#else
+#define PR_OP_NEG_ZERO_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_NEG_SHORT_ZERO
+#define PR_OP_NEG_ZERO_SHORT(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NEG_UINT_ZERO
-#define PR_OP_NEG_Z_UINT PR_OP_NEG_Z
+#define PR_OP_NEG_ZERO_UINT(X, ...) \
+	X(NEG,   _ZERO,  neg,   _is_zero, UNARY_ARITHMETIC_Z, __VA_ARGS__)
 #else
-#define PR_OP_NEG_Z_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_NEG_ZERO_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_8
-#define PR_OP_NOT_8 PR_OP_NOT
+#define PR_OP_NOT_8(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_16
-#define PR_OP_NOT_16 PR_OP_NOT
+#define PR_OP_NOT_16(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_32
-#define PR_OP_NOT_32 PR_OP_NOT
+#define PR_OP_NOT_32(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_64
-#define PR_OP_NOT_64 PR_OP_NOT
+#define PR_OP_NOT_64(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_CHAR
-#define PR_OP_NOT_CHAR PR_OP_NOT
+#define PR_OP_NOT_CHAR(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
+#else
+#define PR_OP_NOT_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_NOT_DOUBLE
+#define PR_OP_NOT_DOUBLE(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_INT
-#define PR_OP_NOT_INT PR_OP_NOT
+#define PR_OP_NOT_INT(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_PTR
-#define PR_OP_NOT_PTR PR_OP_NOT
+#define PR_OP_NOT_PTR(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_SHORT
-#define PR_OP_NOT_SHORT PR_OP_NOT
+#define PR_OP_NOT_SHORT(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_NOT_UINT
-#define PR_OP_NOT_UINT PR_OP_NOT
+#define PR_OP_NOT_UINT(X, ...) \
+	X(NOT,   ,       not,   ,         UNARY_BITWISE,      __VA_ARGS__)
 #else
-#define PR_OP_NOT_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_NOT_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_8
-#define PR_OP_OR_8 PR_OP_OR
+#define PR_OP_OR_8(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_16
-#define PR_OP_OR_16 PR_OP_OR
+#define PR_OP_OR_16(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_32
-#define PR_OP_OR_32 PR_OP_OR
+#define PR_OP_OR_32(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_64
-#define PR_OP_OR_64 PR_OP_OR
+#define PR_OP_OR_64(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_CHAR
-#define PR_OP_OR_CHAR PR_OP_OR
+#define PR_OP_OR_CHAR(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
+#else
+#define PR_OP_OR_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_OR_DOUBLE
+#define PR_OP_OR_DOUBLE(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_INT
-#define PR_OP_OR_INT PR_OP_OR
+#define PR_OP_OR_INT(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_PTR
-#define PR_OP_OR_PTR PR_OP_OR
+#define PR_OP_OR_PTR(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_SHORT
-#define PR_OP_OR_SHORT PR_OP_OR
+#define PR_OP_OR_SHORT(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_OR_UINT
-#define PR_OP_OR_UINT PR_OP_OR
+#define PR_OP_OR_UINT(X, ...) \
+	X(OR,    ,       or,    ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_OR_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_OR_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_8
-#define PR_OP_STORE_8 PR_OP_STORE
+#define PR_OP_STORE_8(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_16
-#define PR_OP_STORE_16 PR_OP_STORE
+#define PR_OP_STORE_16(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_32
-#define PR_OP_STORE_32 PR_OP_STORE
+#define PR_OP_STORE_32(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_64
-#define PR_OP_STORE_64 PR_OP_STORE
+#define PR_OP_STORE_64(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_CHAR
-#define PR_OP_STORE_CHAR PR_OP_STORE
+#define PR_OP_STORE_CHAR(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_DOUBLE
-#define PR_OP_STORE_DOUBLE PR_OP_STORE
+#define PR_OP_STORE_DOUBLE(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_INT
-#define PR_OP_STORE_INT PR_OP_STORE
+#define PR_OP_STORE_INT(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_PTR
-#define PR_OP_STORE_PTR PR_OP_STORE
+#define PR_OP_STORE_PTR(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_SHORT
-#define PR_OP_STORE_SHORT PR_OP_STORE
+#define PR_OP_STORE_SHORT(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_STORE_UINT
-#define PR_OP_STORE_UINT PR_OP_STORE
+#define PR_OP_STORE_UINT(X, ...) \
+	X(STORE, ,       store, ,         UNARY_STORE,        __VA_ARGS__)
 #else
-#define PR_OP_STORE_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_STORE_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_8
-#define PR_OP_SUB_8 PR_OP_SUB
+#define PR_OP_SUB_8(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_16
-#define PR_OP_SUB_16 PR_OP_SUB
+#define PR_OP_SUB_16(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_32
-#define PR_OP_SUB_32 PR_OP_SUB
+#define PR_OP_SUB_32(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_64
-#define PR_OP_SUB_64 PR_OP_SUB
+#define PR_OP_SUB_64(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_CHAR
-#define PR_OP_SUB_CHAR PR_OP_SUB
+#define PR_OP_SUB_CHAR(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_DOUBLE
-#define PR_OP_SUB_DOUBLE PR_OP_SUB
+#define PR_OP_SUB_DOUBLE(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_DOUBLE PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_INT
-#define PR_OP_SUB_INT PR_OP_SUB
+#define PR_OP_SUB_INT(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_PTR
-#define PR_OP_SUB_PTR PR_OP_SUB
+#define PR_OP_SUB_PTR(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_SHORT
-#define PR_OP_SUB_SHORT PR_OP_SUB
+#define PR_OP_SUB_SHORT(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_SUB_UINT
-#define PR_OP_SUB_UINT PR_OP_SUB
+#define PR_OP_SUB_UINT(X, ...) \
+	X(SUB,   ,       sub,   ,         BINARY_ARITHMETIC,  __VA_ARGS__)
 #else
-#define PR_OP_SUB_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_SUB_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_8
-#define PR_OP_XOR_8 PR_OP_XOR
+#define PR_OP_XOR_8(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_8 PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_8(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_16
-#define PR_OP_XOR_16 PR_OP_XOR
+#define PR_OP_XOR_16(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_16 PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_16(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_32
-#define PR_OP_XOR_32 PR_OP_XOR
+#define PR_OP_XOR_32(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_32 PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_32(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_64
-#define PR_OP_XOR_64 PR_OP_XOR
+#define PR_OP_XOR_64(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_64 PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_64(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_CHAR
-#define PR_OP_XOR_CHAR PR_OP_XOR
+#define PR_OP_XOR_CHAR(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
+#else
+#define PR_OP_XOR_CHAR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
+#endif
+
+#ifdef CK_F_PR_XOR_DOUBLE
+#define PR_OP_XOR_DOUBLE(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_CHAR PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_DOUBLE(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_INT
-#define PR_OP_XOR_INT PR_OP_XOR
+#define PR_OP_XOR_INT(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_INT PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_INT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_PTR
-#define PR_OP_XOR_PTR PR_OP_XOR
+#define PR_OP_XOR_PTR(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_PTR PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_PTR(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_SHORT
-#define PR_OP_XOR_SHORT PR_OP_XOR
+#define PR_OP_XOR_SHORT(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_SHORT PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_SHORT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
 #ifdef CK_F_PR_XOR_UINT
-#define PR_OP_XOR_UINT PR_OP_XOR
+#define PR_OP_XOR_UINT(X, ...) \
+	X(XOR,   ,       xor,   ,         BINARY_BITWISE,     __VA_ARGS__)
 #else
-#define PR_OP_XOR_UINT PR_OP_UNIMPLEMENTED
+#define PR_OP_XOR_UINT(X, ...) PR_OP_UNIMPLEMENTED(X, __VA_ARGS__)
 #endif
 
-#define PR_OPS_GROUP1(X, ...) \
-	X(ADD, __VA_ARGS__) \
-	X(CAS, __VA_ARGS__) \
-	X(CAS_VALUE, __VA_ARGS__) \
-	X(DEC, __VA_ARGS__) \
-	X(FAA, __VA_ARGS__) \
-	X(FAS, __VA_ARGS__) \
-	X(INC, __VA_ARGS__) \
-	X(LOAD, __VA_ARGS__) \
-	X(NEG, __VA_ARGS__) \
-	X(STORE, __VA_ARGS__) \
-	X(SUB, __VA_ARGS__)
-
-#define PR_OPS_GROUP2(X, ...) \
-	X(ADD, __VA_ARGS__) \
-	X(AND, __VA_ARGS__) \
-	X(CAS, __VA_ARGS__) \
-	X(CAS_VALUE, __VA_ARGS__) \
-	X(DEC, __VA_ARGS__) \
-	X(DEC_Z, __VA_ARGS__) \
-	X(FAA, __VA_ARGS__) \
-	X(FAS, __VA_ARGS__) \
-	X(INC, __VA_ARGS__) \
-	X(INC_Z, __VA_ARGS__) \
-	X(LOAD, __VA_ARGS__) \
-	X(NEG, __VA_ARGS__) \
-	X(NEG_Z, __VA_ARGS__) \
-	X(NOT, __VA_ARGS__) \
-	X(OR, __VA_ARGS__) \
-	X(STORE, __VA_ARGS__) \
-	X(SUB, __VA_ARGS__) \
-	X(XOR, __VA_ARGS__)
-
-#define PR_OPS_GROUP3(X, ...) \
+#define PR_OPS_KEYS(X, ...) \
 	X(ADD, __VA_ARGS__) \
 	X(AND, __VA_ARGS__) \
 	X(BTC, __VA_ARGS__) \
@@ -1265,14 +1561,14 @@
 	X(CAS, __VA_ARGS__) \
 	X(CAS_VALUE, __VA_ARGS__) \
 	X(DEC, __VA_ARGS__) \
-	X(DEC_Z, __VA_ARGS__) \
+	X(DEC_ZERO, __VA_ARGS__) \
 	X(FAA, __VA_ARGS__) \
 	X(FAS, __VA_ARGS__) \
 	X(INC, __VA_ARGS__) \
-	X(INC_Z, __VA_ARGS__) \
+	X(INC_ZERO, __VA_ARGS__) \
 	X(LOAD, __VA_ARGS__) \
 	X(NEG, __VA_ARGS__) \
-	X(NEG_Z, __VA_ARGS__) \
+	X(NEG_ZERO, __VA_ARGS__) \
 	X(NOT, __VA_ARGS__) \
 	X(OR, __VA_ARGS__) \
 	X(STORE, __VA_ARGS__) \
@@ -1283,18 +1579,18 @@
 	PR_OP_##OP(X, __VA_ARGS__)
 
 #define PR_OPS_LIST(X, ...) \
-	PR_OPS_GROUP3(PR_OP_EXPANDER, X, __VA_ARGS__)
-
-#define PR_8_OPS_LIST      PR_OPS_GROUP2
-#define PR_16_OPS_LIST     PR_OPS_GROUP3
-#define PR_32_OPS_LIST     PR_OPS_GROUP3
-#define PR_64_OPS_LIST     PR_OPS_GROUP3
-#define PR_CHAR_OPS_LIST   PR_OPS_GROUP2
-#define PR_DOUBLE_OPS_LIST PR_OPS_GROUP1
-#define PR_INT_OPS_LIST    PR_OPS_GROUP3
-#define PR_PTR_OPS_LIST    PR_OPS_GROUP3
-#define PR_SHORT_OPS_LIST  PR_OPS_GROUP2
-#define PR_UINT_OPS_LIST   PR_OPS_GROUP3
+	PR_OPS_KEYS(PR_OP_EXPANDER, X, __VA_ARGS__)
+
+#define PR_8_OPS_LIST      PR_OPS_KEYS
+#define PR_16_OPS_LIST     PR_OPS_KEYS
+#define PR_32_OPS_LIST     PR_OPS_KEYS
+#define PR_64_OPS_LIST     PR_OPS_KEYS
+#define PR_CHAR_OPS_LIST   PR_OPS_KEYS
+#define PR_DOUBLE_OPS_LIST PR_OPS_KEYS
+#define PR_INT_OPS_LIST    PR_OPS_KEYS
+#define PR_PTR_OPS_LIST    PR_OPS_KEYS
+#define PR_SHORT_OPS_LIST  PR_OPS_KEYS
+#define PR_UINT_OPS_LIST   PR_OPS_KEYS
 
 /*         FT                 CKT     CT            DT            ... */
 #define PR_8_T(X, ...)      X(8,      uint8_t,      uint8_t,      __VA_ARGS__)
@@ -1338,35 +1634,30 @@
 	X(CAS,  _VALUE, N, cas,  _value, TERNARY_CAS_VALUE, __VA_ARGS__)
 #define PR128_OP_LOAD_N(X, N, ...) \
 	X(LOAD, ,       N, load, ,       UNARY_LOAD,        __VA_ARGS__)
-
 #define PR128_OP_CAS_2(X, ...) \
 	PR128_OP_CAS_N(X, 2, __VA_ARGS__)
 #define PR128_OP_CAS_VALUE_2(X, ...) \
 	PR128_OP_CAS_VALUE_N(X, 2, __VA_ARGS__)
 #define PR128_OP_LOAD_2(X, ...) \
 	PR128_OP_LOAD_N(X, 2, __VA_ARGS__)
-
 #define PR128_OP_CAS_4(X, ...) \
 	PR128_OP_CAS_N(X, 4, __VA_ARGS__)
 #define PR128_OP_CAS_VALUE_4(X, ...) \
 	PR128_OP_CAS_VALUE_N(X, 4, __VA_ARGS__)
 #define PR128_OP_LOAD_4(X, ...) \
 	PR128_OP_LOAD_N(X, 4, __VA_ARGS__)
-
 #define PR128_OP_CAS_8(X, ...) \
 	PR128_OP_CAS_N(X, 8, __VA_ARGS__)
 #define PR128_OP_CAS_VALUE_8(X, ...) \
 	PR128_OP_CAS_VALUE_N(X, 8, __VA_ARGS__)
 #define PR128_OP_LOAD_8(X, ...) \
 	PR128_OP_LOAD_N(X, 8, __VA_ARGS__)
-
 #define PR128_OP_CAS_16(X, ...) \
 	PR128_OP_CAS_N(X, 16, __VA_ARGS__)
 #define PR128_OP_CAS_VALUE_16(X, ...) \
 	PR128_OP_CAS_VALUE_N(X, 16, __VA_ARGS__)
 #define PR128_OP_LOAD_16(X, ...) \
 	PR128_OP_LOAD_N(X, 16, __VA_ARGS__)
-
 #define PR128_OP_UNIMPLEMENTED(X, ...)
 
 #ifdef CK_F_PR_CAS_8_16
@@ -1375,102 +1666,102 @@
 #define PR128_OP_CAS_16_8 PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_8_16_VALUE
-#define PR128_OP_CAS_VALUE_16_8 PR128_OP_CAS_VALUE_16
-#else
-#define PR128_OP_CAS_VALUE_16_8 PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_16_8
 #define PR128_OP_CAS_8_16 PR128_OP_CAS_8
 #else
 #define PR128_OP_CAS_8_16 PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_16_8_VALUE
-#define PR128_OP_CAS_VALUE_8_16 PR128_OP_CAS_VALUE_8
-#else
-#define PR128_OP_CAS_VALUE_8_16 PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_32_4
 #define PR128_OP_CAS_4_32 PR128_OP_CAS_4
 #else
 #define PR128_OP_CAS_4_32 PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_32_4_VALUE
-#define PR128_OP_CAS_VALUE_4_32 PR128_OP_CAS_VALUE_4
-#else
-#define PR128_OP_CAS_VALUE_4_32 PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_64_2
 #define PR128_OP_CAS_2_64 PR128_OP_CAS_2
 #else
 #define PR128_OP_CAS_2_64 PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_64_2_VALUE
-#define PR128_OP_CAS_VALUE_2_64 PR128_OP_CAS_VALUE_2
-#else
-#define PR128_OP_CAS_VALUE_2_64 PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_CHAR_16
 #define PR128_OP_CAS_16_CHAR PR128_OP_CAS_16
 #else
 #define PR128_OP_CAS_16_CHAR PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_CHAR_16_VALUE
-#define PR128_OP_CAS_VALUE_16_CHAR PR128_OP_CAS_VALUE_16
-#else
-#define PR128_OP_CAS_VALUE_16_CHAR PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_DOUBLE_2
 #define PR128_OP_CAS_2_DOUBLE PR128_OP_CAS_2
 #else
 #define PR128_OP_CAS_2_DOUBLE PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_DOUBLE_2_VALUE
-#define PR128_OP_CAS_VALUE_2_DOUBLE PR128_OP_CAS_VALUE_2
-#else
-#define PR128_OP_CAS_VALUE_2_DOUBLE PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_INT_4
 #define PR128_OP_CAS_4_INT PR128_OP_CAS_4
 #else
 #define PR128_OP_CAS_4_INT PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_INT_4_VALUE
-#define PR128_OP_CAS_VALUE_4_INT PR128_OP_CAS_VALUE_4
-#else
-#define PR128_OP_CAS_VALUE_4_INT PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_PTR_2
 #define PR128_OP_CAS_2_PTR PR128_OP_CAS_2
 #else
 #define PR128_OP_CAS_2_PTR PR128_OP_UNIMPLEMENTED
 #endif
 
-#ifdef CK_F_PR_CAS_PTR_2_VALUE
-#define PR128_OP_CAS_VALUE_2_PTR PR128_OP_CAS_VALUE_2
-#else
-#define PR128_OP_CAS_VALUE_2_PTR PR128_OP_UNIMPLEMENTED
-#endif
-
 #ifdef CK_F_PR_CAS_UINT_4
 #define PR128_OP_CAS_4_UINT PR128_OP_CAS_4
 #else
 #define PR128_OP_CAS_4_UINT PR128_OP_UNIMPLEMENTED
 #endif
 
+#ifdef CK_F_PR_CAS_8_16_VALUE
+#define PR128_OP_CAS_VALUE_16_8 PR128_OP_CAS_VALUE_16
+#else
+#define PR128_OP_CAS_VALUE_16_8 PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_16_8_VALUE
+#define PR128_OP_CAS_VALUE_8_16 PR128_OP_CAS_VALUE_8
+#else
+#define PR128_OP_CAS_VALUE_8_16 PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_32_4_VALUE
+#define PR128_OP_CAS_VALUE_4_32 PR128_OP_CAS_VALUE_4
+#else
+#define PR128_OP_CAS_VALUE_4_32 PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_64_2_VALUE
+#define PR128_OP_CAS_VALUE_2_64 PR128_OP_CAS_VALUE_2
+#else
+#define PR128_OP_CAS_VALUE_2_64 PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_CHAR_16_VALUE
+#define PR128_OP_CAS_VALUE_16_CHAR PR128_OP_CAS_VALUE_16
+#else
+#define PR128_OP_CAS_VALUE_16_CHAR PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_DOUBLE_2_VALUE
+#define PR128_OP_CAS_VALUE_2_DOUBLE PR128_OP_CAS_VALUE_2
+#else
+#define PR128_OP_CAS_VALUE_2_DOUBLE PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_INT_4_VALUE
+#define PR128_OP_CAS_VALUE_4_INT PR128_OP_CAS_VALUE_4
+#else
+#define PR128_OP_CAS_VALUE_4_INT PR128_OP_UNIMPLEMENTED
+#endif
+
+#ifdef CK_F_PR_CAS_PTR_2_VALUE
+#define PR128_OP_CAS_VALUE_2_PTR PR128_OP_CAS_VALUE_2
+#else
+#define PR128_OP_CAS_VALUE_2_PTR PR128_OP_UNIMPLEMENTED
+#endif
+
 #ifdef CK_F_PR_CAS_UINT_4_VALUE
 #define PR128_OP_CAS_VALUE_4_UINT PR128_OP_CAS_VALUE_4
 #else
@@ -1507,6 +1798,12 @@
 #define PR128_OP_LOAD_16_CHAR PR128_OP_UNIMPLEMENTED
 #endif
 
+#ifdef CK_F_PR_LOAD_DOUBLE_2
+#define PR128_OP_LOAD_2_DOUBLE PR128_OP_LOAD_2
+#else
+#define PR128_OP_LOAD_2_DOUBLE PR128_OP_UNIMPLEMENTED
+#endif
+
 #ifdef CK_F_PR_LOAD_INT_4
 #define PR128_OP_LOAD_4_INT PR128_OP_LOAD_4
 #else
@@ -1525,34 +1822,34 @@
 #define PR128_OP_LOAD_4_UINT PR128_OP_UNIMPLEMENTED
 #endif
 
-#define PR128_OPS_GROUP1(X, ...) \
-	X(CAS_16,       __VA_ARGS__) \
+#define PR128_OPS_2(X, ...) \
+	X(CAS_2, __VA_ARGS__) \
+	X(CAS_VALUE_2, __VA_ARGS__) \
+	X(LOAD_2, __VA_ARGS__)
+
+#define PR128_OPS_4(X, ...) \
+	X(CAS_4, __VA_ARGS__) \
+	X(CAS_VALUE_4, __VA_ARGS__) \
+	X(LOAD_4, __VA_ARGS__)
+
+#define PR128_OPS_8(X, ...) \
+	X(CAS_8, __VA_ARGS__) \
+	X(CAS_VALUE_8, __VA_ARGS__) \
+	X(LOAD_8, __VA_ARGS__)
+
+#define PR128_OPS_16(X, ...) \
+	X(CAS_16, __VA_ARGS__) \
 	X(CAS_VALUE_16, __VA_ARGS__) \
-	X(LOAD_16,      __VA_ARGS__)
-#define PR128_OPS_GROUP2(X, ...) \
-	X(CAS_8,        __VA_ARGS__) \
-	X(CAS_VALUE_8,  __VA_ARGS__) \
-	X(LOAD_8,       __VA_ARGS__)
-#define PR128_OPS_GROUP3(X, ...) \
-	X(CAS_4,        __VA_ARGS__) \
-	X(CAS_VALUE_4,  __VA_ARGS__) \
-	X(LOAD_4,       __VA_ARGS__)
-#define PR128_OPS_GROUP4(X, ...) \
-	X(CAS_2,        __VA_ARGS__) \
-	X(CAS_VALUE_2,  __VA_ARGS__) \
-	X(LOAD_2,       __VA_ARGS__)
-#define PR128_OPS_GROUP5(X, ...) \
-	X(CAS_2,        __VA_ARGS__)
+	X(LOAD_16, __VA_ARGS__)
 
 #define PR128_OP_EXPANDER(OP, X, ...) \
 	PR128_OP_##OP(X, __VA_ARGS__)
 
 #define PR128_OPS_LIST(X, ...) \
-	PR128_OPS_GROUP1(PR128_OP_EXPANDER, X, __VA_ARGS__) \
-	PR128_OPS_GROUP2(PR128_OP_EXPANDER, X, __VA_ARGS__) \
-	PR128_OPS_GROUP3(PR128_OP_EXPANDER, X, __VA_ARGS__) \
-	PR128_OPS_GROUP4(PR128_OP_EXPANDER, X, __VA_ARGS__)
-	/* GROUP5 is a subset of GROUP4 */
+	PR128_OPS_2(PR128_OP_EXPANDER, X, __VA_ARGS__) \
+	PR128_OPS_4(PR128_OP_EXPANDER, X, __VA_ARGS__) \
+	PR128_OPS_8(PR128_OP_EXPANDER, X, __VA_ARGS__) \
+	PR128_OPS_16(PR128_OP_EXPANDER, X, __VA_ARGS__)
 
 /*        FT      N   ... */
 #define PR128_F_TYPES_LIST(X, ...) \
@@ -1572,12 +1869,12 @@
 #define PR128_TYPES_LIST(X, ...) \
 	PR128_F_TYPES_LIST(PR128_T_EXPANDER, X, __VA_ARGS__)
 
-#define PR128_8_OPS_LIST      PR128_OPS_GROUP1
-#define PR128_16_OPS_LIST     PR128_OPS_GROUP2
-#define PR128_32_OPS_LIST     PR128_OPS_GROUP3
-#define PR128_64_OPS_LIST     PR128_OPS_GROUP4
-#define PR128_CHAR_OPS_LIST   PR128_OPS_GROUP1
-#define PR128_DOUBLE_OPS_LIST PR128_OPS_GROUP5
-#define PR128_INT_OPS_LIST    PR128_OPS_GROUP3
-#define PR128_PTR_OPS_LIST    PR128_OPS_GROUP4
-#define PR128_UINT_OPS_LIST   PR128_OPS_GROUP3
+#define PR128_8_OPS_LIST      PR128_OPS_16
+#define PR128_16_OPS_LIST     PR128_OPS_8
+#define PR128_32_OPS_LIST     PR128_OPS_4
+#define PR128_64_OPS_LIST     PR128_OPS_2
+#define PR128_CHAR_OPS_LIST   PR128_OPS_16
+#define PR128_DOUBLE_OPS_LIST PR128_OPS_2
+#define PR128_INT_OPS_LIST    PR128_OPS_4
+#define PR128_PTR_OPS_LIST    PR128_OPS_2
+#define PR128_UINT_OPS_LIST   PR128_OPS_4
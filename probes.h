@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include "serde.h"
+
+/*
+ * Static probes are compiled in with -DPROBES (make WITH_DTRACE=yes).  On
+ * FreeBSD the probe macros are generated from ck_provider.d by dtrace -h, and
+ * elsewhere they are defined here with the SystemTap <sys/sdt.h> macros, which
+ * bpftrace and perf also understand.  Otherwise the macros expand to nothing,
+ * without evaluating their arguments.  See ck_provider.d for the arguments.
+ */
+#if defined(PROBES) && defined(__FreeBSD__)
+#include "ck_provider.h"
+#elif defined(PROBES)
+#include <sys/sdt.h>
+
+#define CK_RING_ENQUEUE(ring, size, type, result) \
+	DTRACE_PROBE4(ck, ring__enqueue, ring, size, type, result)
+#define CK_RING_DEQUEUE(ring, size, type, result) \
+	DTRACE_PROBE4(ck, ring__dequeue, ring, size, type, result)
+#define CK_FIFO_ENQUEUE(fifo, size, type, result) \
+	DTRACE_PROBE4(ck, fifo__enqueue, fifo, size, type, result)
+#define CK_FIFO_DEQUEUE(fifo, size, type, result) \
+	DTRACE_PROBE4(ck, fifo__dequeue, fifo, size, type, result)
+#define CK_SHARED_LOAD(shared, size, type, result) \
+	DTRACE_PROBE4(ck, shared__load, shared, size, type, result)
+#define CK_SHARED_STORE(shared, size, type) \
+	DTRACE_PROBE3(ck, shared__store, shared, size, type)
+#define CK_HP_RECLAIM(record, pending, reclaimed) \
+	DTRACE_PROBE3(ck, hp__reclaim, record, pending, reclaimed)
+#define CK_EC_WAIT(address, expected) \
+	DTRACE_PROBE2(ck, ec__wait, address, expected)
+#define CK_EC_WAKE(address) \
+	DTRACE_PROBE1(ck, ec__wake, address)
+#else
+#define CK_RING_ENQUEUE(ring, size, type, result)
+#define CK_RING_DEQUEUE(ring, size, type, result)
+#define CK_FIFO_ENQUEUE(fifo, size, type, result)
+#define CK_FIFO_DEQUEUE(fifo, size, type, result)
+#define CK_SHARED_LOAD(shared, size, type, result)
+#define CK_SHARED_STORE(shared, size, type)
+#define CK_HP_RECLAIM(record, pending, reclaimed)
+#define CK_EC_WAIT(address, expected)
+#define CK_EC_WAKE(address)
+#endif
+
+/*
+ * The size of a message from its start to the end of the value loaded from it,
+ * or 0 if the value could not be loaded.
+ */
+static inline size_t
+probe_size(const void *start, const void *end)
+{
+	return (end == NULL ? 0 : (const char *)end - (const char *)start);
+}
+
+/* The type code heading a serialized value. */
+static inline int
+probe_type(const void *p)
+{
+	serde_type_code type;
+
+	memcpy(&type, p, sizeof(type));
+	return (type);
+}
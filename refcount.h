@@ -31,8 +31,25 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <ck_cc.h>
+#include <ck_md.h>
 #include <ck_pr.h>
 
+#include "compat.h"
+
+/*
+ * Objects shared between threads declare their reference count last, aligned
+ * with CK_CC_CACHELINE, so it has a cache line to itself.  Threads taking and
+ * dropping references then do not invalidate the lines other threads are
+ * reading the object through.  Such objects must be allocated with
+ * refcount_alloc() for the alignment to hold.
+ */
+static inline void *
+refcount_alloc(size_t size)
+{
+	return (mallocx(size, MALLOCX_ALIGN(CK_MD_CACHELINE)));
+}
+
 #if __SIZEOF_POINTER__ > 4
 
 typedef uint64_t refcount;
@@ -14,9 +14,12 @@
 #include <lualib.h>
 
 #include "common.h"
+#include "latency.h"
+#include "probes.h"
 #include "refcount.h"
 #include "serde.h"
 #include "serdebuf.h"
+#include "stats.h"
 #include "luaerror.h"
 
 #define RING_SPSC_METATABLE "ring.spsc"
@@ -27,19 +30,30 @@
 struct rcring {
 	ck_ring_t ring;
 	ck_ring_buffer_t *buffer;
-	refcount refs;
+	struct latency *latency;
+#ifdef STATS
+	struct ring_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
+#define RING_STATS_INC(ringp, NAME) do { \
+	STATS_INC(&(ringp)->stats, NAME); \
+	STATS_TOTAL_INC(ring, NAME); \
+} while (0)
+
 static inline int
 newring(lua_State *L, const char *metatable)
 {
 	struct rcring *ringp;
 	unsigned int size;
+	bool latency;
 	int error;
 
 	size = luaL_checkinteger(L, 1);
+	latency = lua_toboolean(L, 2);
 
-	if ((ringp = malloc(sizeof(*ringp))) == NULL) {
+	if ((ringp = refcount_alloc(sizeof(*ringp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	ck_ring_init(&ringp->ring, size);
@@ -47,6 +61,13 @@ newring(lua_State *L, const char *metatable)
 		free(ringp);
 		return (fatal(L, "malloc", ENOMEM));
 	}
+	ringp->latency = NULL;
+	if (latency && (ringp->latency = latency_alloc()) == NULL) {
+		free(ringp->buffer);
+		free(ringp);
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	STATS_INIT(&ringp->stats);
 	refcount_init(&ringp->refs);
 	return (new(L, ringp, metatable));
 }
@@ -70,6 +91,7 @@ releasering(lua_State *L, const char *metatable)
 	ringp = checkcookie(L, 1, metatable);
 
 	if (refcount_release(&ringp->refs)) {
+		free(ringp->latency);
 		free(ringp->buffer);
 		free(ringp);
 	}
@@ -99,6 +121,26 @@ ringcapacity(lua_State *L, const char *metatable)
 	return (1);
 }
 
+static inline int
+ringstats(lua_State *L, const char *metatable)
+{
+	struct rcring *ringp __unused;
+
+	ringp = checkcookie(L, 1, metatable);
+
+	return (STATS_PUSH(RING_STATS_LIST, &ringp->stats));
+}
+
+static inline int
+ringlatency(lua_State *L, const char *metatable)
+{
+	struct rcring *ringp;
+
+	ringp = checkcookie(L, 1, metatable);
+
+	return (latency_push(L, ringp->latency));
+}
+
 static int
 l_ck_ring_spsc_new(lua_State *L)
 {
@@ -137,12 +179,25 @@ l_ck_ring_spsc_capacity(lua_State *L)
 	return (ringcapacity(L, RING_SPSC_METATABLE));
 }
 
+static int
+l_ck_ring_spsc_stats(lua_State *L)
+{
+	return (ringstats(L, RING_SPSC_METATABLE));
+}
+
+static int
+l_ck_ring_spsc_latency(lua_State *L)
+{
+	return (ringlatency(L, RING_SPSC_METATABLE));
+}
+
 static int
 l_ck_ring_spsc_enqueue(lua_State *L)
 {
 	struct serdebuf sb;
 	struct rcring *ringp;
 	void *v;
+	size_t len;
 	unsigned int size;
 	serde_type_code type;
 	bool enqueued;
@@ -155,21 +210,27 @@ l_ck_ring_spsc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(ringp->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
+	latency_stamp(ringp->latency, v);
 	if (!(enqueued = ck_ring_enqueue_spsc_size(&ringp->ring, ringp->buffer,
 	    v, &size))) {
+		RING_STATS_INC(ringp, enqueue_failures);
 		free(v);
+	} else {
+		RING_STATS_INC(ringp, enqueues);
 	}
+	CK_RING_ENQUEUE(ringp, len, type, enqueued);
 	lua_pushboolean(L, enqueued);
 	lua_pushinteger(L, size);
 	return (2);
@@ -180,16 +241,23 @@ l_ck_ring_spsc_dequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_SPSC_METATABLE);
 
 	if (!ck_ring_dequeue_spsc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -232,12 +300,25 @@ l_ck_ring_mpmc_capacity(lua_State *L)
 	return (ringcapacity(L, RING_MPMC_METATABLE));
 }
 
+static int
+l_ck_ring_mpmc_stats(lua_State *L)
+{
+	return (ringstats(L, RING_MPMC_METATABLE));
+}
+
+static int
+l_ck_ring_mpmc_latency(lua_State *L)
+{
+	return (ringlatency(L, RING_MPMC_METATABLE));
+}
+
 static int
 l_ck_ring_mpmc_enqueue(lua_State *L)
 {
 	struct serdebuf sb;
 	struct rcring *ringp;
 	void *v;
+	size_t len;
 	unsigned int size;
 	serde_type_code type;
 	bool enqueued;
@@ -250,21 +331,27 @@ l_ck_ring_mpmc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(ringp->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
+	latency_stamp(ringp->latency, v);
 	if (!(enqueued = ck_ring_enqueue_mpmc_size(&ringp->ring, ringp->buffer,
 	    v, &size))) {
+		RING_STATS_INC(ringp, enqueue_failures);
 		free(v);
+	} else {
+		RING_STATS_INC(ringp, enqueues);
 	}
+	CK_RING_ENQUEUE(ringp, len, type, enqueued);
 	lua_pushboolean(L, enqueued);
 	lua_pushinteger(L, size);
 	return (2);
@@ -275,16 +362,23 @@ l_ck_ring_mpmc_trydequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_MPMC_METATABLE);
 
 	if (!ck_ring_trydequeue_mpmc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -294,16 +388,23 @@ l_ck_ring_mpmc_dequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_MPMC_METATABLE);
 
 	if (!ck_ring_dequeue_mpmc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -346,12 +447,25 @@ l_ck_ring_spmc_capacity(lua_State *L)
 	return (ringcapacity(L, RING_SPMC_METATABLE));
 }
 
+static int
+l_ck_ring_spmc_stats(lua_State *L)
+{
+	return (ringstats(L, RING_SPMC_METATABLE));
+}
+
+static int
+l_ck_ring_spmc_latency(lua_State *L)
+{
+	return (ringlatency(L, RING_SPMC_METATABLE));
+}
+
 static int
 l_ck_ring_spmc_enqueue(lua_State *L)
 {
 	struct serdebuf sb;
 	struct rcring *ringp;
 	void *v;
+	size_t len;
 	unsigned int size;
 	serde_type_code type;
 	bool enqueued;
@@ -364,21 +478,27 @@ l_ck_ring_spmc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(ringp->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
+	latency_stamp(ringp->latency, v);
 	if (!(enqueued = ck_ring_enqueue_spmc_size(&ringp->ring, ringp->buffer,
 	    v, &size))) {
+		RING_STATS_INC(ringp, enqueue_failures);
 		free(v);
+	} else {
+		RING_STATS_INC(ringp, enqueues);
 	}
+	CK_RING_ENQUEUE(ringp, len, type, enqueued);
 	lua_pushboolean(L, enqueued);
 	lua_pushinteger(L, size);
 	return (2);
@@ -389,16 +509,23 @@ l_ck_ring_spmc_trydequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_SPMC_METATABLE);
 
 	if (!ck_ring_trydequeue_spmc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -408,16 +535,23 @@ l_ck_ring_spmc_dequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_SPMC_METATABLE);
 
 	if (!ck_ring_dequeue_spmc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -460,12 +594,25 @@ l_ck_ring_mpsc_capacity(lua_State *L)
 	return (ringcapacity(L, RING_MPSC_METATABLE));
 }
 
+static int
+l_ck_ring_mpsc_stats(lua_State *L)
+{
+	return (ringstats(L, RING_MPSC_METATABLE));
+}
+
+static int
+l_ck_ring_mpsc_latency(lua_State *L)
+{
+	return (ringlatency(L, RING_MPSC_METATABLE));
+}
+
 static int
 l_ck_ring_mpsc_enqueue(lua_State *L)
 {
 	struct serdebuf sb;
 	struct rcring *ringp;
 	void *v;
+	size_t len;
 	unsigned int size;
 	serde_type_code type;
 	bool enqueued;
@@ -478,21 +625,27 @@ l_ck_ring_mpsc_enqueue(lua_State *L)
 		return (fatal(L, "serdebuf_init", error));
 	}
 	type = SERDE_ANY;
-	if ((error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
+	if ((error = latency_reserve(ringp->latency, &sb)) != 0 ||
+	    (error = serdebuf_serialize(L, 2, &sb, &type)) != 0) {
 		serdebuf_destroy(&sb);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serdebuf_serialize", error));
 	}
-	if ((v = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((v = serdebuf_finalize(&sb, &len)) == NULL) {
 		serdebuf_destroy(&sb);
 		return (fatal(L, "serdebuf_finalize", ENOMEM));
 	}
+	latency_stamp(ringp->latency, v);
 	if (!(enqueued = ck_ring_enqueue_mpsc_size(&ringp->ring, ringp->buffer,
 	    v, &size))) {
+		RING_STATS_INC(ringp, enqueue_failures);
 		free(v);
+	} else {
+		RING_STATS_INC(ringp, enqueues);
 	}
+	CK_RING_ENQUEUE(ringp, len, type, enqueued);
 	lua_pushboolean(L, enqueued);
 	lua_pushinteger(L, size);
 	return (2);
@@ -503,16 +656,23 @@ l_ck_ring_mpsc_dequeue(lua_State *L)
 {
 	struct rcring *ringp;
 	void *v;
+	const void *p, *end;
 	bool ok;
 
 	ringp = checkcookie(L, 1, RING_MPSC_METATABLE);
 
 	if (!ck_ring_dequeue_mpsc(&ringp->ring, ringp->buffer, &v)) {
+		RING_STATS_INC(ringp, dequeue_failures);
+		CK_RING_DEQUEUE(ringp, 0, SERDE_INVALID, false);
 		lua_pushboolean(L, false);
 		return (1);
 	}
+	RING_STATS_INC(ringp, dequeues);
 	lua_pushboolean(L, true);
-	ok = loadshared(L, v) != NULL;
+	p = latency_record(ringp->latency, v);
+	end = loadshared(L, p);
+	ok = end != NULL;
+	CK_RING_DEQUEUE(ringp, probe_size(v, end), probe_type(p), ok);
 	free(v);
 	return (ok ? 2 : lua_error(L));
 }
@@ -528,6 +688,8 @@ static const struct luaL_Reg l_ck_ring_spsc_meta[] = {
 	{"cookie", l_ck_ring_spsc_cookie},
 	{"size", l_ck_ring_spsc_size},
 	{"capacity", l_ck_ring_spsc_capacity},
+	{"latency", l_ck_ring_spsc_latency},
+	{"stats", l_ck_ring_spsc_stats},
 #if 0 /* maybe if we could serde the ring buffer? */
 	{"repair", l_ck_ring_spsc_repair},
 	{"valid", l_ck_ring_spsc_valid},
@@ -548,6 +710,8 @@ static const struct luaL_Reg l_ck_ring_mpmc_meta[] = {
 	{"cookie", l_ck_ring_mpmc_cookie},
 	{"size", l_ck_ring_mpmc_size},
 	{"capacity", l_ck_ring_mpmc_capacity},
+	{"latency", l_ck_ring_mpmc_latency},
+	{"stats", l_ck_ring_mpmc_stats},
 #if 0 /* maybe if we could serde the ring buffer? */
 	{"repair", l_ck_ring_mpmc_repair},
 	{"valid", l_ck_ring_mpmc_valid},
@@ -569,6 +733,8 @@ static const struct luaL_Reg l_ck_ring_spmc_meta[] = {
 	{"cookie", l_ck_ring_spmc_cookie},
 	{"size", l_ck_ring_spmc_size},
 	{"capacity", l_ck_ring_spmc_capacity},
+	{"latency", l_ck_ring_spmc_latency},
+	{"stats", l_ck_ring_spmc_stats},
 #if 0 /* maybe if we could serde the ring buffer? */
 	{"repair", l_ck_ring_spmc_repair},
 	{"valid", l_ck_ring_spmc_valid},
@@ -590,6 +756,8 @@ static const struct luaL_Reg l_ck_ring_mpsc_meta[] = {
 	{"cookie", l_ck_ring_mpsc_cookie},
 	{"size", l_ck_ring_mpsc_size},
 	{"capacity", l_ck_ring_mpsc_capacity},
+	{"latency", l_ck_ring_mpsc_latency},
+	{"stats", l_ck_ring_mpsc_stats},
 #if 0 /* maybe if we could serde the ring buffer? */
 	{"repair", l_ck_ring_mpsc_repair},
 	{"valid", l_ck_ring_mpsc_valid},
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_rwlock.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define RWLOCK_METATABLE "rwlock"
+
+struct rcrwlock {
+	ck_rwlock_t lock;
+	refcount refs CK_CC_CACHELINE;
+};
+
+static int
+l_ck_rwlock_new(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_rwlock_init(&lockp->lock);
+	refcount_init(&lockp->refs);
+	return (new(L, lockp, RWLOCK_METATABLE));
+}
+
+static int
+l_ck_rwlock_retain(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	return (new(L, lockp, RWLOCK_METATABLE));
+}
+
+static int
+l_ck_rwlock_gc(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	if (refcount_release(&lockp->refs)) {
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_rwlock_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, RWLOCK_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_rwlock_locked(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	lua_pushboolean(L, ck_rwlock_locked(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_rwlock_locked_writer(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	lua_pushboolean(L, ck_rwlock_locked_writer(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_rwlock_locked_reader(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	lua_pushboolean(L, ck_rwlock_locked_reader(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_rwlock_write_lock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	ck_rwlock_write_lock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_rwlock_write_trylock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	lua_pushboolean(L, ck_rwlock_write_trylock(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_rwlock_write_unlock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	ck_rwlock_write_unlock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_rwlock_write_downgrade(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	ck_rwlock_write_downgrade(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_rwlock_read_lock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	ck_rwlock_read_lock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_rwlock_read_trylock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	lua_pushboolean(L, ck_rwlock_read_trylock(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_rwlock_read_unlock(lua_State *L)
+{
+	struct rcrwlock *lockp;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+
+	ck_rwlock_read_unlock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_rwlock_with_read(lua_State *L)
+{
+	struct rcrwlock *lockp;
+	int status;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_rwlock_read_lock(&lockp->lock);
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_rwlock_read_unlock(&lockp->lock);
+	return (withresults(L, status, 1));
+}
+
+static int
+l_ck_rwlock_with_write(lua_State *L)
+{
+	struct rcrwlock *lockp;
+	int status;
+
+	lockp = checkcookie(L, 1, RWLOCK_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_rwlock_write_lock(&lockp->lock);
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_rwlock_write_unlock(&lockp->lock);
+	return (withresults(L, status, 1));
+}
+
+static const struct luaL_Reg l_ck_rwlock_funcs[] = {
+	{"new", l_ck_rwlock_new},
+	{"retain", l_ck_rwlock_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_rwlock_meta[] = {
+	{"__gc", l_ck_rwlock_gc},
+	{"cookie", l_ck_rwlock_cookie},
+	{"locked", l_ck_rwlock_locked},
+	{"locked_writer", l_ck_rwlock_locked_writer},
+	{"locked_reader", l_ck_rwlock_locked_reader},
+	{"write_lock", l_ck_rwlock_write_lock},
+	{"write_trylock", l_ck_rwlock_write_trylock},
+	{"write_unlock", l_ck_rwlock_write_unlock},
+	{"write_downgrade", l_ck_rwlock_write_downgrade},
+	{"read_lock", l_ck_rwlock_read_lock},
+	{"read_trylock", l_ck_rwlock_read_trylock},
+	{"read_unlock", l_ck_rwlock_read_unlock},
+	{"with_read", l_ck_rwlock_with_read},
+	{"with_write", l_ck_rwlock_with_write},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_rwlock(lua_State *L)
+{
+	luaL_newmetatable(L, RWLOCK_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_rwlock_meta, 0);
+
+	luaL_newlib(L, l_ck_rwlock_funcs); /* ck.rwlock */
+	return (1);
+}
@@ -25,29 +25,14 @@ local status_nq_ecc <const> = status_nq_ec:cookie()
 local status_dq_ec <const> = assert(ck.ec.ec64.new(0))
 local status_dq_ecc <const> = status_dq_ec:cookie()
 
+local Work <const> = ck.serde.schema{id = 'I', url = 's', path = 's'}
+
 local function work(id, url, path)
-	local format <const> = 'Iss'
-	-- Avoid using parameters as upvalues in serde methods.
-	-- Stash args in an object instead to access via self.
-	return setmetatable({
+	return Work{
 		id = id,
 		url = url,
 		path = path,
-	}, {
-		serialize = function(self, buf)
-			buf:write(string.pack(format, self.id, self.url,
-			    self.path))
-		end,
-		deserialize = function(buf)
-			local id <const>, url <const>, path <const> =
-			    string.unpack(format, buf:read('a'))
-			return {
-				id = id,
-				url = url,
-				path = path,
-			}
-		end,
-	})
+	}
 end
 
 local tasks <const> = {}
@@ -89,56 +74,30 @@ local function worker()
 	local status_nq_ec <const> = ck.ec.ec64.retain(status_nq_ecc)
 	local status_dq_ec <const> = ck.ec.ec64.retain(status_dq_ecc)
 
+	-- Schemas compiled with the same layout in any thread are the same.
+	local Status <const> = ck.serde.schema{
+		id = 'I',
+		size = 'T',
+		progress = 'T',
+		err = 's',
+		code = 'i',
+	}
+	local Finish <const> = ck.serde.schema{id = 'I'}
+
 	local function status(id, size, progress, err, code)
-		local format <const> = 'ITTsi'
-		-- Avoid using parameters as upvalues in serde methods.
-		-- Stash args in an object instead to access via self.
-		return setmetatable({
+		return Status{
 			id = id,
 			size = size,
 			progress = progress,
 			err = err,
 			code = code,
-		}, {
-			serialize = function(self, buf)
-				buf:write(string.pack(format, self.id,
-				    self.size, self.progress, self.err,
-				    self.code))
-			end,
-			deserialize = function(buf)
-				local id <const>, size <const>,
-				    progress <const>, err <const>,
-				    code <const> = string.unpack(format,
-				    buf:read('a'))
-				return {
-					id = id,
-					size = size,
-					progress = progress,
-					err = err,
-					code = code,
-				}
-			end,
-		})
+		}
 	end
 
 	local function finish(id)
-		local format <const> = 'I'
-		-- Avoid using parameters as upvalues in serde methods.
-		-- Stash args in an object instead to access via self.
-		return setmetatable({
+		return Finish{
 			id = id,
-		}, {
-			serialize = function(self, buf)
-				buf:write(string.pack(format, self.id))
-			end,
-			deserialize = function(buf)
-				local id <const> = string.unpack(format,
-				    buf:read('a'))
-				return {
-					id = id,
-				}
-			end,
-		})
+		}
 	end
 
 	local function enqueue(msg)
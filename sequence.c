@@ -4,12 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <ck_pr.h>
 #include <ck_sequence.h>
+#include <ck_spinlock.h>
 
 #include <lua.h>
 #include <lauxlib.h>
@@ -19,10 +23,15 @@
 #include "refcount.h"
 
 #define SEQUENCE_METATABLE "sequence"
+#define SEQUENCE_RECORD_METATABLE "sequence.record"
+
+#ifndef SEQUENCE_RECORD_MAX_FIELDS
+#define SEQUENCE_RECORD_MAX_FIELDS 64
+#endif
 
 struct rcsequence {
 	ck_sequence_t seqlock;
-	refcount refs;
+	refcount refs CK_CC_CACHELINE;
 };
 
 static int
@@ -30,7 +39,7 @@ l_ck_sequence_new(lua_State *L)
 {
 	struct rcsequence *seqp;
 
-	if ((seqp = malloc(sizeof(*seqp))) == NULL) {
+	if ((seqp = refcount_alloc(sizeof(*seqp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
 	ck_sequence_init(&seqp->seqlock);
@@ -120,6 +129,298 @@ l_ck_sequence_write_end(lua_State *L)
 	return (0);
 }
 
+enum record_type {
+	RECORD_BOOLEAN,
+	RECORD_INTEGER,
+	RECORD_NUMBER,
+};
+
+static const char *record_types[] = {
+	[RECORD_BOOLEAN] = "boolean",
+	[RECORD_INTEGER] = "integer",
+	[RECORD_NUMBER] = "number",
+	NULL
+};
+
+_Static_assert(sizeof(uint64_t) == sizeof(lua_Integer), "bad lua_Integer size");
+_Static_assert(sizeof(uint64_t) == sizeof(lua_Number), "bad lua_Number size");
+
+union record_value {
+	uint64_t u64;
+	lua_Integer integer;
+	lua_Number number;
+};
+
+struct record_field {
+	char *name;
+	enum record_type type;
+};
+
+/*
+ * Readers are wait-free and retry if a write was in progress.  Writers are
+ * serialized by a spinlock, as ck_sequence itself supports only one writer at
+ * a time.  Every value occupies a 64-bit slot so it can be copied with a single
+ * atomic load or store.
+ */
+struct rcrecord {
+	ck_sequence_t seqlock;
+	ck_spinlock_t writer;
+	struct record_field *fields;
+	unsigned int nfields;
+	refcount refs CK_CC_CACHELINE;
+	union record_value values[] CK_CC_CACHELINE;
+};
+
+static void
+freerecord(struct rcrecord *recp)
+{
+	for (unsigned int i = 0; i < recp->nfields; i++) {
+		free(recp->fields[i].name);
+	}
+	free(recp->fields);
+	free(recp);
+}
+
+static inline bool
+checkrecordvalue(lua_State *L, int idx, enum record_type type,
+    union record_value *valuep)
+{
+	switch (type) {
+	case RECORD_BOOLEAN:
+		if (!lua_isboolean(L, idx)) {
+			return (false);
+		}
+		valuep->u64 = lua_toboolean(L, idx);
+		return (true);
+	case RECORD_INTEGER:
+		if (!lua_isinteger(L, idx)) {
+			return (false);
+		}
+		valuep->integer = lua_tointeger(L, idx);
+		return (true);
+	case RECORD_NUMBER:
+		if (lua_type(L, idx) != LUA_TNUMBER) {
+			return (false);
+		}
+		valuep->number = lua_tonumber(L, idx);
+		return (true);
+	default:
+		__unreachable();
+	}
+}
+
+static inline void
+pushrecordvalue(lua_State *L, enum record_type type, union record_value value)
+{
+	switch (type) {
+	case RECORD_BOOLEAN:
+		lua_pushboolean(L, value.u64 != 0);
+		break;
+	case RECORD_INTEGER:
+		lua_pushinteger(L, value.integer);
+		break;
+	case RECORD_NUMBER:
+		lua_pushnumber(L, value.number);
+		break;
+	default:
+		__unreachable();
+	}
+}
+
+static inline enum record_type
+checkrecordtype(lua_State *L)
+{
+	const char *type;
+
+	/* ..., name, type */
+	if ((type = lua_tostring(L, -1)) != NULL) {
+		for (int i = 0; record_types[i] != NULL; i++) {
+			if (strcmp(type, record_types[i]) == 0) {
+				return (i);
+			}
+		}
+	}
+	return (luaL_error(L, "bad type for field '%s' (boolean, integer, or "
+	    "number expected)", lua_tostring(L, -2)));
+}
+
+static int
+l_ck_sequence_record_new(lua_State *L)
+{
+	struct rcrecord *recp;
+	size_t size;
+	unsigned int i, n;
+
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	n = 0;
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		luaL_argcheck(L, lua_type(L, -2) == LUA_TSTRING, 1,
+		    "field names must be strings");
+		checkrecordtype(L);
+		lua_pop(L, 1);
+		n++;
+	}
+	luaL_argcheck(L, n <= SEQUENCE_RECORD_MAX_FIELDS, 1, "too many fields");
+
+	size = sizeof(*recp) + n * sizeof(recp->values[0]);
+	if ((recp = refcount_alloc(size)) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	memset(recp, 0, size);
+	if ((recp->fields = calloc(n, sizeof(*recp->fields))) == NULL) {
+		free(recp);
+		return (fatal(L, "calloc", ENOMEM));
+	}
+	i = 0;
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		struct record_field *field = &recp->fields[i];
+
+		field->type = checkrecordtype(L);
+		if ((field->name = strdup(lua_tostring(L, -2))) == NULL) {
+			freerecord(recp);
+			return (fatal(L, "strdup", ENOMEM));
+		}
+		recp->nfields = ++i;
+		lua_pop(L, 1);
+	}
+	assert(i == n);
+	ck_sequence_init(&recp->seqlock);
+	ck_spinlock_init(&recp->writer);
+	refcount_init(&recp->refs);
+	return (new(L, recp, SEQUENCE_RECORD_METATABLE));
+}
+
+static int
+l_ck_sequence_record_call(lua_State *L)
+{
+	/* Called as ck.sequence.record{...}, drop the module table. */
+	lua_remove(L, 1);
+	return (l_ck_sequence_record_new(L));
+}
+
+static int
+l_ck_sequence_record_retain(lua_State *L)
+{
+	struct rcrecord *recp;
+
+	recp = checklightuserdata(L, 1);
+
+	refcount_retain(&recp->refs);
+	return (new(L, recp, SEQUENCE_RECORD_METATABLE));
+}
+
+static int
+l_ck_sequence_record_gc(lua_State *L)
+{
+	struct rcrecord *recp;
+
+	recp = checkcookie(L, 1, SEQUENCE_RECORD_METATABLE);
+
+	if (refcount_release(&recp->refs)) {
+		freerecord(recp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_sequence_record_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SEQUENCE_RECORD_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_sequence_record_read(lua_State *L)
+{
+	union record_value values[SEQUENCE_RECORD_MAX_FIELDS];
+	struct rcrecord *recp;
+	unsigned int i, n, version;
+
+	recp = checkcookie(L, 1, SEQUENCE_RECORD_METATABLE);
+	if (!lua_isnoneornil(L, 2)) {
+		luaL_checktype(L, 2, LUA_TTABLE);
+	}
+
+	n = recp->nfields;
+	do {
+		version = ck_sequence_read_begin(&recp->seqlock);
+		for (i = 0; i < n; i++) {
+			values[i].u64 = ck_pr_load_64(&recp->values[i].u64);
+		}
+	} while (ck_sequence_read_retry(&recp->seqlock, version));
+
+	if (lua_istable(L, 2)) {
+		lua_settop(L, 2);
+	} else {
+		lua_createtable(L, 0, n);
+	}
+	for (i = 0; i < n; i++) {
+		pushrecordvalue(L, recp->fields[i].type, values[i]);
+		lua_setfield(L, -2, recp->fields[i].name);
+	}
+	return (1);
+}
+
+static int
+l_ck_sequence_record_write(lua_State *L)
+{
+	union record_value values[SEQUENCE_RECORD_MAX_FIELDS];
+	bool present[SEQUENCE_RECORD_MAX_FIELDS];
+	struct rcrecord *recp;
+	unsigned int i, n;
+
+	recp = checkcookie(L, 1, SEQUENCE_RECORD_METATABLE);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	/*
+	 * Convert everything before entering the write section so a bad value
+	 * raises an error without leaving the sequence lock held.
+	 */
+	n = recp->nfields;
+	for (i = 0; i < n; i++) {
+		struct record_field *field = &recp->fields[i];
+
+		lua_getfield(L, 2, field->name);
+		if ((present[i] = !lua_isnil(L, -1)) &&
+		    !checkrecordvalue(L, -1, field->type, &values[i])) {
+			return (luaL_error(L, "bad value for field '%s' "
+			    "(%s expected, got %s)", field->name,
+			    record_types[field->type], luaL_typename(L, -1)));
+		}
+		lua_pop(L, 1);
+	}
+	ck_spinlock_lock(&recp->writer);
+	ck_sequence_write_begin(&recp->seqlock);
+	for (i = 0; i < n; i++) {
+		if (present[i]) {
+			ck_pr_store_64(&recp->values[i].u64, values[i].u64);
+		}
+	}
+	ck_sequence_write_end(&recp->seqlock);
+	ck_spinlock_unlock(&recp->writer);
+	return (0);
+}
+
+static int
+l_ck_sequence_record_fields(lua_State *L)
+{
+	struct rcrecord *recp;
+
+	recp = checkcookie(L, 1, SEQUENCE_RECORD_METATABLE);
+
+	lua_createtable(L, 0, recp->nfields);
+	for (unsigned int i = 0; i < recp->nfields; i++) {
+		lua_pushstring(L, record_types[recp->fields[i].type]);
+		lua_setfield(L, -2, recp->fields[i].name);
+	}
+	return (1);
+}
+
 static const struct luaL_Reg l_ck_sequence_funcs[] = {
 	{"new", l_ck_sequence_new},
 	{"retain", l_ck_sequence_retain},
@@ -136,6 +437,26 @@ static const struct luaL_Reg l_ck_sequence_meta[] = {
 	{NULL, NULL}
 };
 
+static const struct luaL_Reg l_ck_sequence_record_funcs[] = {
+	{"new", l_ck_sequence_record_new},
+	{"retain", l_ck_sequence_record_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_sequence_record_funcs_meta[] = {
+	{"__call", l_ck_sequence_record_call},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_sequence_record_meta[] = {
+	{"__gc", l_ck_sequence_record_gc},
+	{"cookie", l_ck_sequence_record_cookie},
+	{"fields", l_ck_sequence_record_fields},
+	{"read", l_ck_sequence_record_read},
+	{"write", l_ck_sequence_record_write},
+	{NULL, NULL}
+};
+
 int
 luaopen_ck_sequence(lua_State *L)
 {
@@ -144,6 +465,15 @@ luaopen_ck_sequence(lua_State *L)
 	lua_setfield(L, -2, "__index");
 	luaL_setfuncs(L, l_ck_sequence_meta, 0);
 
+	luaL_newmetatable(L, SEQUENCE_RECORD_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_sequence_record_meta, 0);
+
 	luaL_newlib(L, l_ck_sequence_funcs); /* ck.sequence */
+	luaL_newlib(L, l_ck_sequence_record_funcs); /* ck.sequence.record */
+	luaL_newlib(L, l_ck_sequence_record_funcs_meta);
+	lua_setmetatable(L, -2);
+	lua_setfield(L, -2, "record");
 	return (1);
 }
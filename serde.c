@@ -6,9 +6,9 @@
 
 #include <sys/param.h>
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <limits.h>
-#include <malloc_np.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,6 +21,10 @@
 #include <ck_pr.h>
 #include <ck_spinlock.h>
 
+#ifdef SERDE_ZSTD
+#include <zstd.h>
+#endif
+
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
@@ -40,7 +44,51 @@ static ck_ht_t serde_cache_types CK_CC_CACHELINE; /* serde => type */
 static ck_spinlock_t serde_cache_lock; /* serializes cache+types updates */
 static ck_epoch_t serde_cache_epoch; /* free deferral for types hash table */
 static ck_epoch_record_t module_serde_cache_record; /* reserved for init/fini */
-__thread static ck_epoch_record_t *thread_serde_cache_record;
+static __thread ck_epoch_record_t *thread_serde_cache_record;
+
+/*
+ * Each state keeps the closures it has loaded from bytecode in a table in the
+ * registry keyed by this address.  The table maps bytecode to closure and has
+ * weak values, so a closure stays cached only as long as it is in use
+ * somewhere or until the next collection cycle.
+ */
+static char serde_closure_cache;
+
+/*
+ * Bytecode dumped from Lua functions is interned in a process-wide hash table
+ * keyed by its contents, and entries are never freed until the module is
+ * unloaded, like the custom serde cache.  Serialized closures can then refer
+ * to an entry by address for as long as they live, however they are freed.
+ * The total size of interned bytecode is bounded so that programs generating
+ * many functions don't grow the table without limit; past the limit closures
+ * carry their own copy of the bytecode as before.
+ *
+ * Each state also remembers the entry for each function it has dumped in a
+ * table in the registry keyed by this address, with weak keys, so a function
+ * sent repeatedly is dumped only once.
+ */
+static char serde_bytecode_refs;
+static ck_ht_t serde_bytecode_ht CK_CC_CACHELINE; /* bytecode => entry */
+static size_t serde_bytecode_total; /* protected by serde_cache_lock */
+
+#ifndef SERDE_BYTECODE_INTERN_MAX
+#define SERDE_BYTECODE_INTERN_MAX (16 << 20)
+#endif
+
+/*
+ * Schemas compiled by ck.serde.schema() are interned in a process-wide hash
+ * table keyed by a canonical form of the layout, so every state compiling the
+ * same layout gets the same schema.  Like interned bytecode, schemas are never
+ * freed until the module is unloaded.
+ *
+ * Each state keeps a table in the registry keyed by this address that maps each
+ * schema to the table representing it in that state, which is the metatable of
+ * its records.  That table refers back to the schema by the same key.
+ */
+static char serde_schemas;
+static ck_ht_t serde_schema_ht CK_CC_CACHELINE; /* layout => schema */
+
+#define SERDE_SCHEMA_METATABLE "ck.serde.schema"
 
 static void *
 serde_ck_malloc(size_t sz)
@@ -105,6 +153,12 @@ init_serde_cache(void)
 	ok = ck_ht_init(&serde_cache_types, CK_HT_MODE_BYTESTRING, NULL,
 	    &serde_ck_allocator, SERDE_CACHE_NBUCKETS, SERDE_CACHE_SEED);
 	assert(ok);
+	ok = ck_ht_init(&serde_bytecode_ht, CK_HT_MODE_BYTESTRING, NULL,
+	    &serde_ck_allocator, SERDE_CACHE_NBUCKETS, SERDE_CACHE_SEED);
+	assert(ok);
+	ok = ck_ht_init(&serde_schema_ht, CK_HT_MODE_BYTESTRING, NULL,
+	    &serde_ck_allocator, SERDE_CACHE_NBUCKETS, SERDE_CACHE_SEED);
+	assert(ok);
 	ck_spinlock_init(&serde_cache_lock);
 }
 
@@ -112,7 +166,19 @@ __attribute__((destructor(PRIO_HT)))
 static void
 fini_serde_cache(void)
 {
+	ck_ht_iterator_t iterator = CK_HT_ITERATOR_INITIALIZER;
+	ck_ht_entry_t *entry;
+
 	thread_serde_cache_record = NULL;
+	while (ck_ht_next(&serde_bytecode_ht, &iterator, &entry)) {
+		free(ck_ht_entry_value(entry));
+	}
+	ck_ht_destroy(&serde_bytecode_ht);
+	iterator = (ck_ht_iterator_t)CK_HT_ITERATOR_INITIALIZER;
+	while (ck_ht_next(&serde_schema_ht, &iterator, &entry)) {
+		free(ck_ht_entry_value(entry));
+	}
+	ck_ht_destroy(&serde_schema_ht);
 	ck_ht_destroy(&serde_cache_types);
 	ck_epoch_reclaim(&module_serde_cache_record);
 	ck_epoch_unregister(&module_serde_cache_record);
@@ -300,6 +366,334 @@ success:
 	return (0);
 }
 
+const struct serde_bytecode *
+lookup_bytecode(lua_State *L, int idx)
+{
+	const struct serde_bytecode *bc;
+
+	idx = lua_absindex(L, idx);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &serde_bytecode_refs);
+	lua_pushvalue(L, idx);
+	lua_rawget(L, -2);
+	bc = lua_touserdata(L, -1);
+	lua_pop(L, 2);
+	return (bc);
+}
+
+/*
+ * Intern the bytecode dumped from the function at idx.  Returns NULL if the
+ * bytecode cannot be interned, in which case it must be copied instead.
+ */
+const struct serde_bytecode *
+intern_bytecode(lua_State *L, int idx, const void *p, size_t size)
+{
+	struct serde_bytecode *bc;
+	ck_ht_entry_t entry;
+	ck_ht_hash_t hash;
+	bool ok;
+
+	/* Hash table key length is a uint16_t parameter. */
+	if (size > UINT16_MAX) {
+		return (NULL);
+	}
+	idx = lua_absindex(L, idx);
+	ck_ht_hash(&hash, &serde_bytecode_ht, p, size);
+	ck_ht_entry_key_set(&entry, p, size);
+	ck_epoch_begin(thread_serde_cache_record, NULL);
+	ok = ck_ht_get_spmc(&serde_bytecode_ht, hash, &entry);
+	ck_epoch_end(thread_serde_cache_record, NULL);
+	if (ok) {
+		bc = ck_ht_entry_value(&entry);
+		goto success;
+	}
+	ck_epoch_begin(thread_serde_cache_record, NULL);
+	ck_spinlock_lock(&serde_cache_lock);
+	/* Look again now that no other thread can be adding it. */
+	if (ck_ht_get_spmc(&serde_bytecode_ht, hash, &entry)) {
+		bc = ck_ht_entry_value(&entry);
+	} else if (serde_bytecode_total + size > SERDE_BYTECODE_INTERN_MAX ||
+	    (bc = malloc(sizeof(*bc) + size)) == NULL) {
+		bc = NULL;
+	} else {
+		bc->size = size;
+		memcpy(bc->data, p, size);
+		ck_ht_entry_set(&entry, hash, bc->data, size, bc);
+		if (ck_ht_put_spmc(&serde_bytecode_ht, hash, &entry)) {
+			serde_bytecode_total += size;
+		} else {
+			free(bc);
+			bc = NULL;
+		}
+	}
+	ck_spinlock_unlock(&serde_cache_lock);
+	ck_epoch_end(thread_serde_cache_record, NULL);
+	if (bc == NULL) {
+		return (NULL);
+	}
+success:
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &serde_bytecode_refs);
+	lua_pushvalue(L, idx);
+	lua_pushlightuserdata(L, bc);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+	return (bc);
+}
+
+const struct serde_schema *
+getschema(lua_State *L, int idx)
+{
+	const struct serde_schema *schema;
+
+	if (!lua_getmetatable(L, idx)) {
+		return (NULL);
+	}
+	lua_rawgetp(L, -1, &serde_schemas);
+	schema = lua_touserdata(L, -1);
+	lua_pop(L, 2);
+	return (schema);
+}
+
+/*
+ * Push the table representing the schema in this state, creating it the first
+ * time the schema is seen.
+ */
+static void
+pushschema(lua_State *L, const struct serde_schema *schema)
+{
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &serde_schemas);
+	if (lua_rawgetp(L, -1, schema) != LUA_TTABLE) {
+		lua_pop(L, 1);
+		lua_createtable(L, 0, 2);
+		lua_pushlightuserdata(L, __DECONST(void *, schema));
+		lua_rawsetp(L, -2, &serde_schemas);
+		lua_pushliteral(L, "ck.serde.record");
+		lua_setfield(L, -2, "__name");
+		luaL_setmetatable(L, SERDE_SCHEMA_METATABLE);
+		lua_pushvalue(L, -1);
+		lua_rawsetp(L, -3, schema);
+	}
+	lua_remove(L, -2);
+}
+
+/*
+ * Parse a field format, a subset of the options understood by string.pack().
+ */
+static bool
+parsefield(const char *fmt, struct serde_field *field)
+{
+	bool sized = false;
+
+	switch (*fmt++) {
+	case 'b':
+		field->kind = SERDE_FIELD_INT;
+		field->size = sizeof(char);
+		break;
+	case 'B':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(char);
+		break;
+	case 'h':
+		field->kind = SERDE_FIELD_INT;
+		field->size = sizeof(short);
+		break;
+	case 'H':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(short);
+		break;
+	case 'i':
+		field->kind = SERDE_FIELD_INT;
+		field->size = sizeof(int);
+		sized = true;
+		break;
+	case 'I':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(int);
+		sized = true;
+		break;
+	case 'l':
+		field->kind = SERDE_FIELD_INT;
+		field->size = sizeof(long);
+		break;
+	case 'L':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(long);
+		break;
+	case 'j':
+		field->kind = SERDE_FIELD_INT;
+		field->size = sizeof(lua_Integer);
+		break;
+	case 'J':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(lua_Integer);
+		break;
+	case 'T':
+		field->kind = SERDE_FIELD_UINT;
+		field->size = sizeof(size_t);
+		break;
+	case 'f':
+		field->kind = SERDE_FIELD_FLOAT;
+		field->size = sizeof(float);
+		break;
+	case 'd':
+		field->kind = SERDE_FIELD_FLOAT;
+		field->size = sizeof(double);
+		break;
+	case 'n':
+		field->kind = SERDE_FIELD_FLOAT;
+		field->size = sizeof(lua_Number);
+		break;
+	case 's':
+		field->kind = SERDE_FIELD_STRING;
+		field->size = sizeof(size_t);
+		sized = true;
+		break;
+	default:
+		return (false);
+	}
+	if (sized && isdigit((unsigned char)*fmt)) {
+		field->size = *fmt++ - '0';
+	}
+	if (*fmt != '\0') {
+		return (false);
+	}
+	switch (field->size) {
+	case 1:
+	case 2:
+	case 4:
+	case 8:
+		break;
+	default:
+		return (false);
+	}
+	return (field->kind != SERDE_FIELD_FLOAT ||
+	    field->size == sizeof(float) || field->size == sizeof(double));
+}
+
+static int
+compare_names(const void *a, const void *b)
+{
+	return (strcmp(*(const char * const *)a, *(const char * const *)b));
+}
+
+static int
+l_ck_serde_schema(lua_State *L)
+{
+	struct serde_schema *schema;
+	struct serde_field *fields;
+	const char **names;
+	const char *layout;
+	char *copy;
+	luaL_Buffer b;
+	ck_ht_entry_t entry;
+	ck_ht_hash_t hash;
+	size_t len;
+	unsigned n, i;
+	bool ok;
+
+	luaL_checktype(L, 1, LUA_TTABLE);
+	lua_settop(L, 1);
+
+	n = 0;
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		luaL_argcheck(L, lua_type(L, -2) == LUA_TSTRING &&
+		    lua_type(L, -1) == LUA_TSTRING, 1,
+		    "fields must map names to formats");
+		lua_pop(L, 1);
+		n++;
+	}
+	luaL_argcheck(L, n > 0, 1, "no fields");
+	names = lua_newuserdatauv(L, sizeof(*names) * n, 0);
+	fields = lua_newuserdatauv(L, sizeof(*fields) * n, 0);
+	/* The names are kept alive by the table of fields. */
+	i = 0;
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		lua_pop(L, 1);
+		names[i++] = lua_tostring(L, -1);
+	}
+	/* Fields are laid out in order of their names. */
+	qsort(names, n, sizeof(*names), compare_names);
+	for (i = 0; i < n; i++) {
+		const char *fmt;
+
+		lua_getfield(L, 1, names[i]);
+		fmt = lua_tostring(L, -1);
+		if (!parsefield(fmt, &fields[i])) {
+			return (luaL_error(L, "bad format '%s' for field '%s'",
+			    fmt, names[i]));
+		}
+		lua_pop(L, 1);
+	}
+	/* The canonical layout is "name\0<kind><size>\0" for each field. */
+	luaL_buffinit(L, &b);
+	for (i = 0; i < n; i++) {
+		luaL_addlstring(&b, names[i], strlen(names[i]) + 1);
+		luaL_addchar(&b, "iufs"[fields[i].kind]);
+		luaL_addchar(&b, '0' + fields[i].size);
+		luaL_addchar(&b, '\0');
+	}
+	luaL_pushresult(&b);
+	layout = lua_tolstring(L, -1, &len);
+	/* Hash table key length is a uint16_t parameter. */
+	luaL_argcheck(L, len <= UINT16_MAX, 1, "too many fields");
+
+	ck_ht_hash(&hash, &serde_schema_ht, layout, len);
+	ck_ht_entry_key_set(&entry, layout, len);
+	ck_epoch_begin(thread_serde_cache_record, NULL);
+	ok = ck_ht_get_spmc(&serde_schema_ht, hash, &entry);
+	ck_epoch_end(thread_serde_cache_record, NULL);
+	if (!ok) {
+		ck_epoch_begin(thread_serde_cache_record, NULL);
+		ck_spinlock_lock(&serde_cache_lock);
+		/* Look again now that no other thread can be adding it. */
+		if (!(ok = ck_ht_get_spmc(&serde_schema_ht, hash, &entry)) &&
+		    (schema = malloc(sizeof(*schema) + sizeof(*fields) * n +
+		    len)) != NULL) {
+			schema->nfields = n;
+			copy = (char *)&schema->fields[n];
+			memcpy(copy, layout, len);
+			for (i = 0; i < n; i++) {
+				schema->fields[i] = fields[i];
+				schema->fields[i].name = copy;
+				copy += strlen(copy) + 4;
+			}
+			copy = (char *)&schema->fields[n];
+			ck_ht_entry_set(&entry, hash, copy, len, schema);
+			if (!(ok = ck_ht_put_spmc(&serde_schema_ht, hash,
+			    &entry))) {
+				free(schema);
+			}
+		}
+		ck_spinlock_unlock(&serde_cache_lock);
+		ck_epoch_end(thread_serde_cache_record, NULL);
+		if (!ok) {
+			return (fatal(L, "malloc", ENOMEM));
+		}
+	}
+	pushschema(L, ck_ht_entry_value(&entry));
+	return (1);
+}
+
+/*
+ * Make the given table, or a new one, a record of the schema.
+ */
+static int
+l_ck_serde_schema_call(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	if (lua_isnoneornil(L, 2)) {
+		lua_settop(L, 1);
+		lua_newtable(L);
+	}
+	luaL_checktype(L, 2, LUA_TTABLE);
+	lua_settop(L, 2);
+
+	lua_pushvalue(L, 1);
+	lua_setmetatable(L, 2);
+	return (1);
+}
+
 static inline const void * _Nonnull
 consume(const void * _Nonnull p, size_t len, void * _Nonnull dst)
 {
@@ -308,56 +702,369 @@ consume(const void * _Nonnull p, size_t len, void * _Nonnull dst)
 }
 
 static inline const void *loadsharedimpl(lua_State *, const void * _Nonnull,
-    bool * _Nonnull);
+    int, int);
 
+/*
+ * Find the end of the bytecode of a serialized Lua closure.
+ */
 static inline const void *
-loadupvalues(lua_State *L, const void * _Nonnull p, bool * _Nonnull envp)
+skipbytecode(const void * _Nonnull p)
 {
-	unsigned count;
+	size_t size;
 
-	p = consume(p, sizeof(count), &count);
-	while (count-- > 0 && (p = loadsharedimpl(L, p, envp)) != NULL) {
-		continue;
+	p = consume(p, sizeof(size), &size);
+	if (size == 0) {
+		return (p + sizeof(const struct serde_bytecode *));
 	}
-	assert(p != NULL || lua_type(L, -1) == LUA_TSTRING);
-	return (p);
+	return (p + size);
 }
 
+/*
+ * Load a closure from its bytecode.  Undumping is much more expensive than
+ * hashing the bytecode, so a closure without upvalues of its own (other than
+ * _ENV) is looked up in the state's closure cache first.  Such a closure has
+ * no state, so the same one can be shared by every load of the bytecode.
+ * Closures with upvalues always get a fresh copy, as the upvalues would
+ * otherwise be shared as well.
+ */
 static inline const void *
-loadclosure(lua_State *L, const void * _Nonnull p)
+loadclosure(lua_State *L, const void * _Nonnull p, bool stateless)
 {
+	const struct serde_bytecode *bc;
+	const void *code;
 	size_t size;
 
 	p = consume(p, sizeof(size), &size);
-	if (luaL_loadbufferx(L, p, size, NULL, "b") != LUA_OK) {
+	if (size == 0) {
+		/* A size of 0 is followed by a reference to interned bytecode. */
+		p = consume(p, sizeof(bc), &bc);
+		code = bc->data;
+		size = bc->size;
+	} else {
+		bc = NULL;
+		code = p;
+		p += size;
+	}
+	if (!stateless) {
+		if (luaL_loadbufferx(L, code, size, NULL, "b") != LUA_OK) {
+			/* error message pushed by lua_load */
+			assert(lua_type(L, -1) == LUA_TSTRING);
+			return (NULL);
+		}
+		return (p);
+	}
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &serde_closure_cache);
+	/* ..., cache */
+	if (bc != NULL) {
+		/* Interned bytecode is identified by its address. */
+		lua_pushlightuserdata(L, __DECONST(void *, bc));
+	} else {
+		lua_pushlstring(L, code, size);
+	}
+	/* ..., cache, bytecode */
+	lua_pushvalue(L, -1);
+	/* ..., cache, bytecode, bytecode */
+	if (lua_rawget(L, -3) == LUA_TFUNCTION) {
+		/* ..., cache, bytecode, fn */
+		lua_insert(L, -3);
+		/* ..., fn, cache, bytecode */
+		lua_pop(L, 2);
+		/* ..., fn */
+		return (p);
+	}
+	/* ..., cache, bytecode, nil */
+	lua_pop(L, 1);
+	/* ..., cache, bytecode */
+	if (luaL_loadbufferx(L, code, size, NULL, "b") != LUA_OK) {
 		/* error message pushed by lua_load */
 		assert(lua_type(L, -1) == LUA_TSTRING);
 		return (NULL);
 	}
-	return (p + size);
+	/* ..., cache, bytecode, fn */
+	lua_insert(L, -3);
+	/* ..., fn, cache, bytecode */
+	lua_pushvalue(L, -3);
+	/* ..., fn, cache, bytecode, fn */
+	lua_rawset(L, -3);
+	/* ..., fn, cache */
+	lua_pop(L, 1);
+	/* ..., fn */
+	return (p);
 }
 
+/*
+ * Register the table or function at idx as the next member of the graph being
+ * loaded, in the same order the serializer numbered them.
+ */
 static inline void
-setupvalues(lua_State *L, int bottom, bool env)
+addref(lua_State *L, int idx, int refs)
 {
-	assert(lua_isfunction(L, -1));
-	for (int idx = bottom, fidx = lua_gettop(L), n = 1; idx < fidx; n++) {
-		if (n == 1 && env) {
+	lua_pushvalue(L, idx);
+	lua_rawseti(L, refs, lua_rawlen(L, refs) + 1);
+}
+
+/*
+ * Load a closure and then its upvalues.  The closure is created first so that
+ * upvalues can refer back to it.  The outermost closure of a value starts the
+ * table of references for the graph reachable from its upvalues.
+ */
+static const void *
+loadfunction(lua_State *L, const void * _Nonnull p, serde_type_code type,
+    int refs, int depth)
+{
+	unsigned count;
+	int fidx;
+
+	p = consume(p, sizeof(count), &count);
+	if (!lua_checkstack(L, count + 4)) {
+		lua_pushliteral(L, "stack overflow");
+		return (NULL);
+	}
+	if (type == SERDE_LCLOSURE) {
+		serde_type_code first;
+		bool stateless;
+
+		/* Only _ENV as an upvalue leaves the closure without state. */
+		if (count == 1) {
+			memcpy(&first, skipbytecode(p), sizeof(first));
+			stateless = first == SERDE_ENV;
+		} else {
+			stateless = count == 0;
+		}
+		if ((p = loadclosure(L, p, stateless)) == NULL) {
+			assert(lua_type(L, -1) == LUA_TSTRING);
+			return (NULL);
+		}
+	} else {
+		lua_CFunction value;
+
+		p = consume(p, sizeof(value), &value);
+		for (unsigned i = 0; i < count; i++) {
+			lua_pushnil(L);
+		}
+		lua_pushcclosure(L, value, count);
+	}
+	fidx = lua_gettop(L);
+	if (refs == 0) {
+		lua_newtable(L);
+		refs = lua_gettop(L);
+	}
+	addref(L, fidx, refs);
+	for (unsigned i = 1; i <= count; i++) {
+		serde_type_code uvtype;
+
+		memcpy(&uvtype, p, sizeof(uvtype));
+		switch (uvtype) {
+		case SERDE_ENV:
+			p += sizeof(uvtype);
+			lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+			break;
+		case SERDE_UPVALREF: {
+			int ref;
+
+			/* Shared with an upvalue of a closure already loaded. */
+			p += sizeof(uvtype);
+			p = consume(p, sizeof(ref), &ref);
+			if (type != SERDE_LCLOSURE ||
+			    lua_rawgeti(L, refs, ref >> 8) != LUA_TFUNCTION ||
+			    lua_iscfunction(L, -1)) {
+				lua_pushliteral(L, "invalid upvalue reference");
+				return (NULL);
+			}
+			lua_upvaluejoin(L, fidx, i, -1, ref & 0xff);
+			lua_pop(L, 1);
 			continue;
 		}
-		lua_pushvalue(L, idx++);
-		lua_setupvalue(L, fidx, n);
+		default:
+			if ((p = loadsharedimpl(L, p, refs, depth + 1)) ==
+			    NULL) {
+				assert(lua_type(L, -1) == LUA_TSTRING);
+				return (NULL);
+			}
+			break;
+		}
+		if (lua_setupvalue(L, fidx, i) == NULL) {
+			lua_pushliteral(L, "invalid upvalue");
+			return (NULL);
+		}
+	}
+	/* Remove the references, if this closure started them. */
+	lua_settop(L, fidx);
+	return (p);
+}
+
+/*
+ * Load a table reachable from the upvalues of a closure.  Tables are only
+ * serialized as members of such a graph, so refs must be valid.
+ */
+static const void *
+loadtable(lua_State *L, const void * _Nonnull p, int refs, int depth)
+{
+	serde_type_code type;
+	int tidx;
+
+	if (!lua_checkstack(L, 4)) {
+		lua_pushliteral(L, "stack overflow");
+		return (NULL);
+	}
+	lua_newtable(L);
+	tidx = lua_gettop(L);
+	addref(L, tidx, refs);
+	for (;;) {
+		memcpy(&type, p, sizeof(type));
+		if (type == SERDE_NIL) {
+			/* No key can be nil, so nil ends the table. */
+			return (p + sizeof(type));
+		}
+		if ((p = loadsharedimpl(L, p, refs, depth + 1)) == NULL ||
+		    (p = loadsharedimpl(L, p, refs, depth + 1)) == NULL) {
+			assert(lua_type(L, -1) == LUA_TSTRING);
+			return (NULL);
+		}
+		lua_rawset(L, tidx);
 	}
-	/* Remove the upvalues, leaving the closure. */
-	lua_insert(L, bottom);
-	lua_settop(L, bottom);
 }
 
 static inline const void *
-loadsharedimpl(lua_State *L, const void * _Nonnull p, bool * _Nonnull envp)
+consumeint(const void * _Nonnull p, const struct serde_field *field,
+    lua_Integer *valuep)
+{
+#define CONSUME_INT(T) do { \
+	T value; \
+	p = consume(p, sizeof(value), &value); \
+	*valuep = value; \
+} while (0)
+	switch (field->size) {
+	case 1:
+		if (field->kind == SERDE_FIELD_INT) {
+			CONSUME_INT(int8_t);
+		} else {
+			CONSUME_INT(uint8_t);
+		}
+		break;
+	case 2:
+		if (field->kind == SERDE_FIELD_INT) {
+			CONSUME_INT(int16_t);
+		} else {
+			CONSUME_INT(uint16_t);
+		}
+		break;
+	case 4:
+		if (field->kind == SERDE_FIELD_INT) {
+			CONSUME_INT(int32_t);
+		} else {
+			CONSUME_INT(uint32_t);
+		}
+		break;
+	default:
+		CONSUME_INT(int64_t);
+		break;
+	}
+#undef CONSUME_INT
+	return (p);
+}
+
+/*
+ * Load a record, laid out by its schema with no type codes between fields.
+ */
+static const void *
+loadrecord(lua_State *L, const void * _Nonnull p)
+{
+	const struct serde_schema *schema;
+	lua_Integer value;
+
+	p = consume(p, sizeof(schema), &schema);
+	if (!lua_checkstack(L, 4)) {
+		lua_pushliteral(L, "stack overflow");
+		return (NULL);
+	}
+	lua_createtable(L, 0, schema->nfields);
+	for (unsigned i = 0; i < schema->nfields; i++) {
+		const struct serde_field *field = &schema->fields[i];
+
+		switch (field->kind) {
+		case SERDE_FIELD_FLOAT:
+			if (field->size == sizeof(float)) {
+				float v;
+
+				p = consume(p, sizeof(v), &v);
+				lua_pushnumber(L, v);
+			} else {
+				double v;
+
+				p = consume(p, sizeof(v), &v);
+				lua_pushnumber(L, v);
+			}
+			break;
+		case SERDE_FIELD_STRING:
+			p = consumeint(p, field, &value);
+			lua_pushlstring(L, p, value);
+			p += value;
+			break;
+		default:
+			p = consumeint(p, field, &value);
+			lua_pushinteger(L, value);
+			break;
+		}
+		lua_setfield(L, -2, field->name);
+	}
+	pushschema(L, schema);
+	lua_setmetatable(L, -2);
+	return (p);
+}
+
+/*
+ * Load a value compressed by serdebuf_serialize().  The value is decompressed
+ * into a temporary buffer each time it is loaded.
+ */
+static const void *
+loadcompressed(lua_State *L, const void * _Nonnull p, int refs, int depth)
+{
+#ifdef SERDE_ZSTD
+	const void *end;
+	void *buf;
+	size_t size, csize, result;
+
+	p = consume(p, sizeof(size), &size);
+	p = consume(p, sizeof(csize), &csize);
+	if ((buf = malloc(size)) == NULL) {
+		lua_pushliteral(L, "not enough memory");
+		return (NULL);
+	}
+	result = ZSTD_decompress(buf, size, p, csize);
+	if (ZSTD_isError(result) || result != size) {
+		free(buf);
+		lua_pushfstring(L, "ZSTD_decompress: %s",
+		    ZSTD_isError(result) ? ZSTD_getErrorName(result) :
+		    "short value");
+		return (NULL);
+	}
+	end = loadsharedimpl(L, buf, refs, depth);
+	free(buf);
+	if (end == NULL) {
+		assert(lua_type(L, -1) == LUA_TSTRING);
+		return (NULL);
+	}
+	return (p + csize);
+#else
+	lua_pushliteral(L, "compressed values not supported");
+	return (NULL);
+#endif
+}
+
+/*
+ * Load a value nested depth tables and functions deep in the graph being
+ * loaded.
+ */
+static inline const void *
+loadsharedimpl(lua_State *L, const void * _Nonnull p, int refs, int depth)
 {
 	serde_type_code type;
 
+	if (depth > SERDE_MAX_DEPTH) {
+		lua_pushliteral(L, "value nested too deeply");
+		return (NULL);
+	}
 	p = consume(p, sizeof(type), &type);
 	if (type < 0) {
 		lua_pushfstring(L, "invalid type (%d)", type);
@@ -365,8 +1072,9 @@ loadsharedimpl(lua_State *L, const void * _Nonnull p, bool * _Nonnull envp)
 	}
 	switch (type) {
 	case SERDE_ENV:
-		*envp = true;
-		return (p);
+		/* Only valid as an upvalue, handled by loadfunction(). */
+		lua_pushliteral(L, "invalid SERDE_ENV");
+		return (NULL);
 	case SERDE_NIL:
 		lua_pushnil(L);
 		return (p);
@@ -405,33 +1113,27 @@ loadsharedimpl(lua_State *L, const void * _Nonnull p, bool * _Nonnull envp)
 		lua_pushlstring(L, p, len);
 		return (p + len);
 	}
-	case SERDE_LCLOSURE: {
-		int bottom = lua_gettop(L) + 1;
-		bool env = false;
-
-		if ((p = loadupvalues(L, p, &env)) == NULL) {
-			assert(lua_type(L, -1) == LUA_TSTRING);
-			return (NULL);
-		}
-		if ((p = loadclosure(L, p)) == NULL) {
-			assert(lua_type(L, -1) == LUA_TSTRING);
+	case SERDE_LCLOSURE:
+	case SERDE_CCLOSURE:
+		return (loadfunction(L, p, type, refs, depth));
+	case SERDE_TABLE:
+		if (refs == 0) {
+			lua_pushliteral(L, "invalid SERDE_TABLE");
 			return (NULL);
 		}
-		setupvalues(L, bottom, env);
-		return (p);
-	}
-	case SERDE_CCLOSURE: {
-		lua_CFunction value;
-		int bottom = lua_gettop(L) + 1;
-		bool env = false;
+		return (loadtable(L, p, refs, depth));
+	case SERDE_RECORD:
+		return (loadrecord(L, p));
+	case SERDE_COMPRESSED:
+		return (loadcompressed(L, p, refs, depth));
+	case SERDE_REF: {
+		int ref;
 
-		if ((p = loadupvalues(L, p, &env)) == NULL) {
-			assert(lua_type(L, -1) == LUA_TSTRING);
+		p = consume(p, sizeof(ref), &ref);
+		if (refs == 0 || lua_rawgeti(L, refs, ref) == LUA_TNIL) {
+			lua_pushliteral(L, "invalid reference");
 			return (NULL);
 		}
-		p = consume(p, sizeof(value), &value);
-		lua_pushcfunction(L, value);
-		setupvalues(L, bottom, env);
 		return (p);
 	}
 	default: {
@@ -520,23 +1222,48 @@ loadsharedimpl(lua_State *L, const void * _Nonnull p, bool * _Nonnull envp)
 const void *
 loadshared(lua_State *L, const void * _Nonnull p)
 {
-	bool env;
-
-	if ((p = loadsharedimpl(L, p, &env)) == NULL || env) {
-		if (env) {
-			lua_pushliteral(L, "invalid SERDE_ENV");
-		}
+	if ((p = loadsharedimpl(L, p, 0, 0)) == NULL) {
 		assert(lua_type(L, -1) == LUA_TSTRING);
 		return (NULL);
 	}
 	return (p);
 }
 
+/*
+ * Load a list of values serialized by serdebuf_serialize_list().  On failure,
+ * the error message is pushed above any values that were already loaded.
+ */
+const void *
+loadsharedlist(lua_State *L, const void * _Nonnull p, int * _Nonnull np)
+{
+	int n;
+
+	p = consume(p, sizeof(n), &n);
+	luaL_checkstack(L, n, "too many values");
+	for (int i = 0; i < n; i++) {
+		if ((p = loadshared(L, p)) == NULL) {
+			return (NULL);
+		}
+	}
+	*np = n;
+	return (p);
+}
+
 static const struct luaL_Reg l_ck_epoch_record_meta[] = {
 	{"__gc", l_ck_epoch_record_gc},
 	{NULL, NULL}
 };
 
+static const struct luaL_Reg l_ck_serde_funcs[] = {
+	{"schema", l_ck_serde_schema},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_serde_schema_meta[] = {
+	{"__call", l_ck_serde_schema_call},
+	{NULL, NULL}
+};
+
 int
 luaopen_ck_serde(lua_State *L)
 {
@@ -549,5 +1276,26 @@ luaopen_ck_serde(lua_State *L)
 	lua_newtable(L);
 	lua_rawsetp(L, LUA_REGISTRYINDEX, serde_cache);
 
+	lua_newtable(L);
+	lua_createtable(L, 0, 1);
+	lua_pushliteral(L, "v");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &serde_closure_cache);
+
+	lua_newtable(L);
+	lua_createtable(L, 0, 1);
+	lua_pushliteral(L, "k");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &serde_bytecode_refs);
+
+	luaL_newmetatable(L, SERDE_SCHEMA_METATABLE);
+	luaL_setfuncs(L, l_ck_serde_schema_meta, 0);
+	lua_pop(L, 1);
+	lua_newtable(L);
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &serde_schemas);
+
+	luaL_newlib(L, l_ck_serde_funcs); /* ck.serde */
 	return (1);
 }
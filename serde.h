@@ -37,11 +37,41 @@ enum serde_type {
 	SERDE_STRING,
 	SERDE_CCLOSURE,
 	SERDE_LCLOSURE,
+	SERDE_TABLE, /* only reachable from upvalues */
+	SERDE_REF, /* to a table or function already serialized */
+	SERDE_UPVALREF, /* to an upvalue of a closure already serialized */
+	SERDE_RECORD, /* table with a schema for its metatable */
+	SERDE_COMPRESSED, /* wraps a large value, see serdebuf_serialize() */
 	SERDE_CUSTOM, /* marker */
 	SERDE_INVALID = -1,
 	SERDE_ANY = -2
 };
 
+/*
+ * A schema compiled by ck.serde.schema() describes the fields of a record, in
+ * order of their names.  Schemas are interned for the life of the process, so
+ * a serialized record refers to its schema by address.
+ */
+enum serde_field_kind {
+	SERDE_FIELD_INT,
+	SERDE_FIELD_UINT,
+	SERDE_FIELD_FLOAT,
+	SERDE_FIELD_STRING, /* size is that of the length prefix */
+};
+
+struct serde_field {
+	const char *name;
+	uint8_t kind;
+	uint8_t size;
+};
+
+struct serde_schema {
+	unsigned nfields;
+	struct serde_field fields[];
+};
+
+const struct serde_schema *getschema(lua_State *L, int idx);
+
 static inline enum serde_type
 serde_type(lua_State *L, int idx)
 {
@@ -56,6 +86,10 @@ serde_type(lua_State *L, int idx)
 		return (SERDE_NUMBER);
 	case LUA_TSTRING: return (SERDE_STRING);
 	case LUA_TTABLE:
+		if (getschema(L, idx) != NULL) {
+			return (SERDE_RECORD);
+		}
+		/* FALLTHROUGH */
 	case LUA_TUSERDATA:
 		if (getserdemethods(L, idx) != 0) {
 			return (SERDE_INVALID);
@@ -73,6 +107,29 @@ serde_type(lua_State *L, int idx)
 
 typedef int8_t serde_type_code;
 
+/*
+ * Tables and functions reachable from upvalues are serialized and loaded
+ * recursively, so how deeply they can be nested is limited, like Lua limits
+ * nested C calls.
+ */
+#ifndef SERDE_MAX_DEPTH
+#define SERDE_MAX_DEPTH 200
+#endif
+
+/*
+ * The bytecode of a Lua function, interned for the life of the process.  A
+ * serialized Lua closure refers to interned bytecode rather than carrying its
+ * own copy whenever possible.
+ */
+struct serde_bytecode {
+	size_t size;
+	char data[];
+};
+
 int cache_serde(lua_State *L, int idx, serde_type_code *tp);
+const struct serde_bytecode *lookup_bytecode(lua_State *L, int idx);
+const struct serde_bytecode *intern_bytecode(lua_State *L, int idx,
+    const void *p, size_t size);
 const void *loadshared(lua_State *L, const void *p);
+const void *loadsharedlist(lua_State *L, const void *p, int *np);
 int luaopen_ck_serde(lua_State *L);
@@ -7,13 +7,16 @@
 #include <sys/param.h>
 #include <assert.h>
 #include <errno.h>
-#include <malloc_np.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <ck_md.h>
 
+#ifdef SERDE_ZSTD
+#include <zstd.h>
+#endif
+
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
@@ -21,6 +24,14 @@
 #include "common.h"
 #include "serde.h"
 #include "serdebuf.h"
+#include "stats.h"
+
+#ifndef SERDE_COMPRESS_MIN
+#define SERDE_COMPRESS_MIN CK_MD_PAGESIZE /* smallest value to compress */
+#endif
+#ifndef SERDE_COMPRESS_LEVEL
+#define SERDE_COMPRESS_LEVEL 1 /* favor speed */
+#endif
 
 static const size_t serde_type_size[] = {
 	[SERDE_ENV] = 0,
@@ -35,12 +46,13 @@ static const size_t serde_type_size[] = {
 	 */
 	[SERDE_STRING] = sizeof(size_t),
 	/*
-	 * Closures have upvalues prefixed (nupvalues, upvalues).
+	 * Closures have the number of upvalues prefixed, and the upvalues
+	 * follow the function itself.
 	 *
-	 * Lua closures have bytecode with length prefixed after upvalues:
+	 * Lua closures have bytecode with length prefixed:
 	 * [SERDE_LCLOSURE] = sizeof(unsigned) + sizeof(size_t),
 	 *
-	 * C closures have a function pointer after upvalues:
+	 * C closures have a function pointer:
 	 * [SERDE_CCLOSURE] = sizeof(unsigned) + sizeof(lua_CFunction),
 	 *
 	 * Both forms of closures require indeterminate space for upvalues and
@@ -60,6 +72,14 @@ static const size_t serde_type_size[] = {
 	 * buffer.
 	 */
 	[SERDE_CUSTOM] = CK_MD_CACHELINE,
+	/*
+	 * Records have a schema pointer followed by fields that are mostly
+	 * small, and strings with a length prefixed:
+	 * [SERDE_RECORD] = sizeof(struct serde_schema *),
+	 *
+	 * Allocate a conservatively sized buffer.
+	 */
+	[SERDE_RECORD] = CK_MD_CACHELINE,
 };
 
 static inline int
@@ -140,72 +160,42 @@ serdebuf_append(struct serdebuf *sb, const void *p, size_t len)
 	return (0);
 }
 
+static int
+serdebuf_writer(lua_State *L __unused, const void *p, size_t sz, void *ud)
+{
+	struct serdebuf *sb = ud;
+
+	return (serdebuf_append(sb, p, sz));
+}
+
 /*
- * Upvalue serialization imposes a few constraints to keep things simple:
- *
- *  - Upvalues must be serializable, obviously.
- *
- *  - Upvalues cannot be functions.
- *
- *  - Upvalues cannot require use of a custom serde.
- *
- *  - Upvalue identity is not maintained.
- *
- * The latter three constraints are required to avoid having to encode a
- * potentially cyclic graph of references.  It's possible, but is it worth the
- * complexity?
+ * Interned bytecode is referenced by a size of 0 followed by the address of
+ * the interned copy.
  */
 static inline int
-serdebuf_serialize_upvalues(lua_State *L, int idx, struct serdebuf *sb)
+serdebuf_bytecode_ref(struct serdebuf *sb, const struct serde_bytecode *bc)
 {
-	const char *name;
-	unsigned *countp, i;
-	size_t count_offset = serdebuf_size(sb);
+	size_t size = 0;
 	int error;
 
-	/* Make room for the count to be filled in later. */
-	if ((error = serdebuf_append(sb, &i, sizeof(i))) != 0) {
+	if ((error = serdebuf_append(sb, &size, sizeof(size))) != 0) {
 		return (error);
 	}
-	for (i = 1; (name = lua_getupvalue(L, idx, i)) != NULL; i++) {
-		serde_type_code type;
-
-		if (strcmp(name, "_ENV") == 0) {
-			type = SERDE_ENV;
-		} else switch (lua_type(L, -1)) {
-		case LUA_TFUNCTION:
-		case LUA_TTABLE:
-		case LUA_TUSERDATA:
-		case LUA_TTHREAD:
-			return (EINVAL);
-		default:
-			type = SERDE_ANY;
-		}
-		if ((error = serdebuf_serialize(L, -1, sb, &type)) != 0) {
-			return (error);
-		}
-		lua_pop(L, 1);
-	}
-	countp = sb->buf + count_offset;
-	*countp = i - 1;
-	return (0);
-}
-
-static int
-serdebuf_writer(lua_State *L __unused, const void *p, size_t sz, void *ud)
-{
-	struct serdebuf *sb = ud;
-
-	return (serdebuf_append(sb, p, sz));
+	return (serdebuf_append(sb, &bc, sizeof(bc)));
 }
 
 static inline int
 serdebuf_dump(lua_State *L, int idx, struct serdebuf *sb)
 {
+	const struct serde_bytecode *bc;
 	size_t *sizep;
 	size_t start;
 	int error;
 
+	idx = lua_absindex(L, idx);
+	if ((bc = lookup_bytecode(L, idx)) != NULL) {
+		return (serdebuf_bytecode_ref(sb, bc));
+	}
 	/* Make room for the size to be filled in later. */
 	if ((error = serdebuf_append(sb, &start, sizeof(start))) != 0) {
 		return (error);
@@ -218,6 +208,11 @@ serdebuf_dump(lua_State *L, int idx, struct serdebuf *sb)
 	lua_pop(L, 1);
 	sizep = sb->buf + start - sizeof(start);
 	*sizep = serdebuf_size(sb) - start;
+	if ((bc = intern_bytecode(L, idx, sb->buf + start, *sizep)) != NULL) {
+		/* Replace the copy with a reference. */
+		sb->cur = sb->buf + start - sizeof(start);
+		return (serdebuf_bytecode_ref(sb, bc));
+	}
 	return (0);
 }
 
@@ -269,14 +264,334 @@ serdebuf_serialize_custom(lua_State *L, int idx, struct serdebuf *sb)
 	return (0);
 }
 
+static inline int
+serdebuf_append_int(struct serdebuf *sb, lua_Integer value, size_t size)
+{
+#define APPEND_INT(T) do { \
+	T v = value; \
+	return (serdebuf_append(sb, &v, sizeof(v))); \
+} while (0)
+	switch (size) {
+	case 1:
+		APPEND_INT(int8_t);
+	case 2:
+		APPEND_INT(int16_t);
+	case 4:
+		APPEND_INT(int32_t);
+	default:
+		APPEND_INT(int64_t);
+	}
+#undef APPEND_INT
+}
+
+/*
+ * Check that an integer fits in a field, as string.pack() does.
+ */
+static inline bool
+serdebuf_field_fits(const struct serde_field *field, lua_Integer value)
+{
+	lua_Unsigned limit;
+
+	if (field->size >= sizeof(lua_Integer)) {
+		return (true);
+	}
+	limit = (lua_Unsigned)1 << (field->size * NBBY - 1);
+	if (field->kind == SERDE_FIELD_INT) {
+		return ((lua_Unsigned)value + limit < limit << 1);
+	}
+	return ((lua_Unsigned)value < limit << 1);
+}
+
+/*
+ * Serialize the value on top of the stack as a field of a record.  An invalid
+ * value leaves an error on top of the stack.
+ */
+static int
+serdebuf_serialize_field(lua_State *L, const struct serde_field *field,
+    struct serdebuf *sb)
+{
+	const char *expected;
+	int isnum, error;
+
+	switch (field->kind) {
+	case SERDE_FIELD_FLOAT: {
+		lua_Number value = lua_tonumberx(L, -1, &isnum);
+
+		if (!isnum) {
+			expected = "number";
+			break;
+		}
+		if (field->size == sizeof(float)) {
+			float v = value;
+
+			return (serdebuf_append(sb, &v, sizeof(v)));
+		} else {
+			double v = value;
+
+			return (serdebuf_append(sb, &v, sizeof(v)));
+		}
+	}
+	case SERDE_FIELD_STRING: {
+		const char *value;
+		size_t len;
+
+		if (lua_type(L, -1) != LUA_TSTRING) {
+			expected = "string";
+			break;
+		}
+		value = lua_tolstring(L, -1, &len);
+		if (!serdebuf_field_fits(field, len)) {
+			lua_pushfstring(L, "string too long for field '%s'",
+			    field->name);
+			return (-LUA_ERRRUN);
+		}
+		if ((error = serdebuf_append_int(sb, len, field->size)) != 0) {
+			return (error);
+		}
+		return (serdebuf_append(sb, value, len));
+	}
+	default: {
+		lua_Integer value = lua_tointegerx(L, -1, &isnum);
+
+		if (!isnum) {
+			expected = "integer";
+			break;
+		}
+		if (!serdebuf_field_fits(field, value)) {
+			lua_pushfstring(L, "integer overflow for field '%s'",
+			    field->name);
+			return (-LUA_ERRRUN);
+		}
+		return (serdebuf_append_int(sb, value, field->size));
+	}
+	}
+	lua_pushfstring(L, "bad field '%s' (%s expected, got %s)", field->name,
+	    expected, luaL_typename(L, -1));
+	return (-LUA_ERRRUN);
+}
+
+/*
+ * A record is serialized as the address of its schema followed by each field
+ * in the order of the schema, without type codes.
+ */
+static int
+serdebuf_serialize_record(lua_State *L, int idx, struct serdebuf *sb)
+{
+	const struct serde_schema *schema;
+	int error;
+
+	idx = lua_absindex(L, idx);
+	schema = getschema(L, idx);
+	if ((error = serdebuf_append(sb, &schema, sizeof(schema))) != 0) {
+		return (error);
+	}
+	for (unsigned i = 0; i < schema->nfields; i++) {
+		const struct serde_field *field = &schema->fields[i];
+
+		lua_getfield(L, idx, field->name);
+		if ((error = serdebuf_serialize_field(L, field, sb)) != 0) {
+			return (error);
+		}
+		lua_pop(L, 1);
+	}
+	return (0);
+}
+
+/*
+ * The values reachable from the upvalues of a closure form a graph, in which
+ * tables and functions may be shared or even refer back to the closure.  Each
+ * table and function is numbered in the order it is first reached, and later
+ * occurrences refer back to its number.  Upvalues shared between Lua closures
+ * are likewise joined again by referring back to the closure and upvalue
+ * first seen.  The numbering is kept in a table on the stack at index refs:
+ *
+ *   refs[0] = count
+ *   refs[table or function] = number
+ *   refs[upvalue id] = number << 8 | upvalue index
+ *
+ * An upvalue holding the global table is _ENV for the purposes of
+ * serialization, even if the closure was loaded from stripped bytecode and the
+ * upvalue has lost its name.  Tables are copied without their metatables,
+ * unless they have a custom serde, and userdata still require a custom serde.
+ * Identity is only preserved within the value being serialized.
+ */
+static inline int
+serdebuf_addref(lua_State *L, int idx, int refs)
+{
+	int n;
+
+	lua_rawgeti(L, refs, 0);
+	n = lua_tointeger(L, -1) + 1;
+	lua_pop(L, 1);
+	lua_pushinteger(L, n);
+	lua_rawseti(L, refs, 0);
+	lua_pushvalue(L, idx);
+	lua_pushinteger(L, n);
+	lua_rawset(L, refs);
+	return (n);
+}
+
+static int serdebuf_serialize_impl(lua_State *, int, struct serdebuf *,
+    serde_type_code *);
+static int serdebuf_serialize_member(lua_State *, int, struct serdebuf *,
+    int, int);
+
+static int
+serdebuf_serialize_closure(lua_State *L, int idx, struct serdebuf *sb,
+    serde_type_code type, int refs, int depth)
+{
+	const char *name;
+	unsigned *countp, i;
+	size_t count_offset;
+	int n, globals, error;
+
+	n = serdebuf_addref(L, idx, refs);
+	/* Make room for the count to be filled in later. */
+	count_offset = serdebuf_size(sb);
+	if ((error = serdebuf_append(sb, &i, sizeof(i))) != 0) {
+		return (error);
+	}
+	if (type == SERDE_LCLOSURE) {
+		error = serdebuf_dump(L, idx, sb);
+	} else {
+		lua_CFunction value = lua_tocfunction(L, idx);
+
+		error = serdebuf_append(sb, &value, sizeof(value));
+	}
+	if (error != 0) {
+		return (error);
+	}
+	lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	globals = lua_gettop(L);
+	for (i = 1; (name = lua_getupvalue(L, idx, i)) != NULL; i++) {
+		serde_type_code uvtype;
+		int top = lua_gettop(L);
+
+		if (strcmp(name, "_ENV") == 0 || lua_rawequal(L, top, globals)) {
+			uvtype = SERDE_ENV;
+			error = serdebuf_append(sb, &uvtype, sizeof(uvtype));
+		} else if (type != SERDE_LCLOSURE) {
+			error = serdebuf_serialize_member(L, top, sb, refs,
+			    depth + 1);
+		} else {
+			lua_pushlightuserdata(L, lua_upvalueid(L, idx, i));
+			if (lua_rawget(L, refs) == LUA_TNUMBER) {
+				int ref = lua_tointeger(L, -1);
+
+				uvtype = SERDE_UPVALREF;
+				if ((error = serdebuf_append(sb, &uvtype,
+				    sizeof(uvtype))) == 0) {
+					error = serdebuf_append(sb, &ref,
+					    sizeof(ref));
+				}
+			} else {
+				lua_pushlightuserdata(L, lua_upvalueid(L, idx,
+				    i));
+				lua_pushinteger(L, n << 8 | i);
+				lua_rawset(L, refs);
+				error = serdebuf_serialize_member(L, top, sb,
+				    refs, depth + 1);
+			}
+		}
+		if (error != 0) {
+			return (error);
+		}
+		lua_settop(L, top - 1);
+	}
+	lua_pop(L, 1);
+	countp = sb->buf + count_offset;
+	*countp = i - 1;
+	return (0);
+}
+
+static int
+serdebuf_serialize_table(lua_State *L, int idx, struct serdebuf *sb, int refs,
+    int depth)
+{
+	serde_type_code type;
+	int error;
+
+	serdebuf_addref(L, idx, refs);
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0) {
+		int top = lua_gettop(L);
+
+		if ((error = serdebuf_serialize_member(L, top - 1, sb, refs,
+		    depth + 1)) != 0 ||
+		    (error = serdebuf_serialize_member(L, top, sb, refs,
+		    depth + 1)) != 0) {
+			return (error);
+		}
+		lua_settop(L, top - 1);
+	}
+	/* No key can be nil, so nil ends the table. */
+	type = SERDE_NIL;
+	return (serdebuf_append(sb, &type, sizeof(type)));
+}
+
+/*
+ * Serialize a value reachable from the upvalues of a closure, nested depth
+ * tables and functions deep.
+ */
+static int
+serdebuf_serialize_member(lua_State *L, int idx, struct serdebuf *sb, int refs,
+    int depth)
+{
+	serde_type_code type;
+	int error;
+
+	if (depth > SERDE_MAX_DEPTH) {
+		return (EOVERFLOW);
+	}
+	if (!lua_checkstack(L, 6)) {
+		return (ENOMEM);
+	}
+	switch (lua_type(L, idx)) {
+	case LUA_TTABLE:
+		/* Records and custom serde types are not members. */
+		if (serde_type(L, idx) != SERDE_INVALID) {
+			break;
+		}
+		/* FALLTHROUGH */
+	case LUA_TFUNCTION:
+		lua_pushvalue(L, idx);
+		if (lua_rawget(L, refs) == LUA_TNUMBER) {
+			int ref = lua_tointeger(L, -1);
+
+			lua_pop(L, 1);
+			type = SERDE_REF;
+			if ((error = serdebuf_append(sb, &type, sizeof(type))) !=
+			    0) {
+				return (error);
+			}
+			return (serdebuf_append(sb, &ref, sizeof(ref)));
+		}
+		lua_pop(L, 1);
+		type = lua_istable(L, idx) ? SERDE_TABLE : serde_type(L, idx);
+		if ((error = serdebuf_append(sb, &type, sizeof(type))) != 0) {
+			return (error);
+		}
+		if (type == SERDE_TABLE) {
+			return (serdebuf_serialize_table(L, idx, sb, refs,
+			    depth));
+		}
+		return (serdebuf_serialize_closure(L, idx, sb, type, refs,
+		    depth));
+	default:
+		break;
+	}
+	type = SERDE_ANY;
+	return (serdebuf_serialize_impl(L, idx, sb, &type));
+}
+
 static inline serde_type_code
 serde_type_encode(lua_State *L, int idx, serde_type_code t)
 {
 	return (t == SERDE_ANY ? serde_type(L, idx) : t);
 }
 
-int
-serdebuf_serialize(lua_State *L, int idx, struct serdebuf *sb,
+static int
+serdebuf_serialize_impl(lua_State *L, int idx, struct serdebuf *sb,
     serde_type_code *typep)
 {
 	size_t type_offset = serdebuf_size(sb);
@@ -321,20 +636,23 @@ serdebuf_serialize(lua_State *L, int idx, struct serdebuf *sb,
 		}
 		return (serdebuf_append(sb, value, len));
 	}
-	case SERDE_LCLOSURE: {
-		if ((error = serdebuf_serialize_upvalues(L, idx, sb)) != 0) {
-			return (error);
-		}
-		return (serdebuf_dump(L, idx, sb));
-	}
+	case SERDE_LCLOSURE:
 	case SERDE_CCLOSURE: {
-		lua_CFunction value = lua_tocfunction(L, idx);
-
-		if ((error = serdebuf_serialize_upvalues(L, idx, sb)) != 0) {
+		int refs;
+
+		/* This closure starts a new graph of references. */
+		idx = lua_absindex(L, idx);
+		lua_newtable(L);
+		refs = lua_gettop(L);
+		if ((error = serdebuf_serialize_closure(L, idx, sb, type,
+		    refs, 0)) != 0) {
 			return (error);
 		}
-		return (serdebuf_append(sb, &value, sizeof(value)));
+		lua_pop(L, 1);
+		return (0);
 	}
+	case SERDE_RECORD:
+		return (serdebuf_serialize_record(L, idx, sb));
 	case SERDE_CUSTOM:
 		if ((error = cache_serde(L, idx, typep)) != 0) {
 			return (error);
@@ -347,6 +665,120 @@ serdebuf_serialize(lua_State *L, int idx, struct serdebuf *sb,
 	}
 }
 
+#ifdef SERDE_ZSTD
+/*
+ * Replace the serialized value starting at offset start with a compressed
+ * copy, if that makes it smaller:
+ *
+ *   [SERDE_COMPRESSED][size_t size][size_t compressed size][compressed value]
+ */
+static int
+serdebuf_compress(struct serdebuf *sb, size_t start)
+{
+	serde_type_code type = SERDE_COMPRESSED;
+	void *p;
+	size_t size, bound, csize;
+	int error;
+
+	size = serdebuf_size(sb) - start;
+	bound = ZSTD_compressBound(size);
+	if ((p = malloc(bound)) == NULL) {
+		return (ENOMEM);
+	}
+	csize = ZSTD_compress(p, bound, sb->buf + start, size,
+	    SERDE_COMPRESS_LEVEL);
+	if (ZSTD_isError(csize) ||
+	    sizeof(type) + sizeof(size) + sizeof(csize) + csize >= size) {
+		/* Not worth it, keep the value as is. */
+		free(p);
+		return (0);
+	}
+	sb->cur = sb->buf + start;
+	if ((error = serdebuf_append(sb, &type, sizeof(type))) == 0 &&
+	    (error = serdebuf_append(sb, &size, sizeof(size))) == 0 &&
+	    (error = serdebuf_append(sb, &csize, sizeof(csize))) == 0) {
+		error = serdebuf_append(sb, p, csize);
+	}
+	free(p);
+	return (error);
+}
+#else
+static inline int
+serdebuf_compress(struct serdebuf *sb __unused, size_t start __unused)
+{
+	return (0);
+}
+#endif
+
+/*
+ * Serialize the value at idx.  When built with SERDE_ZSTD, values of at least
+ * SERDE_COMPRESS_MIN bytes are compressed as a whole, and loadshared()
+ * decompresses them transparently.
+ */
+int
+serdebuf_serialize(lua_State *L, int idx, struct serdebuf *sb,
+    serde_type_code *typep)
+{
+	size_t start = serdebuf_size(sb);
+	int error;
+
+	if ((error = serdebuf_serialize_impl(L, idx, sb, typep)) != 0) {
+		return (error);
+	}
+	if (serdebuf_size(sb) - start >= SERDE_COMPRESS_MIN) {
+		return (serdebuf_compress(sb, start));
+	}
+	return (0);
+}
+
+/*
+ * Serialize n consecutive values starting at idx, prefixed by the count, for
+ * loadsharedlist().
+ */
+int
+serdebuf_serialize_list(lua_State *L, int idx, int n, struct serdebuf *sb)
+{
+	serde_type_code type;
+	int error;
+
+	idx = lua_absindex(L, idx);
+	if ((error = serdebuf_append(sb, &n, sizeof(n))) != 0) {
+		return (error);
+	}
+	for (int i = 0; i < n; i++) {
+		type = SERDE_ANY;
+		if ((error = serdebuf_serialize(L, idx + i, sb, &type)) != 0) {
+			return (error);
+		}
+	}
+	return (0);
+}
+
+/*
+ * Serialize the value at idx into a new buffer of its own.
+ */
+int
+serdebuf_serialize_value(lua_State *L, int idx, void **pp)
+{
+	struct serdebuf sb;
+	serde_type_code type;
+	int error;
+
+	if ((error = serdebuf_init(L, idx, &sb)) != 0) {
+		return (error);
+	}
+	type = SERDE_ANY;
+	if ((error = serdebuf_serialize(L, idx, &sb, &type)) != 0) {
+		serdebuf_destroy(&sb);
+		return (error);
+	}
+	if ((*pp = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		return (ENOMEM);
+	}
+	return (0);
+}
+
 void *
 serdebuf_finalize(struct serdebuf *sb, size_t *lenp)
 {
@@ -357,6 +789,8 @@ serdebuf_finalize(struct serdebuf *sb, size_t *lenp)
 	if (lenp != NULL) {
 		*lenp = size;
 	}
+	STATS_TOTAL_INC(serde, serialized);
+	STATS_TOTAL_ADD(serde, bytes, size);
 	return (rallocx(p, size, serdebuf_flags(size)));
 }
 
@@ -28,5 +28,7 @@ int serdebuf_init(lua_State *L, int idx, struct serdebuf *sb);
 int serdebuf_append(struct serdebuf *sb, const void *p, size_t len);
 int serdebuf_serialize(lua_State *L, int idx, struct serdebuf *sb,
     serde_type_code *typep);
+int serdebuf_serialize_list(lua_State *L, int idx, int n, struct serdebuf *sb);
+int serdebuf_serialize_value(lua_State *L, int idx, void **pp);
 void *serdebuf_finalize(struct serdebuf *sb, size_t *lenp);
 void serdebuf_destroy(struct serdebuf *sb);
@@ -6,12 +6,19 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <ck_cc.h>
 #include <ck_hp.h>
+#include <ck_md.h>
 #include <ck_pr.h>
+#include <ck_sequence.h>
+#include <ck_spinlock.h>
 #include <ck_stack.h>
 
 #include <lua.h>
@@ -19,18 +26,21 @@
 #include <lualib.h>
 
 #include "common.h"
+#include "hp.h"
 #include "pr.h"
+#include "probes.h"
 #include "refcount.h"
 #include "serde.h"
 #include "serdebuf.h"
+#include "stats.h"
 #include "luaerror.h"
 
-#define CK_HP_RECORD_METATABLE "ck_hp_record_t"
-
 #define SHARED_CONST_METATABLE "shared.const"
 #define SHARED_MUT_METATABLE "shared.mut"
 #define SHARED_PR_METATABLE "shared.pr"
 #define SHARED_PR128_METATABLE "shared.pr128"
+#define SHARED_PR_ARRAY_METATABLE "shared.pr.array"
+#define SHARED_PR_WIDE_METATABLE "shared.pr.wide"
 
 CK_STACK_CONTAINER(struct ck_hp_record, global_entry, ck_hp_record_container)
 
@@ -68,62 +78,14 @@ fini_hp_domains(void)
 }
 #endif
 
-#define HP_POINTERS_SIZE (sizeof(void *) * HP_NPOINTERS)
-/* Allocate the pointers immediately following the record for simplicity. */
-#define RECORD_ALLOCATION_SIZE (sizeof(ck_hp_record_t) + HP_POINTERS_SIZE)
-
-static inline void
-register_hp_record(lua_State *L, ck_hp_t *domain)
-{
-	ck_hp_record_t *record;
-
-	/*
-	 * Once registered, a record must survive for the lifetime of hp_domain.
-	 * So, we have to allocate it on the heap but keep a lightuserdata
-	 * uservalue for GC to purge and unregister the record when this thread
-	 * is closed.
-	 */
-	if ((record = ck_hp_recycle(domain)) == NULL) {
-		if ((record = malloc(RECORD_ALLOCATION_SIZE)) == NULL) {
-			fatal(L, "malloc", ENOMEM);
-		}
-		/*
-		 * The pointers follow record in the allocation and are
-		 * initialized by ck_hp_register(), so we do not need to clear
-		 * them beforehand.
-		 */
-		ck_hp_register(domain, record, (void **)(record + 1));
-	}
-	new(L, record, CK_HP_RECORD_METATABLE);
-	lua_rawsetp(L, LUA_REGISTRYINDEX, domain);
-}
-
-static int
-l_ck_hp_record_gc(lua_State *L)
-{
-	ck_hp_record_t *record;
-
-	record = checkcookie(L, 1, CK_HP_RECORD_METATABLE);
-
-	ck_hp_purge(record);
-	ck_hp_unregister(record);
-	return (0);
-}
-
-static inline ck_hp_record_t *
-gethprecord(lua_State *L, ck_hp_t *domain)
-{
-	lua_rawgetp(L, LUA_REGISTRYINDEX, domain);
-	return (checkcookie(L, -1, CK_HP_RECORD_METATABLE));
-}
-
 struct serialized {
 	void *pointer;
 	ck_hp_hazard_t hazard;
 };
 
 static inline int
-serialize(lua_State *L, int idx, struct serialized **serializedp)
+serialize(lua_State *L, int idx, struct serialized **serializedp,
+    size_t *sizep)
 {
 	struct serdebuf sb;
 	struct serialized *serialized;
@@ -142,7 +104,7 @@ serialize(lua_State *L, int idx, struct serialized **serializedp)
 		serdebuf_destroy(&sb);
 		return (ENOMEM);
 	}
-	if ((serialized->pointer = serdebuf_finalize(&sb, NULL)) == NULL) {
+	if ((serialized->pointer = serdebuf_finalize(&sb, sizep)) == NULL) {
 		serdebuf_destroy(&sb);
 		free(serialized);
 		return (ENOMEM);
@@ -162,9 +124,19 @@ freeserialized(void *p)
 
 struct rcshared {
 	struct serialized *serialized;
-	refcount refs;
+#ifdef STATS
+	struct shared_stats stats CK_CC_CACHELINE;
+#endif
+	refcount refs CK_CC_CACHELINE;
 };
 
+#define SHARED_STATS_ADD(sharedp, NAME, n) do { \
+	STATS_ADD(&(sharedp)->stats, NAME, n); \
+	STATS_TOTAL_ADD(shared, NAME, n); \
+} while (0)
+#define SHARED_STATS_INC(sharedp, NAME) \
+	SHARED_STATS_ADD(sharedp, NAME, 1)
+
 static inline int
 newshared(lua_State *L, const char *metatable)
 {
@@ -173,16 +145,17 @@ newshared(lua_State *L, const char *metatable)
 
 	luaL_checkany(L, 1);
 
-	if ((sharedp = malloc(sizeof(*sharedp))) == NULL) {
+	if ((sharedp = refcount_alloc(sizeof(*sharedp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
-	if ((error = serialize(L, 1, &sharedp->serialized)) != 0) {
+	if ((error = serialize(L, 1, &sharedp->serialized, NULL)) != 0) {
 		free(sharedp);
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serialize", error));
 	}
+	STATS_INIT(&sharedp->stats);
 	refcount_init(&sharedp->refs);
 	return (new(L, sharedp, metatable));
 }
@@ -198,6 +171,16 @@ retainshared(lua_State *L, const char *metatable)
 	return (new(L, sharedp, metatable));
 }
 
+static inline int
+sharedstats(lua_State *L, const char *metatable)
+{
+	struct rcshared *sharedp __unused;
+
+	sharedp = checkcookie(L, 1, metatable);
+
+	return (STATS_PUSH(SHARED_STATS_LIST, &sharedp->stats));
+}
+
 static int
 l_ck_shared_const_new(lua_State *L)
 {
@@ -238,15 +221,26 @@ static int
 l_ck_shared_const_load(lua_State *L)
 {
 	struct rcshared *sharedp;
+	const void *p, *end;
 
 	sharedp = checkcookie(L, 1, SHARED_CONST_METATABLE);
 
-	if (loadshared(L, sharedp->serialized->pointer) == NULL) {
+	SHARED_STATS_INC(sharedp, loads);
+	p = sharedp->serialized->pointer;
+	end = loadshared(L, p);
+	CK_SHARED_LOAD(sharedp, probe_size(p, end), probe_type(p), end != NULL);
+	if (end == NULL) {
 		return (lua_error(L));
 	}
 	return (1);
 }
 
+static int
+l_ck_shared_const_stats(lua_State *L)
+{
+	return (sharedstats(L, SHARED_CONST_METATABLE));
+}
+
 static int
 l_ck_shared_mut_new(lua_State *L)
 {
@@ -274,7 +268,7 @@ l_ck_shared_mut_gc(lua_State *L)
 			serialized = ck_pr_load_ptr(&sharedp->serialized);
 			ck_hp_set(record, 0, serialized);
 		} while (ck_pr_load_ptr(&sharedp->serialized) != serialized);
-		ck_hp_free(record, &serialized->hazard, serialized, serialized);
+		hp_free(record, &serialized->hazard, serialized, serialized);
 		ck_hp_set(record, 0, NULL);
 		free(sharedp);
 	}
@@ -296,16 +290,30 @@ l_ck_shared_mut_load(lua_State *L)
 	struct rcshared *sharedp;
 	ck_hp_record_t *record;
 	struct serialized *serialized;
+	const void *end;
+	unsigned int retries;
 	bool error;
 
 	sharedp = checkcookie(L, 1, SHARED_MUT_METATABLE);
 
 	record = gethprecord(L, &serialized_hp_domain);
-	do {
+	retries = 0;
+	for (;;) {
 		serialized = ck_pr_load_ptr(&sharedp->serialized);
 		ck_hp_set(record, 0, serialized);
-	} while (ck_pr_load_ptr(&sharedp->serialized) != serialized);
-	error = loadshared(L, serialized->pointer) == NULL;
+		if (ck_pr_load_ptr(&sharedp->serialized) == serialized) {
+			break;
+		}
+		retries++;
+	}
+	SHARED_STATS_INC(sharedp, loads);
+	if (retries != 0) {
+		SHARED_STATS_ADD(sharedp, load_retries, retries);
+	}
+	end = loadshared(L, serialized->pointer);
+	error = end == NULL;
+	CK_SHARED_LOAD(sharedp, probe_size(serialized->pointer, end),
+	    probe_type(serialized->pointer), !error);
 	ck_hp_set(record, 0, NULL);
 	if (error) {
 		return (lua_error(L));
@@ -330,57 +338,142 @@ l_ck_shared_mut_store(lua_State *L)
 	struct rcshared *sharedp;
 	ck_hp_record_t *record;
 	struct serialized *oldp, *newp;
+	size_t size;
 	int error;
 
 	sharedp = checkcookie(L, 1, SHARED_MUT_METATABLE);
 	luaL_checkany(L, 2);
 
-	if ((error = serialize(L, 2, &newp)) != 0) {
+	if ((error = serialize(L, 2, &newp, &size)) != 0) {
 		if (error < 0) {
 			return (lua_error(L));
 		}
 		return (fatal(L, "serialize", error));
 	}
+	/* Once stored, newp may be freed by another store. */
+	CK_SHARED_STORE(sharedp, size, probe_type(newp->pointer));
 	oldp = ck_pr_fas_ptr(&sharedp->serialized, newp);
+	SHARED_STATS_INC(sharedp, stores);
 	record = gethprecord(L, &serialized_hp_domain);
 	/* TODO: retire vs free? */
-	ck_hp_free(record, &oldp->hazard, oldp, oldp);
+	hp_free(record, &oldp->hazard, oldp, oldp);
 	return (0);
 }
 
+static int
+l_ck_shared_mut_stats(lua_State *L)
+{
+	return (sharedstats(L, SHARED_MUT_METATABLE));
+}
+
 _Static_assert(sizeof(uint8_t) == sizeof(bool), "bad bool size");
 _Static_assert(sizeof(uint64_t) == sizeof(lua_Integer), "bad lua_Integer size");
 _Static_assert(sizeof(double) == sizeof(lua_Number), "bad lua_Number size");
 
+static inline void
+lua_pushchar(lua_State *L, char c)
+{
+	lua_pushlstring(L, &c, 1);
+}
+
+static inline char
+lua_tochar(lua_State *L, int idx)
+{
+	const char *s;
+	size_t len;
+
+	s = lua_tolstring(L, idx, &len);
+	return (len > 0 ? s[0] : '\0');
+}
+
 /*
+ * Integers stored in narrower types are range checked rather than truncated.
+ */
+#define LUA_TO_RANGE(NAME, CT, MIN, MAX) \
+static inline CT \
+lua_to##NAME(lua_State *L, int idx) \
+{ \
+	lua_Integer i; \
+\
+	i = luaL_checkinteger(L, idx); \
+	luaL_argcheck(L, i >= (MIN) && i <= (MAX), idx, \
+	    "out of range for " #NAME); \
+	return ((CT)i); \
+}
+LUA_TO_RANGE(u8, uint8_t, 0, UINT8_MAX)
+LUA_TO_RANGE(u16, uint16_t, 0, UINT16_MAX)
+LUA_TO_RANGE(u32, uint32_t, 0, UINT32_MAX)
+LUA_TO_RANGE(short, short, SHRT_MIN, SHRT_MAX)
+LUA_TO_RANGE(int, int, INT_MIN, INT_MAX)
+LUA_TO_RANGE(uint, unsigned int, 0, UINT_MAX)
+#undef LUA_TO_RANGE
+
+/*
+ * The first four types are inferred from Lua values, the rest must be asked for
+ * by name.
+ *
  *            ST
- *        FT      PUSH/FIELD     TO        ...
+ *        FT      FIELD          lua_push*      lua_to*   ...
  */
 #define SERDE_BOOLEAN_T(X, ...) \
-	X(8,      boolean,       boolean,  __VA_ARGS__)
+	X(8,      boolean,       boolean,       boolean,  __VA_ARGS__)
 #define SERDE_LIGHTUSERDATA_T(X, ...) \
-	X(PTR,    lightuserdata, userdata, __VA_ARGS__)
+	X(PTR,    lightuserdata, lightuserdata, userdata, __VA_ARGS__)
 #define SERDE_INTEGER_T(X, ...) \
-	X(64,     integer,       integer,  __VA_ARGS__)
+	X(64,     integer,       integer,       integer,  __VA_ARGS__)
 #define SERDE_NUMBER_T(X, ...) \
-	X(DOUBLE, number,        number,   __VA_ARGS__)
+	X(DOUBLE, number,        number,        number,   __VA_ARGS__)
+#define SERDE_U8_T(X, ...) \
+	X(8,      u8,            integer,       u8,       __VA_ARGS__)
+#define SERDE_U16_T(X, ...) \
+	X(16,     u16,           integer,       u16,      __VA_ARGS__)
+#define SERDE_U32_T(X, ...) \
+	X(32,     u32,           integer,       u32,      __VA_ARGS__)
+#define SERDE_CHAR_T(X, ...) \
+	X(CHAR,   c,             char,          char,     __VA_ARGS__)
+#define SERDE_SHORT_T(X, ...) \
+	X(SHORT,  s,             integer,       short,    __VA_ARGS__)
+#define SERDE_INT_T(X, ...) \
+	X(INT,    i,             integer,       int,      __VA_ARGS__)
+#define SERDE_UINT_T(X, ...) \
+	X(UINT,   u,             integer,       uint,     __VA_ARGS__)
 
 /*        ST             ... */
 #define SERDE_F_TYPES_LIST(X, ...) \
 	X(BOOLEAN,       __VA_ARGS__) \
 	X(LIGHTUSERDATA, __VA_ARGS__) \
 	X(INTEGER,       __VA_ARGS__) \
-	X(NUMBER,        __VA_ARGS__)
+	X(NUMBER,        __VA_ARGS__) \
+	X(U8,            __VA_ARGS__) \
+	X(U16,           __VA_ARGS__) \
+	X(U32,           __VA_ARGS__) \
+	X(CHAR,          __VA_ARGS__) \
+	X(SHORT,         __VA_ARGS__) \
+	X(INT,           __VA_ARGS__) \
+	X(UINT,          __VA_ARGS__)
 #define SERDE_F_BITWISE_TYPES_LIST(X, ...) \
 	X(BOOLEAN,       __VA_ARGS__) \
 	X(LIGHTUSERDATA, __VA_ARGS__) \
-	X(INTEGER,       __VA_ARGS__)
+	X(INTEGER,       __VA_ARGS__) \
+	X(U8,            __VA_ARGS__) \
+	X(U16,           __VA_ARGS__) \
+	X(U32,           __VA_ARGS__) \
+	X(CHAR,          __VA_ARGS__) \
+	X(SHORT,         __VA_ARGS__) \
+	X(INT,           __VA_ARGS__) \
+	X(UINT,          __VA_ARGS__)
 #define SERDE_F_BITRMW_TYPES_LIST(X, ...) \
 	X(LIGHTUSERDATA, __VA_ARGS__) \
-	X(INTEGER,       __VA_ARGS__)
+	X(INTEGER,       __VA_ARGS__) \
+	X(U8,            __VA_ARGS__) \
+	X(U16,           __VA_ARGS__) \
+	X(U32,           __VA_ARGS__) \
+	X(SHORT,         __VA_ARGS__) \
+	X(INT,           __VA_ARGS__) \
+	X(UINT,          __VA_ARGS__)
 
-#define SERDE_PR_T_EXPANDER(FT, PUSH, TO, X, ...) \
-	PR_##FT##_T(X, FT, PUSH, TO, __VA_ARGS__)
+#define SERDE_PR_T_EXPANDER(FT, FIELD, PUSH, TO, X, ...) \
+	PR_##FT##_T(X, FT, FIELD, PUSH, TO, __VA_ARGS__)
 
 #define SERDE_T_EXPANDER(ST, X, ...) \
 	SERDE_##ST##_T(SERDE_PR_T_EXPANDER, X, ST, __VA_ARGS__)
@@ -388,38 +481,95 @@ _Static_assert(sizeof(double) == sizeof(lua_Number), "bad lua_Number size");
 #define SERDE_PR_TYPES_LIST(X, ...) \
 	SERDE_F_TYPES_LIST(SERDE_T_EXPANDER, X, __VA_ARGS__)
 
+enum shared_pr_type {
+#define SHARED_PR_TYPE(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, ...) \
+	SHARED_PR_##ST,
+	SERDE_PR_TYPES_LIST(SHARED_PR_TYPE)
+#undef SHARED_PR_TYPE
+};
+
+/* Names accepted for explicit types, with the md128 view names for aliases. */
+static const char *shared_pr_type_names[] = {
+	"boolean", "lightuserdata", "integer", "number",
+	"u8", "u16", "u32", "c", "s", "i", "u",
+	"u64", "p", "d",
+	NULL
+};
+
+static const enum shared_pr_type shared_pr_types[] = {
+	SHARED_PR_BOOLEAN, SHARED_PR_LIGHTUSERDATA, SHARED_PR_INTEGER,
+	SHARED_PR_NUMBER,
+	SHARED_PR_U8, SHARED_PR_U16, SHARED_PR_U32, SHARED_PR_CHAR,
+	SHARED_PR_SHORT, SHARED_PR_INT, SHARED_PR_UINT,
+	SHARED_PR_INTEGER, SHARED_PR_LIGHTUSERDATA, SHARED_PR_NUMBER,
+};
+
 struct rcsharedpr {
 	union {
-#define SERDE_PR_FIELD(CKT, CT, DT, FT, NAME, ...) \
-		CT NAME;
+#define SERDE_PR_FIELD(CKT, CT, DT, FT, FIELD, ...) \
+		CT FIELD;
 		SERDE_PR_TYPES_LIST(SERDE_PR_FIELD)
 #undef SERDE_PR_FIELD
 	};
-	enum serde_type type;
-	refcount refs;
+	enum shared_pr_type type;
+	refcount refs CK_CC_CACHELINE;
 };
 
+/*
+ * The type of a value is inferred from the initial value unless it is named.
+ * Values of named types are converted (and range checked) as if stored.
+ */
 static int
 l_ck_shared_pr_new(lua_State *L)
 {
 	struct rcsharedpr *sharedp;
+	enum shared_pr_type type;
+	union {
+#define SERDE_PR_FIELD(CKT, CT, DT, FT, FIELD, ...) \
+		CT FIELD;
+		SERDE_PR_TYPES_LIST(SERDE_PR_FIELD)
+#undef SERDE_PR_FIELD
+	} value;
 
 	luaL_checkany(L, 1);
 
-	if ((sharedp = malloc(sizeof(*sharedp))) == NULL) {
+	if (lua_isnoneornil(L, 2)) {
+		switch (serde_type(L, 1)) {
+		case SERDE_BOOLEAN: type = SHARED_PR_BOOLEAN; break;
+		case SERDE_LIGHTUSERDATA: type = SHARED_PR_LIGHTUSERDATA; break;
+		case SERDE_INTEGER: type = SHARED_PR_INTEGER; break;
+		case SERDE_NUMBER: type = SHARED_PR_NUMBER; break;
+		default:
+			return (luaL_typeerror(L, 1,
+			    "boolean, lightuserdata, integer, or number"));
+		}
+	} else {
+		type = shared_pr_types[luaL_checkoption(L, 2, NULL,
+		    shared_pr_type_names)];
+	}
+	/* Convert first, as a value out of range raises an error. */
+	switch (type) {
+#define SERDE_PR_NEW_CONVERT(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: \
+		value.FIELD = lua_to##TO(L, 1); \
+		break;
+	SERDE_PR_TYPES_LIST(SERDE_PR_NEW_CONVERT)
+#undef SERDE_PR_NEW_CONVERT
+	default:
+		__unreachable();
+	}
+	if ((sharedp = refcount_alloc(sizeof(*sharedp))) == NULL) {
 		return (fatal(L, "malloc", ENOMEM));
 	}
-	switch ((sharedp->type = serde_type(L, 1))) {
-#define SERDE_PR_NEW_IMPL(CKT, CT, DT, FT, FIELD, TO, ST, ...) \
-	case SERDE_##ST: \
-		sharedp->FIELD = lua_to##TO(L, 1); \
+	switch ((sharedp->type = type)) {
+#define SERDE_PR_NEW_IMPL(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: \
+		sharedp->FIELD = value.FIELD; \
 		break;
 	SERDE_PR_TYPES_LIST(SERDE_PR_NEW_IMPL)
 #undef SERDE_PR_NEW_IMPL
 	default:
-		free(sharedp);
-		return (luaL_typeerror(L, 1,
-		    "boolean, lightuserdata, integer, or number"));
+		__unreachable();
 	}
 	refcount_init(&sharedp->refs);
 	return (new(L, sharedp, SHARED_PR_METATABLE));
@@ -574,13 +724,19 @@ static int l_ck_shared_pr_rfo(lua_State *L)
 	lua_pushboolean(L, PR(p, lua_tointeger(L, idx))); 1; \
 })
 
-#define SERDE_PR_OP_CASE(CKT, CT, DT, FT, PUSH, TO, ST, OP, VARIANT, CLASS, ...) \
-	case SERDE_##ST: { \
-		CT *p = &sharedp->PUSH; \
+#define SERDE_PR_OP_CASE_IMPL(F, FV, OP, VARIANT, CLASS, CKT, CT, DT, FT, \
+    FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: { \
+		CT *p = &sharedp->FIELD; \
 		return (SERDE_PR_##CLASS##_IMPL(2, CK_PR(OP, CKT, VARIANT), \
 		    lua_push##PUSH, lua_to##TO, CT, DT)); \
 	}
 
+/* Types the machine has no such operation for fall through to the default. */
+#define SERDE_PR_OP_CASE(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, F, FV, ...) \
+	PR_OP_##F##FV##_##FT(SERDE_PR_OP_CASE_IMPL, CKT, CT, DT, FT, FIELD, \
+	    PUSH, TO, ST)
+
 #define SERDE_PR_OP(F, FV, OP, VARIANT, CLASS, ...) \
 static int \
 l_ck_shared_pr_##OP##VARIANT(lua_State *L) \
@@ -591,30 +747,15 @@ l_ck_shared_pr_##OP##VARIANT(lua_State *L) \
 	SERDE_PR_##CLASS##_CHECKS(2); \
 \
 	switch (sharedp->type) { \
-	SERDE_PR_##CLASS##_LIST(SERDE_PR_OP_CASE, OP, VARIANT, CLASS) \
+	SERDE_PR_##CLASS##_LIST(SERDE_PR_OP_CASE, F, FV) \
 	default: \
-		return (luaL_error(L, "internal error")); \
+		return (luaL_error(L, \
+		    #OP #VARIANT " not supported for this type")); \
 	} \
 }
 
 PR_OPS_LIST(SERDE_PR_OP);
 
-static inline void
-lua_pushchar(lua_State *L, char c)
-{
-	lua_pushlstring(L, &c, 1);
-}
-
-static inline char
-lua_tochar(lua_State *L, int idx)
-{
-	const char *s;
-	size_t len;
-
-	s = lua_tolstring(L, idx, &len);
-	return (len > 0 ? s[0] : '\0');
-}
-
 /*                  FT             X NAME lua_push*      lua_to*  ... */
 #define SERDE_PR128_8(X, ...)      X(u8,  integer,       integer,  __VA_ARGS__)
 #define SERDE_PR128_16(X, ...)     X(u16, integer,       integer,  __VA_ARGS__)
@@ -639,11 +780,9 @@ struct rcsharedpr128 {
 		SERDE_PR128_TYPES_LIST(SERDE_PR128_FIELD)
 #undef SERDE_PR128_FIELD
 	};
-	refcount refs;
+	refcount refs CK_CC_CACHELINE;
 };
 
-#define MD128_ALIGN sizeof(uint64_t[2])
-
 static int
 l_ck_shared_pr_md128_new(lua_State *L)
 {
@@ -709,8 +848,8 @@ l_ck_shared_pr_md128_new(lua_State *L)
 		return (luaL_typeerror(L, 1, "table or string or nil or none"));
 	}
 
-	if ((sharedp = aligned_alloc(MD128_ALIGN, sizeof(*sharedp))) == NULL) {
-		return (fatal(L, "aligned_alloc", ENOMEM));
+	if ((sharedp = refcount_alloc(sizeof(*sharedp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
 	}
 	if (s != NULL) {
 		assert(len <= sizeof(sharedp->c));
@@ -833,6 +972,38 @@ l_ck_shared_pr_md128_rfo(lua_State *L)
 	return (0);
 }
 
+/*
+ * The view table holds a reference to the value, so the value outlives any
+ * call on the view.
+ */
+static inline struct rcsharedpr128 *
+checkview(lua_State *L, int idx)
+{
+	struct rcsharedpr128 *sharedp;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	lua_rawgeti(L, idx, MD128_VALUE);
+	sharedp = checkcookie(L, -1, SHARED_PR128_METATABLE);
+	lua_pop(L, 1);
+	return (sharedp);
+}
+
+/*
+ * Copy the value for bulk operations on a view.  Each half is loaded
+ * atomically, but not both at once, so this works whether or not the machine
+ * has 128-bit loads.  The operations then run on the copy, in loops over at
+ * most 16 components the compiler readily vectorizes.
+ */
+static inline void
+md128_snapshot(struct rcsharedpr128 *sharedp, void *value)
+{
+	uint64_t u64[2];
+
+	u64[0] = ck_pr_load_64(&sharedp->u64[0]);
+	u64[1] = ck_pr_load_64(&sharedp->u64[1]);
+	memcpy(value, u64, sizeof(u64));
+}
+
 #define SERDE_PR128_TERNARY_CAS_CHECKS(idx, N) ({ \
 	luaL_checktype(L, idx, LUA_TTABLE); \
 	luaL_argcheck(L, luaL_len(L, idx) == N, idx, "bad length"); \
@@ -879,11 +1050,20 @@ l_ck_shared_pr_md128_rfo(lua_State *L)
 #define ck_pr_md_load_64_2 ck_pr_load_64_2
 #define ck_pr_md_load_ptr_2 ck_pr_load_ptr_2
 
-#define SERDE_PR128_UNARY_LOAD_CHECKS(idx, N) ({})
+/* The values are stored into the table given, if any, to avoid allocation. */
+#define SERDE_PR128_UNARY_LOAD_CHECKS(idx, N) ({ \
+	if (!lua_isnoneornil(L, idx)) { \
+		luaL_checktype(L, idx, LUA_TTABLE); \
+	} \
+})
 #define SERDE_PR128_UNARY_LOAD_IMPL(idx, PUSH, TO, CKT, CT, DT, N) ({ \
 	CT value[N]; \
 	ck_pr_md_load_##CKT##_##N(p, value); \
-	lua_createtable(L, N, 0); \
+	if (lua_istable(L, idx)) { \
+		lua_pushvalue(L, idx); \
+	} else { \
+		lua_createtable(L, N, 0); \
+	} \
 	for (int i = 0; i < N; i++) { \
 		PUSH(L, value[i]); \
 		lua_rawseti(L, -2, i + 1); \
@@ -898,9 +1078,7 @@ l_ck_shared_pr_md128_##NAME##_##OP##VARIANT(lua_State *L) \
 	struct rcsharedpr128 *sharedp; \
 	CT *p; \
 \
-	luaL_checktype(L, 1, LUA_TTABLE); \
-	lua_rawgeti(L, 1, MD128_VALUE); \
-	sharedp = checkcookie(L, -1, SHARED_PR128_METATABLE); \
+	sharedp = checkview(L, 1); \
 	SERDE_PR128_##CLASS##_CHECKS(2, N); \
 \
 	p = sharedp->NAME; \
@@ -974,11 +1152,603 @@ PR_##FT##_OPS_LIST(SERDE_PR128_VIEW_I_OP, NAME, PUSH, TO, CKT, CT, DT, FT, \
 
 SERDE_PR128_TYPES_LIST(SERDE_PR128_VIEW)
 
-static const struct luaL_Reg l_ck_hp_record_meta[] = {
-	{"__gc", l_ck_hp_record_gc},
-	{NULL, NULL}
+/*
+ * Bulk operations on views
+ *
+ * Views of numbers also have sum, min, and max, with sums of integers wrapping
+ * around as Lua integers do.
+ *
+ *                          FT     X  accumulator ...
+ */
+#define SERDE_PR128_ARITH_8(X, ...)      X(lua_Unsigned, __VA_ARGS__)
+#define SERDE_PR128_ARITH_16(X, ...)     X(lua_Unsigned, __VA_ARGS__)
+#define SERDE_PR128_ARITH_32(X, ...)     X(lua_Unsigned, __VA_ARGS__)
+#define SERDE_PR128_ARITH_64(X, ...)     X(lua_Unsigned, __VA_ARGS__)
+#define SERDE_PR128_ARITH_CHAR(X, ...)
+#define SERDE_PR128_ARITH_DOUBLE(X, ...) X(lua_Number,   __VA_ARGS__)
+#define SERDE_PR128_ARITH_INT(X, ...)    X(lua_Unsigned, __VA_ARGS__)
+#define SERDE_PR128_ARITH_PTR(X, ...)
+#define SERDE_PR128_ARITH_UINT(X, ...)   X(lua_Unsigned, __VA_ARGS__)
+
+#define SERDE_PR128_VIEW_ARITH(AT, NAME, PUSH, TO, CKT, CT, DT, FT, N, ...) \
+static int \
+l_ck_shared_pr_md128_##NAME##_sum(lua_State *L) \
+{ \
+	struct rcsharedpr128 *sharedp; \
+	CT value[N]; \
+	AT sum; \
+\
+	sharedp = checkview(L, 1); \
+\
+	md128_snapshot(sharedp, value); \
+	sum = 0; \
+	for (int i = 0; i < N; i++) { \
+		sum += value[i]; \
+	} \
+	lua_push##PUSH(L, sum); \
+	return (1); \
+} \
+\
+static int \
+l_ck_shared_pr_md128_##NAME##_min(lua_State *L) \
+{ \
+	struct rcsharedpr128 *sharedp; \
+	CT value[N]; \
+	CT min; \
+\
+	sharedp = checkview(L, 1); \
+\
+	md128_snapshot(sharedp, value); \
+	min = value[0]; \
+	for (int i = 1; i < N; i++) { \
+		min = value[i] < min ? value[i] : min; \
+	} \
+	lua_push##PUSH(L, min); \
+	return (1); \
+} \
+\
+static int \
+l_ck_shared_pr_md128_##NAME##_max(lua_State *L) \
+{ \
+	struct rcsharedpr128 *sharedp; \
+	CT value[N]; \
+	CT max; \
+\
+	sharedp = checkview(L, 1); \
+\
+	md128_snapshot(sharedp, value); \
+	max = value[0]; \
+	for (int i = 1; i < N; i++) { \
+		max = value[i] > max ? value[i] : max; \
+	} \
+	lua_push##PUSH(L, max); \
+	return (1); \
+}
+
+/*
+ * Convert the value at idx for comparison with the components of a view,
+ * checking its type but not raising an error for values out of range.  Instead
+ * the result is false if no component could be equal to the value.  A char
+ * component is compared with the first character of a string, as stored.
+ */
+#define SERDE_PR128_MATCH_INTEGER(idx, CT, xp) ({ \
+	lua_Integer i_ = luaL_checkinteger(L, idx); \
+	*(xp) = (CT)i_; \
+	(lua_Integer)*(xp) == i_; \
+})
+#define SERDE_PR128_MATCH_8      SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_16     SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_32     SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_64     SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_INT    SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_UINT   SERDE_PR128_MATCH_INTEGER
+#define SERDE_PR128_MATCH_DOUBLE(idx, CT, xp) ({ \
+	*(xp) = luaL_checknumber(L, idx); \
+	true; \
+})
+#define SERDE_PR128_MATCH_CHAR(idx, CT, xp) ({ \
+	size_t len_; \
+	const char *s_ = luaL_checklstring(L, idx, &len_); \
+	*(xp) = len_ > 0 ? s_[0] : '\0'; \
+	len_ <= 1; \
+})
+#define SERDE_PR128_MATCH_PTR(idx, CT, xp) ({ \
+	luaL_checktype(L, idx, LUA_TLIGHTUSERDATA); \
+	*(xp) = lua_touserdata(L, idx); \
+	true; \
+})
+
+/*
+ * All views have mask, for a bit mask of the components equal to a value, and
+ * find, for the index of the first such component.
+ */
+#define SERDE_PR128_VIEW_BULK(NAME, PUSH, TO, CKT, CT, DT, FT, N, ...) \
+SERDE_PR128_ARITH_##FT(SERDE_PR128_VIEW_ARITH, NAME, PUSH, TO, CKT, CT, DT, \
+    FT, N) \
+\
+static int \
+l_ck_shared_pr_md128_##NAME##_mask(lua_State *L) \
+{ \
+	struct rcsharedpr128 *sharedp; \
+	CT value[N]; \
+	CT x; \
+	lua_Integer mask; \
+\
+	sharedp = checkview(L, 1); \
+	if (!SERDE_PR128_MATCH_##FT(2, CT, &x)) { \
+		lua_pushinteger(L, 0); \
+		return (1); \
+	} \
+\
+	md128_snapshot(sharedp, value); \
+	mask = 0; \
+	for (int i = 0; i < N; i++) { \
+		mask |= (lua_Integer)(value[i] == x) << i; \
+	} \
+	lua_pushinteger(L, mask); \
+	return (1); \
+} \
+\
+static int \
+l_ck_shared_pr_md128_##NAME##_find(lua_State *L) \
+{ \
+	struct rcsharedpr128 *sharedp; \
+	CT value[N]; \
+	CT x; \
+	lua_Integer init; \
+\
+	sharedp = checkview(L, 1); \
+	init = luaL_optinteger(L, 3, 1); \
+	luaL_argcheck(L, init > 0 && init <= N + 1, 3, \
+	    "initial index out of bounds"); \
+	if (!SERDE_PR128_MATCH_##FT(2, CT, &x)) { \
+		luaL_pushfail(L); \
+		return (1); \
+	} \
+\
+	md128_snapshot(sharedp, value); \
+	for (int i = init - 1; i < N; i++) { \
+		if (value[i] == x) { \
+			lua_pushinteger(L, i + 1); \
+			return (1); \
+		} \
+	} \
+	luaL_pushfail(L); \
+	return (1); \
+}
+
+SERDE_PR128_TYPES_LIST(SERDE_PR128_VIEW_BULK)
+
+/*
+ * Arrays of atomic values share one allocation and one reference count.  The
+ * count is alone on the cache line after the header, so retaining and
+ * releasing references disturbs neither the header nor the values.  Padded
+ * arrays further give each value a cache line of its own, so threads updating
+ * neighboring values do not contend for the same line.
+ */
+struct rcsharedprarray {
+	enum shared_pr_type type;
+	size_t n;
+	size_t stride;
+	refcount refs CK_CC_CACHELINE;
+	char values[] CK_CC_ALIGN(CK_MD_CACHELINE);
 };
 
+static inline void *
+shared_pr_array_slot(struct rcsharedprarray *arrayp, size_t i)
+{
+	return (arrayp->values + i * arrayp->stride);
+}
+
+static inline void *
+checkslot(lua_State *L, struct rcsharedprarray *arrayp, int idx)
+{
+	lua_Integer i;
+
+	i = luaL_checkinteger(L, idx);
+	luaL_argcheck(L, i > 0 && (lua_Unsigned)i <= arrayp->n, idx,
+	    "index out of bounds");
+	return (shared_pr_array_slot(arrayp, i - 1));
+}
+
+static int
+l_ck_shared_pr_array_new(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+	enum shared_pr_type type;
+	lua_Integer n;
+	size_t size, stride;
+	bool padded;
+
+	n = luaL_checkinteger(L, 1);
+	type = shared_pr_types[luaL_checkoption(L, 2, "integer",
+	    shared_pr_type_names)];
+	if (lua_isnoneornil(L, 3)) {
+		padded = false;
+	} else {
+		luaL_checktype(L, 3, LUA_TTABLE);
+		lua_getfield(L, 3, "padded");
+		padded = lua_toboolean(L, -1);
+		lua_pop(L, 1);
+	}
+
+	switch (type) {
+#define SHARED_PR_ARRAY_SIZE(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: \
+		stride = sizeof(CT); \
+		break;
+	SERDE_PR_TYPES_LIST(SHARED_PR_ARRAY_SIZE)
+#undef SHARED_PR_ARRAY_SIZE
+	default:
+		__unreachable();
+	}
+	if (padded) {
+		stride = CK_MD_CACHELINE;
+	}
+	luaL_argcheck(L, n > 0 &&
+	    (lua_Unsigned)n <= (SIZE_MAX - sizeof(*arrayp) - CK_MD_CACHELINE) /
+	    stride, 1, "bad number of values");
+	size = roundup2(sizeof(*arrayp) + n * stride, CK_MD_CACHELINE);
+	if ((arrayp = refcount_alloc(size)) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	/* All zero bits is false, NULL, 0, or 0.0. */
+	memset(arrayp->values, 0, n * stride);
+	arrayp->type = type;
+	arrayp->n = n;
+	arrayp->stride = stride;
+	refcount_init(&arrayp->refs);
+	return (new(L, arrayp, SHARED_PR_ARRAY_METATABLE));
+}
+
+static int
+l_ck_shared_pr_array_retain(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+
+	arrayp = checklightuserdata(L, 1);
+
+	refcount_retain(&arrayp->refs);
+	return (new(L, arrayp, SHARED_PR_ARRAY_METATABLE));
+}
+
+static int
+l_ck_shared_pr_array_call(lua_State *L)
+{
+	/* Called as ck.shared.pr.array(...), drop the module table. */
+	lua_remove(L, 1);
+	return (l_ck_shared_pr_array_new(L));
+}
+
+static int
+l_ck_shared_pr_array_gc(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+
+	arrayp = checkcookie(L, 1, SHARED_PR_ARRAY_METATABLE);
+
+	if (refcount_release(&arrayp->refs)) {
+		free(arrayp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_shared_pr_array_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SHARED_PR_ARRAY_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_shared_pr_array_rfo(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+	void *slot;
+
+	arrayp = checkcookie(L, 1, SHARED_PR_ARRAY_METATABLE);
+	slot = checkslot(L, arrayp, 2);
+
+	ck_pr_rfo(slot);
+	return (0);
+}
+
+static int
+l_ck_shared_pr_array_len(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+
+	arrayp = checkcookie(L, 1, SHARED_PR_ARRAY_METATABLE);
+
+	lua_pushinteger(L, arrayp->n);
+	return (1);
+}
+
+/*
+ * Load every value into a new table.  Each value is loaded atomically, but not
+ * all of them at once.
+ */
+static int
+l_ck_shared_pr_array_snapshot(lua_State *L)
+{
+	struct rcsharedprarray *arrayp;
+
+	arrayp = checkcookie(L, 1, SHARED_PR_ARRAY_METATABLE);
+
+	lua_createtable(L, arrayp->n, 0);
+	switch (arrayp->type) {
+#define SHARED_PR_ARRAY_SNAPSHOT(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: \
+		for (size_t i = 0; i < arrayp->n; i++) { \
+			CT *p = shared_pr_array_slot(arrayp, i); \
+\
+			lua_push##PUSH(L, ck_pr_load_##CKT(p)); \
+			lua_rawseti(L, -2, i + 1); \
+		} \
+		break;
+	SERDE_PR_TYPES_LIST(SHARED_PR_ARRAY_SNAPSHOT)
+#undef SHARED_PR_ARRAY_SNAPSHOT
+	default:
+		return (luaL_error(L, "internal error"));
+	}
+	return (1);
+}
+
+#define SHARED_PR_ARRAY_OP_CASE_IMPL(F, FV, OP, VARIANT, CLASS, CKT, CT, DT, \
+    FT, FIELD, PUSH, TO, ST, ...) \
+	case SHARED_PR_##ST: { \
+		CT *p = slot; \
+		return (SERDE_PR_##CLASS##_IMPL(3, CK_PR(OP, CKT, VARIANT), \
+		    lua_push##PUSH, lua_to##TO, CT, DT)); \
+	}
+
+#define SHARED_PR_ARRAY_OP_CASE(CKT, CT, DT, FT, FIELD, PUSH, TO, ST, F, FV, \
+    ...) \
+	PR_OP_##F##FV##_##FT(SHARED_PR_ARRAY_OP_CASE_IMPL, CKT, CT, DT, FT, \
+	    FIELD, PUSH, TO, ST)
+
+#define SHARED_PR_ARRAY_OP(F, FV, OP, VARIANT, CLASS, ...) \
+static int \
+l_ck_shared_pr_array_##OP##VARIANT(lua_State *L) \
+{ \
+	struct rcsharedprarray *arrayp; \
+	void *slot; \
+\
+	arrayp = checkcookie(L, 1, SHARED_PR_ARRAY_METATABLE); \
+	slot = checkslot(L, arrayp, 2); \
+	SERDE_PR_##CLASS##_CHECKS(3); \
+\
+	switch (arrayp->type) { \
+	SERDE_PR_##CLASS##_LIST(SHARED_PR_ARRAY_OP_CASE, F, FV) \
+	default: \
+		return (luaL_error(L, \
+		    #OP #VARIANT " not supported for this type")); \
+	} \
+}
+
+PR_OPS_LIST(SHARED_PR_ARRAY_OP);
+
+#ifndef SHARED_PR_WIDE_MAX
+#define SHARED_PR_WIDE_MAX CK_MD_PAGESIZE
+#endif
+
+/*
+ * Wide values are too large for the atomic instructions of the machine, so
+ * they are guarded by a sequence lock instead.  Readers are wait-free and retry
+ * if a write was in progress.  Writers are serialized by a spinlock, as
+ * ck_sequence itself supports only one writer at a time.  The bytes are copied
+ * a 64-bit word at a time with atomic loads and stores.
+ */
+struct rcsharedprwide {
+	ck_sequence_t seqlock;
+	ck_spinlock_t writer;
+	size_t nbytes;
+	refcount refs CK_CC_CACHELINE;
+	uint64_t words[] CK_CC_CACHELINE;
+};
+
+#define WIDE_WORD sizeof(uint64_t)
+#define WIDE_NWORDS(nbytes) howmany(nbytes, WIDE_WORD)
+
+static int
+l_ck_shared_pr_wide_new(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+	const char *s;
+	size_t nbytes, size;
+
+	if (lua_type(L, 1) == LUA_TSTRING) {
+		s = lua_tolstring(L, 1, &nbytes);
+	} else {
+		s = NULL;
+		nbytes = luaL_checkinteger(L, 1);
+	}
+	luaL_argcheck(L, nbytes > 0 && nbytes <= SHARED_PR_WIDE_MAX, 1,
+	    "bad number of bytes");
+
+	size = sizeof(*widep) + WIDE_NWORDS(nbytes) * WIDE_WORD;
+	if ((widep = refcount_alloc(size)) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	memset(widep->words, 0, WIDE_NWORDS(nbytes) * WIDE_WORD);
+	if (s != NULL) {
+		memcpy(widep->words, s, nbytes);
+	}
+	widep->nbytes = nbytes;
+	ck_sequence_init(&widep->seqlock);
+	ck_spinlock_init(&widep->writer);
+	refcount_init(&widep->refs);
+	return (new(L, widep, SHARED_PR_WIDE_METATABLE));
+}
+
+static int
+l_ck_shared_pr_wide_call(lua_State *L)
+{
+	/* Called as ck.shared.pr.wide(...), drop the module table. */
+	lua_remove(L, 1);
+	return (l_ck_shared_pr_wide_new(L));
+}
+
+static int
+l_ck_shared_pr_wide_retain(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+
+	widep = checklightuserdata(L, 1);
+
+	refcount_retain(&widep->refs);
+	return (new(L, widep, SHARED_PR_WIDE_METATABLE));
+}
+
+static int
+l_ck_shared_pr_wide_gc(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+
+	widep = checkcookie(L, 1, SHARED_PR_WIDE_METATABLE);
+
+	if (refcount_release(&widep->refs)) {
+		free(widep);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_shared_pr_wide_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SHARED_PR_WIDE_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_shared_pr_wide_len(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+
+	widep = checkcookie(L, 1, SHARED_PR_WIDE_METATABLE);
+
+	lua_pushinteger(L, widep->nbytes);
+	return (1);
+}
+
+/*
+ * Load bytes i through j of the value, as string.sub() would select them, but
+ * all from the same version of the value.
+ */
+static int
+l_ck_shared_pr_wide_load(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+	luaL_Buffer b;
+	char *buf;
+	lua_Integer i, j;
+	size_t first, last, len;
+	unsigned int version;
+
+	widep = checkcookie(L, 1, SHARED_PR_WIDE_METATABLE);
+	i = luaL_optinteger(L, 2, 1);
+	j = luaL_optinteger(L, 3, widep->nbytes);
+	luaL_argcheck(L, i > 0 && i <= widep->nbytes, 2, "out of bounds");
+	luaL_argcheck(L, j > 0 && j <= widep->nbytes, 3, "out of bounds");
+	if (j < i) {
+		lua_pushliteral(L, "");
+		return (1);
+	}
+
+	first = (i - 1) / WIDE_WORD;
+	last = (j - 1) / WIDE_WORD;
+	buf = luaL_buffinitsize(L, &b, (last - first + 1) * WIDE_WORD);
+	do {
+		version = ck_sequence_read_begin(&widep->seqlock);
+		for (size_t k = first; k <= last; k++) {
+			uint64_t word = ck_pr_load_64(&widep->words[k]);
+
+			memcpy(buf + (k - first) * WIDE_WORD, &word, WIDE_WORD);
+		}
+	} while (ck_sequence_read_retry(&widep->seqlock, version));
+	len = j - i + 1;
+	memmove(buf, buf + (i - 1) % WIDE_WORD, len);
+	luaL_pushresultsize(&b, len);
+	return (1);
+}
+
+/*
+ * Store bytes into the value starting at byte offset, merging with the other
+ * bytes of the words at either end.  The writer lock must be held.
+ */
+static void
+widestore(struct rcsharedprwide *widep, const char *s, size_t offset,
+    size_t len)
+{
+	size_t first, last;
+
+	first = offset / WIDE_WORD;
+	last = (offset + len - 1) / WIDE_WORD;
+	ck_sequence_write_begin(&widep->seqlock);
+	for (size_t k = first; k <= last; k++) {
+		size_t start = MAX(offset, k * WIDE_WORD);
+		size_t end = MIN(offset + len, (k + 1) * WIDE_WORD);
+		uint64_t word;
+
+		word = ck_pr_load_64(&widep->words[k]);
+		memcpy((char *)&word + start % WIDE_WORD, s + (start - offset),
+		    end - start);
+		ck_pr_store_64(&widep->words[k], word);
+	}
+	ck_sequence_write_end(&widep->seqlock);
+}
+
+static int
+l_ck_shared_pr_wide_store(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+	const char *s;
+	lua_Integer i;
+	size_t len;
+
+	widep = checkcookie(L, 1, SHARED_PR_WIDE_METATABLE);
+	s = luaL_checklstring(L, 2, &len);
+	i = luaL_optinteger(L, 3, 1);
+	luaL_argcheck(L, i > 0 && i <= widep->nbytes, 3, "out of bounds");
+	luaL_argcheck(L, len <= widep->nbytes - (i - 1), 2, "too long");
+	if (len == 0) {
+		return (0);
+	}
+
+	ck_spinlock_lock(&widep->writer);
+	widestore(widep, s, i - 1, len);
+	ck_spinlock_unlock(&widep->writer);
+	return (0);
+}
+
+static int
+l_ck_shared_pr_wide_cas(lua_State *L)
+{
+	struct rcsharedprwide *widep;
+	const char *expected, *desired;
+	size_t expectedlen, desiredlen;
+	bool equal;
+
+	widep = checkcookie(L, 1, SHARED_PR_WIDE_METATABLE);
+	expected = luaL_checklstring(L, 2, &expectedlen);
+	desired = luaL_checklstring(L, 3, &desiredlen);
+	luaL_argcheck(L, expectedlen == widep->nbytes, 2, "bad length");
+	luaL_argcheck(L, desiredlen == widep->nbytes, 3, "bad length");
+
+	/* Writes are excluded, so the value can be compared in place. */
+	ck_spinlock_lock(&widep->writer);
+	if ((equal = memcmp(widep->words, expected, expectedlen) == 0)) {
+		widestore(widep, desired, 0, desiredlen);
+	}
+	ck_spinlock_unlock(&widep->writer);
+	lua_pushboolean(L, equal);
+	return (1);
+}
+
 static const struct luaL_Reg l_ck_shared_const_funcs[] = {
 	{"new", l_ck_shared_const_new},
 	{"retain", l_ck_shared_const_retain},
@@ -989,6 +1759,7 @@ static const struct luaL_Reg l_ck_shared_const_meta[] = {
 	{"__gc", l_ck_shared_const_gc},
 	{"cookie", l_ck_shared_const_cookie},
 	{"load", l_ck_shared_const_load},
+	{"stats", l_ck_shared_const_stats},
 	{NULL, NULL}
 };
 
@@ -1003,6 +1774,7 @@ static const struct luaL_Reg l_ck_shared_mut_meta[] = {
 	{"cookie", l_ck_shared_mut_cookie},
 	{"load", l_ck_shared_mut_load},
 	{"rfo", l_ck_shared_mut_rfo},
+	{"stats", l_ck_shared_mut_stats},
 	{"store", l_ck_shared_mut_store},
 	{NULL, NULL}
 };
@@ -1024,6 +1796,51 @@ static const struct luaL_Reg l_ck_shared_pr_meta[] = {
 	{NULL, NULL}
 };
 
+static const struct luaL_Reg l_ck_shared_pr_array_funcs[] = {
+	{"new", l_ck_shared_pr_array_new},
+	{"retain", l_ck_shared_pr_array_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_shared_pr_array_funcs_meta[] = {
+	{"__call", l_ck_shared_pr_array_call},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_shared_pr_array_meta[] = {
+	{"__gc", l_ck_shared_pr_array_gc},
+	{"__len", l_ck_shared_pr_array_len},
+	{"cookie", l_ck_shared_pr_array_cookie},
+	{"rfo", l_ck_shared_pr_array_rfo},
+	{"snapshot", l_ck_shared_pr_array_snapshot},
+#define SHARED_PR_ARRAY_OPS_REG(F, FV, OP, VARIANT, CLASS, ...) \
+	{#OP#VARIANT, l_ck_shared_pr_array_##OP##VARIANT},
+	PR_OPS_LIST(SHARED_PR_ARRAY_OPS_REG)
+#undef SHARED_PR_ARRAY_OPS_REG
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_shared_pr_wide_funcs[] = {
+	{"new", l_ck_shared_pr_wide_new},
+	{"retain", l_ck_shared_pr_wide_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_shared_pr_wide_funcs_meta[] = {
+	{"__call", l_ck_shared_pr_wide_call},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_shared_pr_wide_meta[] = {
+	{"__gc", l_ck_shared_pr_wide_gc},
+	{"__len", l_ck_shared_pr_wide_len},
+	{"cookie", l_ck_shared_pr_wide_cookie},
+	{"cas", l_ck_shared_pr_wide_cas},
+	{"load", l_ck_shared_pr_wide_load},
+	{"store", l_ck_shared_pr_wide_store},
+	{NULL, NULL}
+};
+
 static const struct luaL_Reg l_ck_shared_pr_md128_funcs[] = {
 	{"new", l_ck_shared_pr_md128_new},
 	{"retain", l_ck_shared_pr_md128_retain},
@@ -1048,15 +1865,25 @@ static const struct luaL_Reg l_ck_shared_pr_md128_funcs[] = {
  * | __index   | | __index   | | __index   | | __index   | => Components
  * | cas       | | cas       | | cas       | | cas       |
  * | cas_value | | cas_value | | cas_value | | cas_value |
+ * | find      | | find      | | find      | | find      |
  * | load      | | load      | | load      | | load      |
+ * | mask      | | mask      | | mask      | | mask      |
+ * | max       | | max       | | max       | | max       |
+ * | min       | | min       | | min       | | min       |
+ * | sum       | | sum       | | sum       | | sum       |
  * ============= ============= ============= =============
  * _____________ ___________ _____________ _____________ _____________
  * } c         { } d       { } i         { } p         { } u         {
  * | __index   | | __index | | __index   | | __index   | | __index   |
  * | cas       | | cas     | | cas       | | cas       | | cas       |
- * | cas_value | =========== | cas_value | | cas_value | | cas_value |
- * | load      |             | load      | | load      | | load      |
- * =============             ============= ============= =============
+ * | cas_value | | find    | | cas_value | | cas_value | | cas_value |
+ * | find      | | mask    | | find      | | find      | | find      |
+ * | load      | | max     | | load      | | load      | | load      |
+ * | mask      | | min     | | mask      | | mask      | | mask      |
+ * ============= | sum     | | max       | ============= | max       |
+ *               =========== | min       |               | min       |
+ *                           | sum       |               | sum       |
+ *                           =============               =============
  *
  * Typed View Components (self-indexed) {<md128 value>,<integer index>}
  * _______________ _______________ _______________ _______________
@@ -1129,9 +1956,17 @@ static const struct luaL_Reg l_ck_shared_pr_md128_meta[] = {
 #define MD128_VIEW_I_OP(OP, NAME, PUSH, TO, CKT, CT, DT, FT, ...) \
 	PR_OP_##OP##_##FT(MD128_VIEW_I_OP_IMPL, NAME)
 
+#define MD128_VIEW_ARITH(AT, NAME) \
+	{"sum", l_ck_shared_pr_md128_##NAME##_sum}, \
+	{"min", l_ck_shared_pr_md128_##NAME##_min}, \
+	{"max", l_ck_shared_pr_md128_##NAME##_max},
+
 #define MD128_VIEW_META(NAME, PUSH, TO, CKT, CT, DT, FT, ...) \
 static const struct luaL_Reg l_ck_shared_pr_md128_##NAME##_meta[] = { \
 	{"__index", l_ck_shared_pr_md128_##NAME##_index}, \
+	{"mask", l_ck_shared_pr_md128_##NAME##_mask}, \
+	{"find", l_ck_shared_pr_md128_##NAME##_find}, \
+	SERDE_PR128_ARITH_##FT(MD128_VIEW_ARITH, NAME) \
 	PR128_##FT##_OPS_LIST(MD128_VIEW_OP, NAME, PUSH, TO, CKT, CT, DT, FT) \
 	{NULL, NULL} \
 }; \
@@ -1145,11 +1980,7 @@ SERDE_PR128_TYPES_LIST(MD128_VIEW_META)
 int
 luaopen_ck_shared(lua_State *L)
 {
-	luaL_newmetatable(L, CK_HP_RECORD_METATABLE);
-	lua_pushvalue(L, -1);
-	lua_setfield(L, -2, "__index");
-	luaL_setfuncs(L, l_ck_hp_record_meta, 0);
-	register_hp_record(L, &serialized_hp_domain);
+	open_hp_domain(L, &serialized_hp_domain);
 
 	luaL_newmetatable(L, SHARED_CONST_METATABLE);
 	lua_pushvalue(L, -1);
@@ -1166,6 +1997,16 @@ luaopen_ck_shared(lua_State *L)
 	lua_setfield(L, -2, "__index");
 	luaL_setfuncs(L, l_ck_shared_pr_meta, 0);
 
+	luaL_newmetatable(L, SHARED_PR_ARRAY_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_shared_pr_array_meta, 0);
+
+	luaL_newmetatable(L, SHARED_PR_WIDE_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_shared_pr_wide_meta, 0);
+
 	luaL_newmetatable(L, SHARED_PR128_METATABLE);
 	luaL_setfuncs(L, l_ck_shared_pr_md128_meta, 0);
 
@@ -1184,6 +2025,14 @@ luaopen_ck_shared(lua_State *L)
 	luaL_newlib(L, l_ck_shared_mut_funcs);
 	lua_setfield(L, -2, "mut");
 	luaL_newlib(L, l_ck_shared_pr_funcs);
+	luaL_newlib(L, l_ck_shared_pr_array_funcs);
+	luaL_newlib(L, l_ck_shared_pr_array_funcs_meta);
+	lua_setmetatable(L, -2);
+	lua_setfield(L, -2, "array");
+	luaL_newlib(L, l_ck_shared_pr_wide_funcs);
+	luaL_newlib(L, l_ck_shared_pr_wide_funcs_meta);
+	lua_setmetatable(L, -2);
+	lua_setfield(L, -2, "wide");
 	luaL_newlib(L, l_ck_shared_pr_md128_funcs);
 	lua_setfield(L, -2, "md128");
 	lua_setfield(L, -2, "pr");
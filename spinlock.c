@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_spinlock.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "refcount.h"
+#include "luaerror.h"
+
+#define SPINLOCK_FAS_METATABLE "spinlock.fas"
+#define SPINLOCK_TICKET_METATABLE "spinlock.ticket"
+#define SPINLOCK_MCS_METATABLE "spinlock.mcs"
+#define SPINLOCK_CLH_METATABLE "spinlock.clh"
+
+struct rcspinlock_fas {
+	ck_spinlock_fas_t lock;
+	refcount refs CK_CC_CACHELINE;
+};
+
+static int
+l_ck_spinlock_fas_new(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_spinlock_fas_init(&lockp->lock);
+	refcount_init(&lockp->refs);
+	return (new(L, lockp, SPINLOCK_FAS_METATABLE));
+}
+
+static int
+l_ck_spinlock_fas_retain(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	return (new(L, lockp, SPINLOCK_FAS_METATABLE));
+}
+
+static int
+l_ck_spinlock_fas_gc(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	if (refcount_release(&lockp->refs)) {
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_spinlock_fas_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SPINLOCK_FAS_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_spinlock_fas_locked(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_fas_locked(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_spinlock_fas_lock(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	ck_spinlock_fas_lock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_spinlock_fas_lock_eb(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	ck_spinlock_fas_lock_eb(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_spinlock_fas_trylock(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_fas_trylock(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_spinlock_fas_unlock(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+
+	ck_spinlock_fas_unlock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_spinlock_fas_with(lua_State *L)
+{
+	struct rcspinlock_fas *lockp;
+	int status;
+
+	lockp = checkcookie(L, 1, SPINLOCK_FAS_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_spinlock_fas_lock(&lockp->lock);
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_spinlock_fas_unlock(&lockp->lock);
+	return (withresults(L, status, 1));
+}
+
+struct rcspinlock_ticket {
+	ck_spinlock_ticket_t lock;
+	refcount refs CK_CC_CACHELINE;
+};
+
+static int
+l_ck_spinlock_ticket_new(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_spinlock_ticket_init(&lockp->lock);
+	refcount_init(&lockp->refs);
+	return (new(L, lockp, SPINLOCK_TICKET_METATABLE));
+}
+
+static int
+l_ck_spinlock_ticket_retain(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	return (new(L, lockp, SPINLOCK_TICKET_METATABLE));
+}
+
+static int
+l_ck_spinlock_ticket_gc(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	if (refcount_release(&lockp->refs)) {
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_spinlock_ticket_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_spinlock_ticket_locked(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_ticket_locked(&lockp->lock));
+	return (1);
+}
+
+static int
+l_ck_spinlock_ticket_lock(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	ck_spinlock_ticket_lock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_spinlock_ticket_lock_pb(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+	unsigned int c;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+	c = luaL_checkinteger(L, 2);
+
+	ck_spinlock_ticket_lock_pb(&lockp->lock, c);
+	return (0);
+}
+
+#ifdef CK_F_SPINLOCK_TICKET_TRYLOCK
+static int
+l_ck_spinlock_ticket_trylock(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_ticket_trylock(&lockp->lock));
+	return (1);
+}
+#endif
+
+static int
+l_ck_spinlock_ticket_unlock(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+
+	ck_spinlock_ticket_unlock(&lockp->lock);
+	return (0);
+}
+
+static int
+l_ck_spinlock_ticket_with(lua_State *L)
+{
+	struct rcspinlock_ticket *lockp;
+	int status;
+
+	lockp = checkcookie(L, 1, SPINLOCK_TICKET_METATABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_spinlock_ticket_lock(&lockp->lock);
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_spinlock_ticket_unlock(&lockp->lock);
+	return (withresults(L, status, 1));
+}
+
+/*
+ * MCS and CLH locks are queue locks: each waiter spins on its own node rather
+ * than on the shared lock word.  A node is kept in every reference, so each
+ * thread (Lua state) holding a reference has a node to queue with.  A node must
+ * not be freed while it is queued, so a reference collected while holding the
+ * lock releases it first.
+ */
+struct rcspinlock_mcs {
+	ck_spinlock_mcs_t *queue;
+	refcount refs CK_CC_CACHELINE;
+};
+
+struct mcsref {
+	ck_spinlock_mcs_t node;
+	bool held;
+};
+
+static inline struct mcsref *
+checkmcsref(lua_State *L, int idx, struct rcspinlock_mcs **lockpp)
+{
+	*lockpp = checkcookie(L, idx, SPINLOCK_MCS_METATABLE);
+	return (lua_touserdata(L, idx));
+}
+
+static int
+l_ck_spinlock_mcs_new(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_spinlock_mcs_init(&lockp->queue);
+	refcount_init(&lockp->refs);
+	newext(L, lockp, SPINLOCK_MCS_METATABLE, sizeof(struct mcsref));
+	return (1);
+}
+
+static int
+l_ck_spinlock_mcs_retain(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	newext(L, lockp, SPINLOCK_MCS_METATABLE, sizeof(struct mcsref));
+	return (1);
+}
+
+static int
+l_ck_spinlock_mcs_gc(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+	struct mcsref *ref;
+
+	ref = checkmcsref(L, 1, &lockp);
+
+	if (ref->held) {
+		ck_spinlock_mcs_unlock(&lockp->queue, &ref->node);
+	}
+	if (refcount_release(&lockp->refs)) {
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_spinlock_mcs_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SPINLOCK_MCS_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_spinlock_mcs_locked(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_MCS_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_mcs_locked(&lockp->queue));
+	return (1);
+}
+
+static int
+l_ck_spinlock_mcs_lock(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+	struct mcsref *ref;
+
+	ref = checkmcsref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->held, 1, "already locked by this reference");
+
+	ck_spinlock_mcs_lock(&lockp->queue, &ref->node);
+	ref->held = true;
+	return (0);
+}
+
+static int
+l_ck_spinlock_mcs_trylock(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+	struct mcsref *ref;
+
+	ref = checkmcsref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->held, 1, "already locked by this reference");
+
+	ref->held = ck_spinlock_mcs_trylock(&lockp->queue, &ref->node);
+	lua_pushboolean(L, ref->held);
+	return (1);
+}
+
+static int
+l_ck_spinlock_mcs_unlock(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+	struct mcsref *ref;
+
+	ref = checkmcsref(L, 1, &lockp);
+	luaL_argcheck(L, ref->held, 1, "not locked by this reference");
+
+	ck_spinlock_mcs_unlock(&lockp->queue, &ref->node);
+	ref->held = false;
+	return (0);
+}
+
+static int
+l_ck_spinlock_mcs_with(lua_State *L)
+{
+	struct rcspinlock_mcs *lockp;
+	struct mcsref *ref;
+	int status;
+
+	ref = checkmcsref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->held, 1, "already locked by this reference");
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_spinlock_mcs_lock(&lockp->queue, &ref->node);
+	ref->held = true;
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_spinlock_mcs_unlock(&lockp->queue, &ref->node);
+	ref->held = false;
+	return (withresults(L, status, 1));
+}
+
+/*
+ * A CLH unlock hands the releasing thread its predecessor's node, so nodes
+ * migrate between references.  There is always one more node than there are
+ * references: the one at the tail of the queue, freed with the lock.
+ */
+struct rcspinlock_clh {
+	ck_spinlock_clh_t *queue;
+	refcount refs CK_CC_CACHELINE;
+};
+
+struct clhref {
+	ck_spinlock_clh_t *node;
+	bool held;
+};
+
+static inline struct clhref *
+checkclhref(lua_State *L, int idx, struct rcspinlock_clh **lockpp)
+{
+	*lockpp = checkcookie(L, idx, SPINLOCK_CLH_METATABLE);
+	return (lua_touserdata(L, idx));
+}
+
+static inline int
+newclhref(lua_State *L, struct rcspinlock_clh *lockp)
+{
+	struct clhref *ref;
+
+	ref = newext(L, lockp, SPINLOCK_CLH_METATABLE, sizeof(*ref));
+	if ((ref->node = malloc(sizeof(*ref->node))) == NULL) {
+		/* The reference is already counted; GC releases it. */
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	return (1);
+}
+
+static int
+l_ck_spinlock_clh_new(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+	ck_spinlock_clh_t *unowned;
+
+	if ((lockp = refcount_alloc(sizeof(*lockp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	if ((unowned = malloc(sizeof(*unowned))) == NULL) {
+		free(lockp);
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_spinlock_clh_init(&lockp->queue, unowned);
+	refcount_init(&lockp->refs);
+	return (newclhref(L, lockp));
+}
+
+static int
+l_ck_spinlock_clh_retain(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+
+	lockp = checklightuserdata(L, 1);
+
+	refcount_retain(&lockp->refs);
+	return (newclhref(L, lockp));
+}
+
+static int
+l_ck_spinlock_clh_gc(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+	struct clhref *ref;
+
+	ref = checkclhref(L, 1, &lockp);
+
+	if (ref->held) {
+		ck_spinlock_clh_unlock(&ref->node);
+	}
+	free(ref->node);
+	if (refcount_release(&lockp->refs)) {
+		free(lockp->queue);
+		free(lockp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_spinlock_clh_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, SPINLOCK_CLH_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_spinlock_clh_locked(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+
+	lockp = checkcookie(L, 1, SPINLOCK_CLH_METATABLE);
+
+	lua_pushboolean(L, ck_spinlock_clh_locked(&lockp->queue));
+	return (1);
+}
+
+static int
+l_ck_spinlock_clh_lock(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+	struct clhref *ref;
+
+	ref = checkclhref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->held, 1, "already locked by this reference");
+
+	ck_spinlock_clh_lock(&lockp->queue, ref->node);
+	ref->held = true;
+	return (0);
+}
+
+static int
+l_ck_spinlock_clh_unlock(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+	struct clhref *ref;
+
+	ref = checkclhref(L, 1, &lockp);
+	luaL_argcheck(L, ref->held, 1, "not locked by this reference");
+
+	ck_spinlock_clh_unlock(&ref->node);
+	ref->held = false;
+	return (0);
+}
+
+static int
+l_ck_spinlock_clh_with(lua_State *L)
+{
+	struct rcspinlock_clh *lockp;
+	struct clhref *ref;
+	int status;
+
+	ref = checkclhref(L, 1, &lockp);
+	luaL_argcheck(L, !ref->held, 1, "already locked by this reference");
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	ck_spinlock_clh_lock(&lockp->queue, ref->node);
+	ref->held = true;
+	status = lua_pcall(L, lua_gettop(L) - 2, LUA_MULTRET, 0);
+	ck_spinlock_clh_unlock(&ref->node);
+	ref->held = false;
+	return (withresults(L, status, 1));
+}
+
+static const struct luaL_Reg l_ck_spinlock_fas_funcs[] = {
+	{"new", l_ck_spinlock_fas_new},
+	{"retain", l_ck_spinlock_fas_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_fas_meta[] = {
+	{"__gc", l_ck_spinlock_fas_gc},
+	{"cookie", l_ck_spinlock_fas_cookie},
+	{"locked", l_ck_spinlock_fas_locked},
+	{"lock", l_ck_spinlock_fas_lock},
+	{"lock_eb", l_ck_spinlock_fas_lock_eb},
+	{"trylock", l_ck_spinlock_fas_trylock},
+	{"unlock", l_ck_spinlock_fas_unlock},
+	{"with", l_ck_spinlock_fas_with},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_ticket_funcs[] = {
+	{"new", l_ck_spinlock_ticket_new},
+	{"retain", l_ck_spinlock_ticket_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_ticket_meta[] = {
+	{"__gc", l_ck_spinlock_ticket_gc},
+	{"cookie", l_ck_spinlock_ticket_cookie},
+	{"locked", l_ck_spinlock_ticket_locked},
+	{"lock", l_ck_spinlock_ticket_lock},
+	{"lock_pb", l_ck_spinlock_ticket_lock_pb},
+#ifdef CK_F_SPINLOCK_TICKET_TRYLOCK
+	{"trylock", l_ck_spinlock_ticket_trylock},
+#endif
+	{"unlock", l_ck_spinlock_ticket_unlock},
+	{"with", l_ck_spinlock_ticket_with},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_mcs_funcs[] = {
+	{"new", l_ck_spinlock_mcs_new},
+	{"retain", l_ck_spinlock_mcs_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_mcs_meta[] = {
+	{"__gc", l_ck_spinlock_mcs_gc},
+	{"cookie", l_ck_spinlock_mcs_cookie},
+	{"locked", l_ck_spinlock_mcs_locked},
+	{"lock", l_ck_spinlock_mcs_lock},
+	{"trylock", l_ck_spinlock_mcs_trylock},
+	{"unlock", l_ck_spinlock_mcs_unlock},
+	{"with", l_ck_spinlock_mcs_with},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_clh_funcs[] = {
+	{"new", l_ck_spinlock_clh_new},
+	{"retain", l_ck_spinlock_clh_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_spinlock_clh_meta[] = {
+	{"__gc", l_ck_spinlock_clh_gc},
+	{"cookie", l_ck_spinlock_clh_cookie},
+	{"locked", l_ck_spinlock_clh_locked},
+	{"lock", l_ck_spinlock_clh_lock},
+	{"unlock", l_ck_spinlock_clh_unlock},
+	{"with", l_ck_spinlock_clh_with},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_spinlock(lua_State *L)
+{
+	luaL_newmetatable(L, SPINLOCK_FAS_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_spinlock_fas_meta, 0);
+
+	luaL_newmetatable(L, SPINLOCK_TICKET_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_spinlock_ticket_meta, 0);
+
+	luaL_newmetatable(L, SPINLOCK_MCS_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_spinlock_mcs_meta, 0);
+
+	luaL_newmetatable(L, SPINLOCK_CLH_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_spinlock_clh_meta, 0);
+
+	lua_newtable(L); /* ck.spinlock */
+	luaL_newlib(L, l_ck_spinlock_fas_funcs);
+	lua_setfield(L, -2, "fas");
+	luaL_newlib(L, l_ck_spinlock_ticket_funcs);
+	lua_setfield(L, -2, "ticket");
+	luaL_newlib(L, l_ck_spinlock_mcs_funcs);
+	lua_setfield(L, -2, "mcs");
+	luaL_newlib(L, l_ck_spinlock_clh_funcs);
+	lua_setfield(L, -2, "clh");
+
+	return (1);
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ck_hp.h>
+#include <ck_hp_stack.h>
+#include <ck_pr.h>
+#include <ck_stack.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "common.h"
+#include "hp.h"
+#include "refcount.h"
+#include "serde.h"
+#include "serdebuf.h"
+#include "luaerror.h"
+
+#define STACK_METATABLE "stack"
+
+/*
+ * Popping reads the next pointer of the entry at the head of the stack, so an
+ * entry popped by one thread may still be read by another.  Entries are
+ * retired to a hazard pointer domain rather than freed directly.  The value
+ * carried by an entry is owned by whichever thread pops it and is freed as
+ * soon as it has been loaded.
+ */
+static ck_hp_t stack_hp_domain;
+
+#ifndef HP_THRESHOLD
+#define HP_THRESHOLD 1 /* TODO: tuning */
+#endif
+
+struct stack_entry {
+	ck_stack_entry_t entry;
+	ck_hp_hazard_t hazard;
+	void *pointer;
+};
+
+CK_STACK_CONTAINER(struct stack_entry, entry, stack_entry_container)
+
+__attribute__((constructor(PRIO_HP)))
+static void
+init_stack_hp_domain(void)
+{
+	ck_hp_init(&stack_hp_domain, CK_HP_STACK_SLOTS_COUNT, HP_THRESHOLD,
+	    free);
+}
+
+struct rcstack {
+	ck_stack_t stack;
+	refcount refs CK_CC_CACHELINE;
+};
+
+static inline int
+newentry(lua_State *L, int idx, struct stack_entry **entryp)
+{
+	struct serdebuf sb;
+	struct stack_entry *entry;
+	serde_type_code type;
+	int error;
+
+	if ((error = serdebuf_init(L, idx, &sb)) != 0) {
+		return (error);
+	}
+	type = SERDE_ANY;
+	if ((error = serdebuf_serialize(L, idx, &sb, &type)) != 0) {
+		serdebuf_destroy(&sb);
+		return (error);
+	}
+	if ((entry = malloc(sizeof(*entry))) == NULL) {
+		serdebuf_destroy(&sb);
+		return (ENOMEM);
+	}
+	if ((entry->pointer = serdebuf_finalize(&sb, NULL)) == NULL) {
+		serdebuf_destroy(&sb);
+		free(entry);
+		return (ENOMEM);
+	}
+	*entryp = entry;
+	return (0);
+}
+
+static inline struct stack_entry *
+checkentry(lua_State *L, int idx)
+{
+	struct stack_entry *entry;
+	int error;
+
+	luaL_checkany(L, idx);
+
+	if ((error = newentry(L, idx, &entry)) != 0) {
+		if (error < 0) {
+			lua_error(L);
+		}
+		fatal(L, "newentry", error);
+	}
+	return (entry);
+}
+
+/*
+ * Load the value carried by a popped entry onto the stack and retire the entry.
+ * Returns false with an error on the stack if the value could not be loaded.
+ */
+static inline bool
+loadentry(lua_State *L, ck_hp_record_t *record, struct stack_entry *entry)
+{
+	bool ok;
+
+	ok = loadshared(L, entry->pointer) != NULL;
+	free(entry->pointer);
+	hp_free(record, &entry->hazard, entry, entry);
+	return (ok);
+}
+
+static int
+l_ck_stack_new(lua_State *L)
+{
+	struct rcstack *stackp;
+
+	if ((stackp = refcount_alloc(sizeof(*stackp))) == NULL) {
+		return (fatal(L, "malloc", ENOMEM));
+	}
+	ck_stack_init(&stackp->stack);
+	refcount_init(&stackp->refs);
+	return (new(L, stackp, STACK_METATABLE));
+}
+
+static int
+l_ck_stack_retain(lua_State *L)
+{
+	struct rcstack *stackp;
+
+	stackp = checklightuserdata(L, 1);
+
+	refcount_retain(&stackp->refs);
+	return (new(L, stackp, STACK_METATABLE));
+}
+
+static int
+l_ck_stack_gc(lua_State *L)
+{
+	struct rcstack *stackp;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+
+	if (refcount_release(&stackp->refs)) {
+		ck_stack_entry_t *garbage, *next;
+		struct stack_entry *entry;
+
+		/* Nobody else can be popping, so the entries can be freed. */
+		garbage = ck_stack_batch_pop_upmc(&stackp->stack);
+		while (garbage != NULL) {
+			next = CK_STACK_NEXT(garbage);
+			entry = stack_entry_container(garbage);
+			free(entry->pointer);
+			free(entry);
+			garbage = next;
+		}
+		free(stackp);
+	}
+	invalidate(L, 1);
+	return (0);
+}
+
+static int
+l_ck_stack_cookie(lua_State *L)
+{
+	checkcookieuv(L, 1, STACK_METATABLE);
+
+	return (1);
+}
+
+static int
+l_ck_stack_push(lua_State *L)
+{
+	struct rcstack *stackp;
+	struct stack_entry *entry;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+	entry = checkentry(L, 2);
+
+	ck_stack_push_upmc(&stackp->stack, &entry->entry);
+	return (0);
+}
+
+static int
+l_ck_stack_trypush(lua_State *L)
+{
+	struct rcstack *stackp;
+	struct stack_entry *entry;
+	bool pushed;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+	entry = checkentry(L, 2);
+
+	if (!(pushed = ck_stack_trypush_upmc(&stackp->stack, &entry->entry))) {
+		free(entry->pointer);
+		free(entry);
+	}
+	lua_pushboolean(L, pushed);
+	return (1);
+}
+
+static int
+l_ck_stack_pop(lua_State *L)
+{
+	struct rcstack *stackp;
+	ck_hp_record_t *record;
+	ck_stack_entry_t *entry;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+
+	record = gethprecord(L, &stack_hp_domain);
+	lua_pop(L, 1); /* the registry keeps the record alive */
+	if ((entry = ck_hp_stack_pop_mpmc(record, &stackp->stack)) == NULL) {
+		lua_pushboolean(L, false);
+		return (1);
+	}
+	lua_pushboolean(L, true);
+	return (loadentry(L, record, stack_entry_container(entry)) ? 2 :
+	    lua_error(L));
+}
+
+static int
+l_ck_stack_trypop(lua_State *L)
+{
+	struct rcstack *stackp;
+	ck_hp_record_t *record;
+	ck_stack_entry_t *entry;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+
+	record = gethprecord(L, &stack_hp_domain);
+	lua_pop(L, 1); /* the registry keeps the record alive */
+	if (!ck_hp_stack_trypop_mpmc(record, &stackp->stack, &entry)) {
+		lua_pushboolean(L, false);
+		return (1);
+	}
+	lua_pushboolean(L, true);
+	return (loadentry(L, record, stack_entry_container(entry)) ? 2 :
+	    lua_error(L));
+}
+
+static int
+l_ck_stack_pop_all(lua_State *L)
+{
+	struct rcstack *stackp;
+	ck_hp_record_t *record;
+	ck_stack_entry_t *garbage, *next;
+	struct stack_entry *entry;
+	lua_Integer i;
+	bool ok;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+
+	record = gethprecord(L, &stack_hp_domain);
+	lua_pop(L, 1); /* the registry keeps the record alive */
+	lua_newtable(L);
+	garbage = ck_stack_batch_pop_upmc(&stackp->stack);
+	for (ok = true, i = 1; garbage != NULL; garbage = next) {
+		next = CK_STACK_NEXT(garbage);
+		entry = stack_entry_container(garbage);
+		if (!ok) {
+			/* Keep the first error on top, but retire the rest. */
+			free(entry->pointer);
+			hp_free(record, &entry->hazard, entry, entry);
+		} else if ((ok = loadentry(L, record, entry))) {
+			lua_rawseti(L, -2, i++);
+		}
+	}
+	return (ok ? 1 : lua_error(L));
+}
+
+static int
+l_ck_stack_isempty(lua_State *L)
+{
+	struct rcstack *stackp;
+
+	stackp = checkcookie(L, 1, STACK_METATABLE);
+
+	lua_pushboolean(L, ck_pr_load_ptr(&stackp->stack.head) == NULL);
+	return (1);
+}
+
+static const struct luaL_Reg l_ck_stack_funcs[] = {
+	{"new", l_ck_stack_new},
+	{"retain", l_ck_stack_retain},
+	{NULL, NULL}
+};
+
+static const struct luaL_Reg l_ck_stack_meta[] = {
+	{"__gc", l_ck_stack_gc},
+	{"cookie", l_ck_stack_cookie},
+	{"push", l_ck_stack_push},
+	{"trypush", l_ck_stack_trypush},
+	{"pop", l_ck_stack_pop},
+	{"trypop", l_ck_stack_trypop},
+	{"pop_all", l_ck_stack_pop_all},
+	{"isempty", l_ck_stack_isempty},
+	{NULL, NULL}
+};
+
+int
+luaopen_ck_stack(lua_State *L)
+{
+	open_hp_domain(L, &stack_hp_domain);
+
+	luaL_newmetatable(L, STACK_METATABLE);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	luaL_setfuncs(L, l_ck_stack_meta, 0);
+
+	luaL_newlib(L, l_ck_stack_funcs); /* ck.stack */
+	return (1);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+
+#include "stats.h"
+
+#ifdef STATS
+_Static_assert((STATS_SHARDS & (STATS_SHARDS - 1)) == 0,
+    "STATS_SHARDS must be a power of 2");
+
+struct stats_totals stats_totals[STATS_SHARDS];
+__thread struct stats_totals *stats_local;
+static unsigned int stats_threads;
+
+/*
+ * Assign the calling thread the next shard of the totals, round robin.
+ */
+struct stats_totals *
+stats_assign(void)
+{
+	unsigned int thread;
+
+	thread = ck_pr_faa_uint(&stats_threads, 1);
+	return (&stats_totals[thread & (STATS_SHARDS - 1)]);
+}
+
+#define STATS_SUM_FIELD(NAME, sum, statsp) \
+	(sum)->NAME += ck_pr_load_64(&(statsp)->NAME);
+
+/* Fold the shards of the totals together. */
+static void
+sumtotals(struct stats_totals *sum)
+{
+	memset(sum, 0, sizeof(*sum));
+	for (unsigned int i = 0; i < STATS_SHARDS; i++) {
+		struct stats_totals *shard = &stats_totals[i];
+
+		EC_STATS_LIST(STATS_SUM_FIELD, &sum->ec, &shard->ec)
+		EC_SYSTEM_STATS_LIST(STATS_SUM_FIELD, &sum->ec_system,
+		    &shard->ec_system)
+		FIFO_STATS_LIST(STATS_SUM_FIELD, &sum->fifo, &shard->fifo)
+		HP_STATS_LIST(STATS_SUM_FIELD, &sum->hp, &shard->hp)
+		RING_STATS_LIST(STATS_SUM_FIELD, &sum->ring, &shard->ring)
+		SERDE_STATS_LIST(STATS_SUM_FIELD, &sum->serde, &shard->serde)
+		SHARED_STATS_LIST(STATS_SUM_FIELD, &sum->shared,
+		    &shard->shared)
+	}
+}
+
+#undef STATS_SUM_FIELD
+#endif
+
+/*
+ * Return the process-wide totals of every kind of counter, or nothing when the
+ * module is built without statistics.
+ */
+int
+l_ck_stats(lua_State *L)
+{
+#ifdef STATS
+	struct stats_totals totals;
+
+	sumtotals(&totals);
+	lua_createtable(L, 0, 6);
+	STATS_PUSH(EC_STATS_LIST, &totals.ec);
+	STATS_SET_FIELDS(EC_SYSTEM_STATS_LIST, &totals.ec_system);
+	lua_setfield(L, -2, "ec");
+	STATS_PUSH(FIFO_STATS_LIST, &totals.fifo);
+	lua_setfield(L, -2, "fifo");
+	STATS_PUSH(HP_STATS_LIST, &totals.hp);
+	lua_setfield(L, -2, "hp");
+	STATS_PUSH(RING_STATS_LIST, &totals.ring);
+	lua_setfield(L, -2, "ring");
+	STATS_PUSH(SERDE_STATS_LIST, &totals.serde);
+	lua_setfield(L, -2, "serde");
+	STATS_PUSH(SHARED_STATS_LIST, &totals.shared);
+	lua_setfield(L, -2, "shared");
+	return (1);
+#else
+	return (0);
+#endif
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 Ryan Moeller
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <ck_cc.h>
+#include <ck_pr.h>
+
+#include <lua.h>
+
+/*
+ * Operational statistics are compiled in with -DSTATS (make WITH_STATS=yes).
+ * Otherwise the counting macros expand to nothing, without evaluating their
+ * arguments, and no stats fields or totals exist.
+ *
+ * Objects count events in their own stats, and in the totals for their kind
+ * reported by ck.stats().  Counters are added to atomically and loaded one at a
+ * time, so a table of them is not a snapshot.
+ *
+ * The totals are counted by every thread, so like ck.counter they are split
+ * into shards, each on its own cache lines.  Every thread is assigned a shard
+ * the first time it counts anything, and ck.stats() folds the shards together.
+ */
+
+#define EC_STATS_LIST(X, ...) \
+	X(waits, __VA_ARGS__) \
+	X(timeouts, __VA_ARGS__)
+
+/* Counted by the system ops for every event count, including embedded ones. */
+#define EC_SYSTEM_STATS_LIST(X, ...) \
+	X(sleeps, __VA_ARGS__) \
+	X(wakes, __VA_ARGS__)
+
+#define FIFO_STATS_LIST(X, ...) \
+	X(enqueues, __VA_ARGS__) \
+	X(enqueue_failures, __VA_ARGS__) \
+	X(dequeues, __VA_ARGS__) \
+	X(dequeue_failures, __VA_ARGS__)
+
+#define HP_STATS_LIST(X, ...) \
+	X(frees, __VA_ARGS__) \
+	X(scans, __VA_ARGS__) \
+	X(reclaimed, __VA_ARGS__)
+
+#define RING_STATS_LIST(X, ...) \
+	X(enqueues, __VA_ARGS__) \
+	X(enqueue_failures, __VA_ARGS__) \
+	X(dequeues, __VA_ARGS__) \
+	X(dequeue_failures, __VA_ARGS__)
+
+#define SERDE_STATS_LIST(X, ...) \
+	X(serialized, __VA_ARGS__) \
+	X(bytes, __VA_ARGS__)
+
+#define SHARED_STATS_LIST(X, ...) \
+	X(loads, __VA_ARGS__) \
+	X(load_retries, __VA_ARGS__) \
+	X(stores, __VA_ARGS__)
+
+#ifdef STATS
+
+#define STATS_FIELD(NAME, ...) \
+	uint64_t NAME;
+
+struct ec_stats {
+	EC_STATS_LIST(STATS_FIELD)
+};
+
+struct ec_system_stats {
+	EC_SYSTEM_STATS_LIST(STATS_FIELD)
+};
+
+struct fifo_stats {
+	FIFO_STATS_LIST(STATS_FIELD)
+};
+
+struct hp_stats {
+	HP_STATS_LIST(STATS_FIELD)
+};
+
+struct ring_stats {
+	RING_STATS_LIST(STATS_FIELD)
+};
+
+struct serde_stats {
+	SERDE_STATS_LIST(STATS_FIELD)
+};
+
+struct shared_stats {
+	SHARED_STATS_LIST(STATS_FIELD)
+};
+
+#undef STATS_FIELD
+
+#ifndef STATS_SHARDS
+#define STATS_SHARDS 64 /* must be a power of 2 */
+#endif
+
+struct stats_totals {
+	struct ec_stats ec;
+	struct ec_system_stats ec_system;
+	struct fifo_stats fifo;
+	struct hp_stats hp;
+	struct ring_stats ring;
+	struct serde_stats serde;
+	struct shared_stats shared;
+} CK_CC_ALIGN(CK_MD_CACHELINE);
+
+extern struct stats_totals stats_totals[STATS_SHARDS];
+extern __thread struct stats_totals *stats_local; /* NULL until assigned */
+
+struct stats_totals *stats_assign(void);
+
+static inline struct stats_totals *
+stats_local_totals(void)
+{
+	struct stats_totals *totals;
+
+	if ((totals = stats_local) == NULL) {
+		totals = stats_local = stats_assign();
+	}
+	return (totals);
+}
+
+#define STATS_INIT(statsp) \
+	memset((statsp), 0, sizeof(*(statsp)))
+#define STATS_ADD(statsp, NAME, n) \
+	ck_pr_add_64(&(statsp)->NAME, (n))
+/* Add to the totals of a KIND of object, a field of struct stats_totals. */
+#define STATS_TOTAL_ADD(KIND, NAME, n) \
+	STATS_ADD(&stats_local_totals()->KIND, NAME, n)
+
+#define STATS_PUSH_FIELD(NAME, statsp) \
+	lua_pushinteger(L, (lua_Integer)ck_pr_load_64(&(statsp)->NAME)); \
+	lua_setfield(L, -2, #NAME);
+
+/* Set the counters as fields of the table on top of the stack. */
+#define STATS_SET_FIELDS(LIST, statsp) \
+	LIST(STATS_PUSH_FIELD, statsp)
+
+/* Push a new table of the counters, evaluating to the number of results. */
+#define STATS_PUSH(LIST, statsp) ({ \
+	lua_newtable(L); \
+	STATS_SET_FIELDS(LIST, statsp) \
+	1; \
+})
+
+#else
+
+#define STATS_INIT(statsp) ((void)0)
+#define STATS_ADD(statsp, NAME, n) ((void)0)
+#define STATS_TOTAL_ADD(KIND, NAME, n) ((void)0)
+#define STATS_PUSH(LIST, statsp) 0
+
+#endif
+
+#define STATS_INC(statsp, NAME) \
+	STATS_ADD(statsp, NAME, 1)
+#define STATS_TOTAL_INC(KIND, NAME) \
+	STATS_TOTAL_ADD(KIND, NAME, 1)
+
+int l_ck_stats(lua_State *);
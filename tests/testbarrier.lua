@@ -0,0 +1,42 @@
+local ck = require('ck')
+local pthread = require('pthread')
+
+-- Not a power of two, to exercise the partial trees and rounds.
+local nthreads = 5
+local nrounds = 50
+
+-- Every thread counts its arrival at each round, then checks after the first
+-- wait that all threads have arrived, and after the second that none has yet
+-- gone on to the next round.
+local function lockstep(kind, ...)
+	local barrier = ck.barrier[kind].new(nthreads, ...)
+	assert(barrier:threads() == nthreads)
+	local count = ck.shared.pr.new(0)
+	local threads = {}
+	for i = 1, nthreads do
+		threads[i] = pthread.create(function(kind, bcookie, ccookie)
+			local ck = require('ck')
+			local barrier = ck.barrier[kind].retain(bcookie)
+			local count = ck.shared.pr.retain(ccookie)
+			local state = barrier:subscribe()
+			for round = 1, nrounds do
+				count:inc()
+				state:wait()
+				assert(count:load() == round * nthreads)
+				state:wait()
+			end
+		end, kind, barrier:cookie(), count:cookie())
+	end
+	for i = 1, nthreads do
+		assert(threads[i]:join())
+	end
+	assert(count:load() == nrounds * nthreads)
+end
+
+lockstep('centralized')
+lockstep('combining')
+lockstep('combining', 2)
+lockstep('dissemination')
+lockstep('tournament')
+lockstep('mcs')
+print('ok')
@@ -0,0 +1,66 @@
+local ck = require('ck')
+
+-- An odd size leaves the last block partially used.
+local nbits = 100
+local bm = ck.bitmap.new(nbits)
+assert(bm:bits() == nbits)
+assert(bm:empty() and not bm:full() and bm:count() == 0)
+assert(not pcall(bm.set, bm, -1))
+assert(not pcall(bm.set, bm, nbits))
+
+bm:set(0)
+bm:set(31)
+bm:set(32)
+bm:set(nbits - 1)
+assert(bm:test(31) and bm:test(32) and not bm:test(33))
+assert(bm:count() == 4 and bm:count(32) == 2)
+assert(not bm:bts(5) and bm:bts(5))
+bm:reset(5)
+assert(not bm:test(5) and bm:count() == 4)
+
+local bits = {}
+for bit in bm:iterator() do
+	bits[#bits + 1] = bit
+end
+assert(#bits == 4)
+assert(bits[1] == 0 and bits[2] == 31 and bits[3] == 32 and bits[4] == 99)
+
+-- first_clear skips set bits across block boundaries and stops at the end.
+assert(bm:first_clear() == 1)
+assert(bm:first_clear(31) == 33)
+assert(bm:first_clear(nbits - 1) == nil)
+assert(bm:first_clear(nbits) == nil)
+assert(bm:first_clear(math.maxinteger) == nil)
+assert(not pcall(bm.first_clear, bm, -1))
+
+local full = ck.bitmap.new(nbits, true)
+assert(full:full() and full:first_clear() == nil)
+full:reset(64)
+assert(full:first_clear() == 64 and full:first_clear(65) == nil)
+
+-- Claim every bit from several threads at once, each exactly once.
+local nthreads = 4
+local claims = ck.bitmap.new(nbits)
+local pool = ck.pool.new(nthreads)
+local futures = {}
+for i = 1, nthreads do
+	futures[i] = pool:submit(function(cookie)
+		local ck = require('ck')
+		local claims = ck.bitmap.retain(cookie)
+		local n = 0
+		local bit = claims:first_clear()
+		while bit do
+			if not claims:bts(bit) then
+				n = n + 1
+			end
+			bit = claims:first_clear(bit)
+		end
+		return n
+	end, claims:cookie())
+end
+local claimed = 0
+for i = 1, nthreads do
+	claimed = claimed + futures[i]:get()
+end
+assert(claimed == nbits and claims:full())
+print('ok')
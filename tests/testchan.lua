@@ -0,0 +1,51 @@
+local ck = require('ck')
+
+local pool = ck.pool.new(2)
+
+-- Buffered channels don't block until full.
+local ch = ck.chan.new(2)
+assert(ch:capacity() == 2)
+assert(ch:send(1) and ch:send(2))
+assert(ch:send(3, 0) == nil)
+assert(ch:size() == 2)
+local ok, v = ch:recv()
+assert(ok and v == 1)
+
+-- Unbuffered channels rendezvous with another thread.
+local unbuf = ck.chan.new()
+assert(unbuf:recv(0, 1000) == nil)
+local sender = pool:submit(function(cookie)
+	local ck = require('ck')
+	local unbuf = ck.chan.retain(cookie)
+	for i = 1, 10 do
+		unbuf:send(i)
+	end
+	unbuf:close()
+end, unbuf:cookie())
+local sum = 0
+while true do
+	local ok, v = unbuf:recv()
+	if not ok then
+		break
+	end
+	sum = sum + v
+end
+sender:get()
+assert(sum == 55 and unbuf:isclosed())
+assert(not pcall(unbuf.send, unbuf, 1))
+
+-- Select waits on several channels, and closing one cancels the wait.
+local done = ck.chan.new()
+local i, ok, v = ck.select{{'recv', done}, {'recv', ch}}
+assert(i == 2 and ok and v == 2)
+local waiter = pool:submit(function(a, b)
+	local ck = require('ck')
+	return ck.select{{'recv', ck.chan.retain(a)}, {'recv', ck.chan.retain(b)}}
+end, ch:cookie(), done:cookie())
+done:close()
+local i, ok = waiter:get()
+assert(i == 2 and not ok)
+assert(ck.select({{'recv', ch}}, 0, 1000) == nil)
+i = ck.select{{'send', ch, 'x'}, {'recv', ck.chan.new()}}
+assert(i == 1)
+print('ok')
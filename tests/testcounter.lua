@@ -0,0 +1,36 @@
+local ck = require('ck')
+
+local nthreads = 8
+local counter = ck.counter.new()
+local nshards = counter:shards()
+assert(nshards >= 1 and nshards <= 1024 and nshards & (nshards - 1) == 0)
+assert(ck.counter.new(3):shards() == 4)
+assert(not pcall(ck.counter.new, 0))
+assert(not pcall(ck.counter.new, 1025))
+assert(counter:sum() == 0)
+
+local pool = ck.pool.new(nthreads)
+local futures = {}
+for i = 1, nthreads do
+	futures[i] = pool:submit(function(cookie, i)
+		local ck = require('ck')
+		local counter = ck.counter.retain(cookie)
+		for _ = 1, 1000 do
+			counter:inc()
+		end
+		counter:add(i)
+		counter:dec()
+	end, counter:cookie(), i)
+end
+for i = 1, nthreads do
+	futures[i]:get()
+end
+local expected = nthreads * 1000 + nthreads * (nthreads + 1) // 2 - nthreads
+assert(counter:sum() == expected)
+assert(ck.counter.retain(counter:cookie()):sum() == expected)
+
+counter:add(-5)
+assert(counter:reset() == expected - 5)
+assert(counter:sum() == 0)
+assert(counter:reset() == 0)
+print('ok')
@@ -0,0 +1,42 @@
+local ck = require('ck')
+
+local function check(q, n)
+	local h = q:latency()
+	assert(h.count == n)
+	assert(h.p50 <= h.p90 and h.p90 <= h.p99 and h.p99 <= h.p999)
+	assert(h.p999 <= h.max)
+	local count, lower = 0, -1
+	for _, bucket in ipairs(h.buckets) do
+		assert(bucket.lower > lower and bucket.lower <= bucket.upper)
+		count = count + bucket.count
+		lower = bucket.lower
+	end
+	assert(count == n)
+	return h
+end
+
+local ring = ck.ring.mpmc.new(16, true)
+assert(ring:latency().count == 0)
+for i = 1, 10 do
+	assert(ring:enqueue(tostring(i)))
+end
+for i = 1, 10 do
+	local ok, v = ring:dequeue()
+	assert(ok and v == tostring(i))
+end
+check(ring, 10)
+assert(ck.ring.mpmc.retain(ring:cookie()):latency().count == 10)
+assert(ck.ring.spsc.new(16):latency() == nil)
+
+local fifo = ck.fifo.mpmc.new(true)
+fifo:enqueue('slow')
+local t = os.clock()
+repeat until os.clock() - t > 0.01
+fifo:enqueue('fast')
+assert(select(2, fifo:dequeue()) == 'slow')
+assert(select(2, fifo:dequeue()) == 'fast')
+local h = check(fifo, 2)
+assert(h.max >= 10000000)
+assert(not fifo:trydequeue())
+assert(ck.fifo.spsc.new():latency() == nil)
+print('ok')
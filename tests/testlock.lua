@@ -0,0 +1,86 @@
+local ck = require('ck')
+local pthread = require('pthread')
+
+local nthreads = 4
+
+local function module(ck, path)
+	local m = ck
+	for name in path:gmatch('[^.]+') do
+		m = m[name]
+	end
+	return m
+end
+
+-- Count to 1000 in every thread under the lock, with a load and store that
+-- would lose updates if the lock did not exclude the other threads.
+local function hammer(path, with)
+	local lock = module(ck, path).new()
+	local count = ck.shared.pr.new(0)
+	local threads = {}
+	for i = 1, nthreads do
+		threads[i] = pthread.create(function(lcookie, ccookie)
+			local ck = require('ck')
+			local lock = module(ck, path).retain(lcookie)
+			local count = ck.shared.pr.retain(ccookie)
+			for _ = 1, 1000 do
+				lock[with](lock, function()
+					count:store(count:load() + 1)
+				end)
+			end
+		end, lock:cookie(), count:cookie())
+	end
+	for i = 1, nthreads do
+		assert(threads[i]:join())
+	end
+	assert(count:load() == nthreads * 1000)
+	return lock
+end
+
+local function oops()
+	error('oops')
+end
+
+for _, kind in ipairs({'fas', 'ticket', 'mcs', 'clh'}) do
+	local lock = hammer('spinlock.' .. kind, 'with')
+	local ok, err = pcall(lock.with, lock, oops)
+	assert(not ok and err:match('oops'))
+	assert(not lock:locked())
+	assert(select(2, lock:with(function(...) return ... end, 1, 2)) == 2)
+end
+
+for _, kind in ipairs({'rwlock', 'brlock'}) do
+	local lock = hammer(kind, 'with_write')
+	for _, with in ipairs({'with_read', 'with_write'}) do
+		local ok, err = pcall(lock[with], lock, oops)
+		assert(not ok and err:match('oops'))
+		assert(lock:write_trylock())
+		lock:write_unlock()
+	end
+end
+
+-- The brlock write lock belongs to the reference holding it, and is released
+-- when that reference is collected.
+local brlock = ck.brlock.new()
+local writer = ck.brlock.retain(brlock:cookie())
+writer:write_lock()
+assert(not pcall(writer.write_lock, writer))
+assert(not pcall(brlock.write_unlock, brlock))
+assert(not brlock:write_trylock())
+writer = nil
+collectgarbage()
+assert(brlock:write_trylock())
+brlock:write_unlock()
+
+-- References in a state share a reader, so references collected or retained
+-- while another holds the lock do not deadlock against it.
+for _, with in ipairs({'with_read', 'with_write'}) do
+	brlock[with](brlock, function()
+		ck.brlock.retain(brlock:cookie()):cookie()
+		collectgarbage()
+	end)
+end
+ck.brlock.retain(brlock:cookie()):read_lock()
+collectgarbage()
+assert(brlock:write_trylock())
+brlock:write_unlock()
+print('ok')
@@ -0,0 +1,52 @@
+local ck = require('ck')
+
+local bytes = {}
+for i = 1, 16 do
+	bytes[i] = i % 4 * 50
+end
+local md = ck.shared.pr.md128.new(bytes)
+local u8 = md.u8
+
+-- Bulk operations on all of the components at once.
+assert(u8:sum() == 4 * (0 + 50 + 100 + 150))
+assert(u8:min() == 0 and u8:max() == 150)
+assert(u8:mask(50) == 0x1111)
+assert(u8:mask(0) == 0x8888)
+assert(u8:find(100) == 2 and u8:find(100, 3) == 6 and u8:find(100, 15) == nil)
+assert(u8:find(7) == nil and u8:mask(7) == 0)
+assert(not pcall(u8.find, u8, 0, 0))
+assert(not pcall(u8.find, u8, 0, 18))
+assert(u8:find(0, 17) == nil)
+
+-- Values that cannot occur in the view match nothing rather than truncating.
+assert(u8:mask(256 + 50) == 0 and u8:find(256 + 50) == nil)
+assert(u8:mask(-206) == 0 and u8:find(-206) == nil)
+assert(not pcall(u8.mask, u8, 'x'))
+assert(not pcall(u8.find, u8, 1.5))
+
+local md32 = ck.shared.pr.md128.new({-1, 0, 1, 0})
+local i32, u32 = md32.i, md32.u32
+assert(i32:sum() == 0 and i32:min() == -1 and i32:max() == 1)
+assert(i32:find(-1) == 1 and i32:mask(0) == 0xa)
+assert(u32:find(-1) == nil and u32:find(0xffffffff) == 1)
+assert(i32:mask(0xffffffff) == 0 and i32:mask(1 << 32) == 0)
+
+local d = ck.shared.pr.md128.new({0.5, -2.25}).d
+assert(d:sum() == -1.75 and d:min() == -2.25 and d:max() == 0.5)
+assert(d:find(-2.25) == 2 and d:mask(0.5) == 1 and d:mask(1) == 0)
+
+local c = ck.shared.pr.md128.new(bytes).c
+assert(c:find('2') == 1 and c:find('d') == 2 and c:mask('2') == 0x1111)
+assert(c:find('22') == nil and c:mask('22') == 0)
+assert(c:mask('') == 0x8888)
+
+-- Loads fill and return a given table instead of allocating one.
+local t = {}
+assert(u8:load(t) == t)
+for i = 1, 16 do
+	assert(t[i] == bytes[i])
+end
+local t32 = {}
+assert(u32:load(t32) == t32 and t32[1] == 0xffffffff and t32[3] == 1)
+assert(#md.u64:load() == 2)
+print('ok')
@@ -0,0 +1,97 @@
+local ck = require('ck')
+
+local function range(n)
+	local t = {}
+	for i = 1, n do
+		t[i] = i
+	end
+	return t
+end
+
+local function square(x)
+	return x * x
+end
+
+local function add(a, b)
+	return a + b
+end
+
+local function check(n, options)
+	local squares = ck.parallel.map(square, range(n), options)
+	assert(#squares == n)
+	for i = 1, n do
+		assert(squares[i] == i * i)
+	end
+	assert(ck.parallel.reduce(add, range(n), options) == n * (n + 1) // 2)
+end
+
+-- Chunks that do not divide the input evenly.
+check(1000, {chunk = 7})
+check(10, {chunk = 3, threads = 2})
+check(1000, {chunk = 1000})
+check(1000, {chunk = 5000})
+
+-- Fewer values than tasks.
+check(1, {threads = 8})
+check(3, {threads = 8, chunk = 1})
+
+-- Empty input.
+assert(next(ck.parallel.map(square, {})) == nil)
+assert(ck.parallel.reduce(add, {}) == nil)
+assert(ck.parallel.reduce(add, {}, {initial = 42}) == 42)
+
+-- The initial value is applied once, not once per chunk.
+assert(ck.parallel.reduce(add, range(100), {chunk = 10, initial = 1000}) ==
+    1000 + 5050)
+
+-- The order of the values is kept for a function that is associative but not
+-- commutative.
+local words = {}
+for i = 1, 26 do
+	words[i] = string.char(96 + i)
+end
+assert(ck.parallel.reduce(function(a, b) return a .. b end, words,
+    {chunk = 4}) == 'abcdefghijklmnopqrstuvwxyz')
+
+-- An error in a worker is raised by the caller, and the pool is still usable.
+local ok, err = pcall(ck.parallel.map, function(x)
+	if x == 500 then
+		error('bad value')
+	end
+	return x
+end, range(1000), {chunk = 10})
+assert(not ok and err:match('bad value'))
+ok, err = pcall(ck.parallel.reduce, function(a, b)
+	error('bad fold')
+end, range(100))
+assert(not ok and err:match('bad fold'))
+check(100)
+
+-- Jobs can run on a given pool, including from a task in that pool.
+local pool = ck.pool.new(2)
+check(100, {pool = pool, chunk = 3})
+assert(pool:submit(function(cookie)
+	local ck = require('ck')
+	local pool = ck.pool.retain(cookie)
+	local input = {}
+	for i = 1, 100 do
+		input[i] = i
+	end
+	return ck.parallel.reduce(function(a, b) return a + b end, input,
+	    {pool = pool, chunk = 1})
+end, pool:cookie()):get() == 5050)
+
+-- A task in a pool runs jobs in that pool by default, rather than starting a
+-- pool of its own.
+assert(pool:submit(function()
+	local ck = require('ck')
+	local input = {}
+	for i = 1, 100 do
+		input[i] = i
+	end
+	local sum = ck.parallel.reduce(function(a, b) return a + b end, input,
+	    {chunk = 1})
+	assert(debug.getregistry()['ck.parallel.pool'] == nil)
+	return sum
+end):get() == 5050)
+print('ok')
@@ -0,0 +1,141 @@
+local ck = require('ck')
+
+local pool = ck.pool.new(4, function()
+	scale = 2
+end)
+assert(pool:threads() == 4)
+
+local futures = {}
+for i = 1, 100 do
+	futures[i] = assert(pool:submit(function(x) return x * scale, x end, i))
+end
+for i, future in ipairs(futures) do
+	local doubled, x = future:get()
+	assert(doubled == i * 2 and x == i)
+	assert(future:ready())
+end
+
+local f = pool:submit(function() error('oops') end)
+local ok, err = pcall(f.get, f)
+assert(not ok and err:match('oops'))
+
+-- Tasks can submit more tasks to the pool they are running in.
+local g = pool:submit(function(cookie)
+	local ck = require('ck')
+	local pool = ck.pool.retain(cookie)
+	return pool:submit(function() return 'nested' end):get()
+end, pool:cookie())
+assert(g:get() == 'nested')
+
+-- Futures can also be resolved explicitly, and chained.
+local p = ck.future.new()
+local chained = p:andthen(function(x) return x + 1 end)
+assert(p:get(0, 1000) == nil and not p:ready())
+pool:submit(function(cookie)
+	local ck = require('ck')
+	assert(ck.future.retain(cookie):set(41))
+end, p:cookie()):get()
+assert(p:get() == 41 and chained:get() == 42)
+assert(not p:set(0))
+assert(p:andthen(function(x) return x * 2 end):get() == 82)
+
+assert(not pcall(ck.pool.new, 1, function() error('init') end))
+
+-- Tables and functions captured as upvalues travel with the function.
+local config = {factor = 3}
+config.self = config
+local function scaled(x) return x * config.factor end
+local n = 0
+local function inc() n = n + 1 return n end
+local function get() return n end
+local r = pool:submit(function()
+	assert(config.self == config)
+	inc()
+	inc()
+	return scaled(get())
+end):get()
+assert(r == 6 and n == 0)
+
+-- Tables nest as deeply as SERDE_MAX_DEPTH allows, and no deeper.
+local function nest(depth)
+	local t = {}
+	for _ = 2, depth do
+		t = {t}
+	end
+	return t
+end
+local nested = nest(100)
+assert(pool:submit(function()
+	local n, t = 1, nested
+	while t[1] do
+		n, t = n + 1, t[1]
+	end
+	return n
+end):get() == 100)
+local deep = nest(300)
+assert(not pcall(pool.submit, pool, function() return deep end))
+
+-- A function with no upvalues but _ENV loads as the same cached closure each
+-- time in a worker.
+local one = ck.pool.new(1)
+local function stateless(x) return x * 2 end
+one:submit(function(f) first = f end, stateless):get()
+assert(one:submit(function(f) return f == first and f(21) end,
+    stateless):get() == 42)
+
+-- Functions sent repeatedly, with or without upvalues, refer to their interned
+-- bytecode, and bytecode too large to intern is carried inline instead.
+local k = 10
+local function stateful(x) return x + k end
+for i = 1, 10 do
+	assert(one:submit(stateless, i):get() == i * 2)
+	assert(one:submit(stateful, i):get() == i + 10)
+end
+local source = {'local x = ...'}
+for i = 2, 30000 do
+	source[i] = 'x = x + 1'
+end
+source[#source + 1] = 'return x'
+local large = assert(load(table.concat(source, '\n')))
+assert(#string.dump(large, true) > 65535)
+for _ = 1, 2 do
+	assert(one:submit(large, 1):get() == 30000)
+end
+assert(one:submit(function(f) return f(0) end, large):get() == 29999)
+
+-- A task blocked waiting on tasks it queued to its own worker relies on the
+-- other worker stealing them.
+local pair = ck.pool.new(2)
+local stolen = pair:submit(function(cookie)
+	local ck = require('ck')
+	local pool = ck.pool.retain(cookie)
+	local futures = {}
+	for i = 1, 10 do
+		futures[i] = pool:submit(function(x) return x end, i)
+	end
+	local sum = 0
+	for i = 1, 10 do
+		sum = sum + futures[i]:get()
+	end
+	return sum
+end, pair:cookie())
+assert(stolen:get() == 55)
+
+-- When the last reference is released by one of the pool's own workers, the
+-- workers are detached instead of joined.
+local ready, dropped = ck.ec.ec32.new(0), ck.ec.ec32.new(0)
+local last = pair:submit(function(pcookie, rcookie, dcookie)
+	local ck = require('ck')
+	local pool = ck.pool.retain(pcookie)
+	ck.ec.ec32.retain(rcookie):inc(ck.ec.mp)
+	ck.ec.ec32.retain(dcookie):wait(ck.ec.mp, 0)
+	pool = nil
+	collectgarbage()
+	return 'detached'
+end, pair:cookie(), ready:cookie(), dropped:cookie())
+ready:wait(ck.ec.mp, 0)
+pair = nil
+collectgarbage()
+dropped:inc(ck.ec.mp)
+assert(last:get() == 'detached')
+print('ok')
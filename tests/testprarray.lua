@@ -0,0 +1,49 @@
+local ck = require('ck')
+
+local nthreads = 8
+local counts = ck.shared.pr.array.new(nthreads, 'integer', {padded=true})
+assert(#counts == nthreads)
+assert(counts:load(1) == 0)
+assert(not pcall(counts.load, counts, 0))
+assert(not pcall(counts.load, counts, nthreads + 1))
+local flags = ck.shared.pr.array(4, 'u8', {padded=true})
+assert(#flags == 4 and flags:load(4) == 0)
+
+local pool = ck.pool.new(nthreads)
+local futures = {}
+for i = 1, nthreads do
+	futures[i] = pool:submit(function(cookie, i)
+		local ck = require('ck')
+		local counts = ck.shared.pr.array.retain(cookie)
+		for _ = 1, 1000 * i do
+			counts:inc(i)
+		end
+	end, counts:cookie(), i)
+end
+for i = 1, nthreads do
+	futures[i]:get()
+end
+local snapshot = counts:snapshot()
+for i = 1, nthreads do
+	assert(snapshot[i] == 1000 * i)
+end
+
+local flags = ck.shared.pr.array.new(3, 'boolean')
+assert(flags:cas(2, false, true))
+assert(not flags:cas(2, false, true))
+local t = flags:snapshot()
+assert(t[1] == false and t[2] == true and t[3] == false)
+
+local bytes = ck.shared.pr.array.new(64, 'u8')
+bytes:store(1, 255)
+assert(bytes:load(1) == 255)
+assert(not pcall(bytes.store, bytes, 1, 256))
+assert(not pcall(bytes.store, bytes, 1, -1))
+assert(bytes:load(1) == 255)
+
+local word = ck.shared.pr.new(7, 'u16')
+assert(word:faa(1) == 7)
+assert(word:load() == 8)
+assert(not pcall(ck.shared.pr.new, 65536, 'u16'))
+assert(not pcall(ck.shared.pr.new, 0, 'u128'))
+print('ok')
@@ -0,0 +1,62 @@
+local ck = require('ck')
+local pthread = require('pthread')
+
+-- Not a multiple of the word size, so the last word is partially used.
+local nbytes = 20
+local wide = ck.shared.pr.wide(nbytes)
+assert(#wide == nbytes)
+assert(wide:load() == string.rep('\0', nbytes))
+assert(#ck.shared.pr.wide.new('abc') == 3)
+
+local alphabet = 'abcdefghijklmnopqrst'
+wide:store(alphabet)
+assert(wide:load() == alphabet)
+
+-- Sub-ranges within a word, across words, and at either end.
+assert(wide:load(1, 1) == 'a')
+assert(wide:load(2, 7) == 'bcdefg')
+assert(wide:load(6, 12) == 'fghijkl')
+assert(wide:load(17) == 'qrst')
+assert(wide:load(20, 20) == 't')
+assert(wide:load(9, 8) == '')
+assert(not pcall(wide.load, wide, 0))
+assert(not pcall(wide.load, wide, 1, nbytes + 1))
+
+-- Stores at an offset merge with the bytes around them in partial words.
+wide:store('XY', 8)
+assert(wide:load() == 'abcdefgXYjklmnopqrst')
+wide:store('123456789', 3)
+assert(wide:load() == 'ab123456789lmnopqrst')
+wide:store('Z', nbytes)
+assert(wide:load() == 'ab123456789lmnopqrsZ')
+wide:store('', nbytes)
+assert(not pcall(wide.store, wide, 'ZZ', nbytes))
+assert(not pcall(wide.store, wide, 'Z', 0))
+
+-- Compare and swap replaces the whole value only if all of it matches.
+assert(not pcall(wide.cas, wide, 'short', alphabet))
+assert(not wide:cas(alphabet, string.rep('x', nbytes)))
+assert(wide:load() == 'ab123456789lmnopqrsZ')
+assert(wide:cas('ab123456789lmnopqrsZ', alphabet))
+assert(wide:load() == alphabet)
+
+-- Readers never see a value torn between writes.
+local writer = pthread.create(function(cookie, nbytes)
+	local ck = require('ck')
+	local wide = ck.shared.pr.wide.retain(cookie)
+	for i = 1, 10000 do
+		local old = wide:load()
+		local c = string.char(65 + i % 26)
+		if i % 2 == 0 then
+			wide:store(string.rep(c, nbytes))
+		else
+			assert(wide:cas(old, string.rep(c, nbytes)))
+		end
+	end
+end, wide:cookie(), nbytes)
+for _ = 1, 10000 do
+	local v = wide:load(2)
+	assert(v == alphabet:sub(2) or v == string.rep(v:sub(1, 1), nbytes - 1))
+end
+assert(writer:join())
+print('ok')
@@ -0,0 +1,51 @@
+local ck = require('ck')
+
+local rec = ck.sequence.record {
+	x = 'number',
+	y = 'number',
+	seq = 'integer',
+	valid = 'boolean',
+}
+local v = rec:read()
+assert(v.x == 0 and v.y == 0 and v.seq == 0 and v.valid == false)
+rec:write({x = 1.5, y = -2.5, seq = 1, valid = true})
+v = rec:read()
+assert(v.x == 1.5 and v.y == -2.5 and v.seq == 1 and v.valid == true)
+rec:write({seq = 2})
+rec:read(v)
+assert(v.x == 1.5 and v.seq == 2)
+assert(not pcall(rec.write, rec, {seq = 'three'}))
+assert(rec:read().seq == 2)
+
+local pthread = require('pthread')
+
+local function writer(cookie, n)
+	local ck = require('ck')
+
+	local rec = ck.sequence.record.retain(cookie)
+	for i = 1, n do
+		rec:write({x = i, y = -i, seq = i})
+	end
+end
+
+local function reader(cookie, n)
+	local ck = require('ck')
+
+	local rec = ck.sequence.record.retain(cookie)
+	local v = {}
+	for _ = 1, n do
+		rec:read(v)
+		assert(v.x == -v.y, "torn read")
+	end
+end
+
+local n = 100000
+local threads = {
+	pthread.create(writer, rec:cookie(), n),
+	pthread.create(reader, rec:cookie(), n),
+	pthread.create(reader, rec:cookie(), n),
+}
+for _, thread in ipairs(threads) do
+	assert(thread:join())
+end
+print(rec:read().seq)
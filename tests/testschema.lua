@@ -0,0 +1,29 @@
+local ck = require('ck')
+
+local Work = ck.serde.schema{id = 'I4', url = 's', path = 's', weight = 'd'}
+assert(ck.serde.schema{path = 's', weight = 'd', url = 's', id = 'I4'} == Work)
+
+local w = ck.shared.const.new(Work{id = 1, url = 'file:///a', path = '/b',
+    weight = 0.5}):load()
+assert(getmetatable(w) == Work)
+assert(w.id == 1 and w.url == 'file:///a' and w.path == '/b')
+assert(w.weight == 0.5)
+
+-- Records keep their schema through other threads.
+local pool = ck.pool.new(1)
+local r = pool:submit(function(w)
+	local ck = require('ck')
+	local Work = ck.serde.schema{id = 'I4', url = 's', path = 's',
+	    weight = 'd'}
+	assert(getmetatable(w) == Work)
+	w.id = w.id + 1
+	return w
+end, w):get()
+assert(getmetatable(r) == Work and r.id == 2)
+
+local Small = ck.serde.schema{n = 'b', s = 's1'}
+assert(not pcall(ck.shared.const.new, Small{n = 128, s = ''}))
+assert(not pcall(ck.shared.const.new, Small{n = 1, s = ('x'):rep(256)}))
+assert(not pcall(ck.shared.const.new, Small{n = 1}))
+assert(not pcall(ck.serde.schema, {x = 'z'}))
+print('ok')
@@ -0,0 +1,46 @@
+local ck = require('ck')
+
+local stack = ck.stack.new()
+assert(stack:isempty())
+assert(not stack:pop())
+stack:push(1)
+stack:push('two')
+stack:push(3.5)
+local ok, v = stack:pop()
+assert(ok and v == 3.5)
+local all = stack:pop_all()
+assert(#all == 2 and all[1] == 'two' and all[2] == 1)
+assert(stack:isempty())
+
+local pthread = require('pthread')
+
+local function worker(cookie, n)
+	local ck = require('ck')
+
+	local stack = ck.stack.retain(cookie)
+	local sum = 0
+	for i = 1, n do
+		stack:push(i)
+		local ok, v
+		repeat
+			ok, v = stack:pop()
+		until ok
+		sum = sum + v
+	end
+	return sum
+end
+
+local n, nthreads = 100000, 4
+local threads = {}
+for i = 1, nthreads do
+	threads[i] = pthread.create(worker, stack:cookie(), n)
+end
+local total = 0
+for _, thread in ipairs(threads) do
+	local ok, sum = thread:join()
+	assert(ok)
+	total = total + sum
+end
+assert(total == nthreads * n * (n + 1) // 2)
+assert(stack:isempty())
+print(total)
@@ -0,0 +1,53 @@
+-- Run against a module built WITH_ZSTD, where these values are large enough to
+-- be compressed.  Built without it, they are simply copied.
+local ck = require('ck')
+local pthread = require('pthread')
+
+-- Well over SERDE_COMPRESS_MIN, which defaults to a page.
+local compressible = string.rep('flua-ck ', 16384)
+
+-- Too random to shrink, so kept as is even when compression is enabled.
+local state = 1
+local bytes = {}
+for i = 1, 16384 do
+	state = (state * 1103515245 + 12345) % 2147483648
+	bytes[i] = string.char(state >> 16 & 0xff)
+end
+local incompressible = table.concat(bytes)
+
+local words = {}
+for i = 1, 4096 do
+	words[i] = 'word' .. i % 16
+end
+local function count(word)
+	local n = 0
+	for _, w in ipairs(words) do
+		if w == word then
+			n = n + 1
+		end
+	end
+	return n
+end
+
+for _, v in ipairs({compressible, incompressible}) do
+	assert(ck.shared.const.new(v):load() == v)
+end
+assert(ck.shared.const.new(count):load()('word3') == 256)
+
+-- Another state loads the values from a ring.
+local ring = ck.ring.mpmc.new(4)
+assert(ring:enqueue(compressible))
+assert(ring:enqueue(incompressible))
+assert(ring:enqueue(count))
+local thread = pthread.create(function(cookie, compressible, incompressible)
+	local ck = require('ck')
+	local ring = ck.ring.mpmc.retain(cookie)
+	local ok, v = ring:dequeue()
+	assert(ok and v == compressible)
+	ok, v = ring:dequeue()
+	assert(ok and v == incompressible)
+	ok, v = ring:dequeue()
+	assert(ok and v('word0') == 256)
+end, ring:cookie(), compressible, incompressible)
+assert(thread:join())
+print('ok')